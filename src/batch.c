@@ -0,0 +1,245 @@
+/*
+ * Copyright <2026> <Renan S Silva, aka h3nnn4n>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "batch.h"
+#include "cubie_cube.h"
+#include "puzzle.h"
+#include "serve.h"
+#include "solve.h"
+#include "thread_pool.h"
+#include "utils.h"
+
+// Lines are read and answered in chunks, so the output stays in input order without holding the whole file
+#define BATCH_CHUNK_SIZE 1024
+
+struct batch_s {
+    thread_pool_t   *pool;
+    solve_worker_t **workers;
+    int              n_workers;
+    int              n_interleaved;
+};
+
+typedef struct {
+    solve_worker_t     **workers;
+    int                  n_interleaved;
+    const coord_cube_t **cubes;
+    solve_list_t       **solves;
+    int                  n_cubes;
+    atomic_int          *next_cube;
+    const config_t      *config;
+} batch_task_t;
+
+batch_t *batch_create(int n_workers) { return batch_create_interleaved(n_workers, 1); }
+
+batch_t *batch_create_interleaved(int n_workers, int n_interleaved) {
+    batch_t *batch = (batch_t *)malloc(sizeof(batch_t));
+
+    batch->pool          = thread_pool_create(n_workers);
+    batch->workers       = (solve_worker_t **)malloc(sizeof(solve_worker_t *) * n_workers * n_interleaved);
+    batch->n_workers     = n_workers;
+    batch->n_interleaved = n_interleaved;
+
+    for (int i = 0; i < n_workers * n_interleaved; i++) {
+        batch->workers[i] = make_solve_worker();
+    }
+
+    return batch;
+}
+
+void batch_destroy(batch_t *batch) {
+    thread_pool_destroy(batch->pool);
+
+    for (int i = 0; i < batch->n_workers * batch->n_interleaved; i++) {
+        destroy_solve_worker(batch->workers[i]);
+    }
+
+    free(batch->workers);
+    free(batch);
+}
+
+// Starts the next cube on the worker, and returns its index, or -1 if there is none left
+static int start_next_batch_cube(batch_task_t *task, solve_worker_t *worker, solve_request_t *request) {
+    int i = atomic_fetch_add(task->next_cube, 1);
+
+    if (i >= task->n_cubes)
+        return -1;
+
+    init_solve_request(request, task->config);
+    start_solve_on_worker(worker, task->cubes[i], request);
+
+    return i;
+}
+
+// Takes turns between the solves of all the workers of the task one step at a time, and gives a worker the next
+// cube as soon as its solve is over
+static void batch_task_interleaved(batch_task_t *task) {
+    solve_request_t requests[task->n_interleaved];
+    int             cubes[task->n_interleaved];
+    int             n_running = 0;
+
+    for (int k = 0; k < task->n_interleaved; k++) {
+        cubes[k] = start_next_batch_cube(task, task->workers[k], &requests[k]);
+
+        if (cubes[k] >= 0)
+            n_running++;
+    }
+
+    while (n_running > 0) {
+        for (int k = 0; k < task->n_interleaved; k++) {
+            if (cubes[k] < 0 || step_solve_on_worker(task->workers[k]))
+                continue;
+
+            task->solves[cubes[k]] = finish_solve_on_worker(task->workers[k]);
+            cubes[k]               = start_next_batch_cube(task, task->workers[k], &requests[k]);
+
+            if (cubes[k] < 0)
+                n_running--;
+        }
+    }
+}
+
+static void batch_task(void *arg) {
+    batch_task_t *task = (batch_task_t *)arg;
+
+    if (task->n_interleaved > 1) {
+        batch_task_interleaved(task);
+        return;
+    }
+
+    for (int i = atomic_fetch_add(task->next_cube, 1); i < task->n_cubes; i = atomic_fetch_add(task->next_cube, 1)) {
+        solve_request_t request;
+        init_solve_request(&request, task->config);
+
+        task->solves[i] = solve_on_worker(task->workers[0], task->cubes[i], &request);
+    }
+}
+
+void batch_solve(batch_t *batch, const coord_cube_t **cubes, solve_list_t **solves, int n_cubes,
+                 const config_t *config) {
+    atomic_int   next_cube = 0;
+    batch_task_t tasks[batch->n_workers];
+    void        *args[batch->n_workers];
+
+    for (int i = 0; i < batch->n_workers; i++) {
+        tasks[i].workers       = &batch->workers[i * batch->n_interleaved];
+        tasks[i].n_interleaved = batch->n_interleaved;
+        tasks[i].cubes         = cubes;
+        tasks[i].solves        = solves;
+        tasks[i].n_cubes       = n_cubes;
+        tasks[i].next_cube     = &next_cube;
+        tasks[i].config        = config;
+        args[i]                = &tasks[i];
+    }
+
+    thread_pool_run(batch->pool, batch_task, args, batch->n_workers);
+}
+
+// Parses the facelets at the start of the line, or returns NULL if they are not a 3x3 cube that can be solved
+static coord_cube_t *parse_batch_cube(const puzzle_t *puzzle, char *line) {
+    line[strcspn(line, " \t\r\n")] = '\0';
+
+    // Leaves the puzzle in the parsed state, without going through the asserts of build_cubie_cube_from_str
+    if (!are_serve_facelets_valid(puzzle, line))
+        return NULL;
+
+    return make_coord_cube((cube_cubie_t *)puzzle->state);
+}
+
+int run_batch(const char *filename, FILE *out, int n_workers) {
+    FILE *in = fopen(filename, "r");
+
+    if (in == NULL) {
+        fprintf(stderr, "Error: could not open %s\n", filename);
+        return 1;
+    }
+
+    batch_t  *batch  = batch_create_interleaved(n_workers, get_config()->batch_interleave);
+    puzzle_t *puzzle = puzzle_create("3x3");
+
+    // Only the valid cubes are solved, the others keep a NULL cube and get an error answer
+    coord_cube_t *cubes[BATCH_CHUNK_SIZE];
+    coord_cube_t *valid_cubes[BATCH_CHUNK_SIZE];
+    solve_list_t *solves[BATCH_CHUNK_SIZE];
+
+    char    *line      = NULL;
+    size_t   line_size = 0;
+    int      n_solved  = 0;
+    int      eof       = 0;
+    uint64_t start     = get_microseconds();
+
+    while (!eof) {
+        int n_cubes = 0;
+        int n_valid = 0;
+
+        while (n_cubes < BATCH_CHUNK_SIZE) {
+            if (getline(&line, &line_size, in) == -1) {
+                eof = 1;
+                break;
+            }
+
+            char *facelets = line + strspn(line, " \t\r\n");
+            if (*facelets == '\0' || *facelets == '#')
+                continue;
+
+            cubes[n_cubes] = parse_batch_cube(puzzle, facelets);
+
+            if (cubes[n_cubes] != NULL)
+                valid_cubes[n_valid++] = cubes[n_cubes];
+
+            n_cubes++;
+        }
+
+        batch_solve(batch, (const coord_cube_t **)valid_cubes, solves, n_valid, get_config());
+
+        for (int i = 0, j = 0; i < n_cubes; i++) {
+            if (cubes[i] == NULL) {
+                fprintf(out, "error invalid facelets\n");
+                continue;
+            }
+
+            write_serve_answer(solves[j], out);
+            destroy_solve_list(solves[j]);
+            free(cubes[i]);
+            j++;
+        }
+
+        n_solved += n_valid;
+    }
+
+    fflush(out);
+
+    double elapsed = (get_microseconds() - start) / 1000000.0;
+    fprintf(stderr, "Solved %d cubes in %.3f seconds with %d workers: %.2f solves/s\n", n_solved, elapsed, n_workers,
+            elapsed > 0 ? n_solved / elapsed : 0.0);
+
+    free(line);
+    puzzle_destroy(puzzle);
+    batch_destroy(batch);
+    fclose(in);
+
+    return 0;
+}
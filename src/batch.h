@@ -0,0 +1,57 @@
+/*
+ * Copyright <2026> <Renan S Silva, aka h3nnn4n>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef _BATCH
+#define _BATCH
+
+#include <stdio.h>
+
+#include "config.h"
+#include "coord_cube.h"
+#include "solution.h"
+
+// Most cubes a batch thread searches at once
+#define MAX_BATCH_INTERLEAVE 64
+
+typedef struct batch_s batch_t;
+
+// Solves many cubes at once by giving each worker thread whole cubes to solve on its own, instead of splitting
+// every cube across all the threads like solve() does. There is no synchronization inside a solve, so it scales
+// better when there are many more cubes than threads.
+batch_t *batch_create(int n_workers);
+
+// Each thread searches n_interleaved cubes at once instead, taking turns between them one search node at a time.
+// The table entries a search needs next are prefetched before its turn ends, so they load while the thread
+// searches the other cubes, instead of the thread waiting on each cache miss.
+batch_t *batch_create_interleaved(int n_workers, int n_interleaved);
+void     batch_destroy(batch_t *batch);
+
+// Solves cubes[i] into solves[i] for every i in [0, n_cubes)
+void batch_solve(batch_t *batch, const coord_cube_t **cubes, solve_list_t **solves, int n_cubes,
+                 const config_t *config);
+
+// Solves the 3x3 facelets on each line of the file, writing one --serve answer per line in input order. Blank
+// lines and comments are skipped. Returns 0 on success.
+int run_batch(const char *filename, FILE *out, int n_workers);
+
+#endif /* end of include guard */
@@ -32,6 +32,7 @@
 #include <string.h>
 #include <time.h>
 
+#include "batch.h"
 #include "benchmark.h"
 #include "benchmark_stats.h"
 #include "config.h"
@@ -82,6 +83,10 @@ static void run_benchmark_internal(const char *base_type, int warmup_duration_ms
         type[sizeof(type) - 1] = '\0';
     }
 
+    // Results with a different phase1 pruning table are not comparable with the default ones
+    if (config->phase1_pruning == PHASE1_PRUNING_FLIPSLICE_TWIST)
+        strncat(type, "_sym", sizeof(type) - strlen(type) - 1);
+
     printf("=== Cubotron Benchmark ===\n");
     printf("Type: %s\n", type);
     printf("Warmup duration: %d ms\n", warmup_duration_ms);
@@ -415,6 +420,9 @@ void run_benchmark_2x2() {
         n_samples++;
     }
 
+    // Fast solves can hit max_samples before the 5s are up
+    uint64_t bench_duration = get_microseconds() - bench_start;
+
     puzzle_destroy(puzzle);
 
     printf("  Completed %d benchmark solves\n\n", n_samples);
@@ -445,8 +453,127 @@ void run_benchmark_2x2() {
 
     printf("  Solve time (ms): avg=%.3f  std=%.3f  min=%.3f  max=%.3f\n", avg_t, std_t, min_t, max_t);
     printf("  Solution length: avg=%.1f  min=%d  max=%d\n", avg_l, min_l, max_l);
-    printf("  Solves per second: %.0f\n", n_samples / 5.0);
+    printf("  Solves per second: %.0f\n", n_samples / (bench_duration / 1000000.0));
 
     free(times);
     free(lengths);
 }
+
+#define N_BATCH_BENCH_CUBES 256
+
+static double solves_per_second(int n_solves, uint64_t start, uint64_t end) {
+    return n_solves / ((end - start) / 1000000.0);
+}
+
+void run_benchmark_batch() {
+    const config_t *config = get_config();
+
+    printf("=== Batch Benchmark ===\n\n");
+
+    uint64_t seeds[2];
+    entropy_getbytes((void *)seeds, sizeof(seeds));
+    pcg32_srandom(seeds[0], seeds[1]);
+
+    const coord_cube_t *cubes[N_BATCH_BENCH_CUBES];
+    solve_list_t       *solves[N_BATCH_BENCH_CUBES];
+
+    for (int i = 0; i < N_BATCH_BENCH_CUBES; i++) {
+        coord_cube_t *cube = get_coord_cube();
+        apply_random_scramble(cube, pcg32_boundedrand(n_scramble_moves / 2) + n_scramble_moves / 2);
+        cubes[i] = cube;
+    }
+
+    // Touches the tables first, so neither run pays for faulting them in
+    for (int i = 0; i < N_BATCH_BENCH_CUBES / 8; i++) {
+        destroy_solve_list(solve(cubes[i], config));
+    }
+
+    // Every cube split across all the threads, one cube at a time
+    uint64_t in_cube_start = get_microseconds();
+
+    for (int i = 0; i < N_BATCH_BENCH_CUBES; i++) {
+        solves[i] = solve(cubes[i], config);
+        destroy_solve_list(solves[i]);
+    }
+
+    uint64_t in_cube_end = get_microseconds();
+
+    // One cube per thread at a time
+    batch_t *batch       = batch_create(config->thread_count);
+    uint64_t batch_start = get_microseconds();
+
+    batch_solve(batch, cubes, solves, N_BATCH_BENCH_CUBES, config);
+
+    uint64_t batch_end = get_microseconds();
+    batch_destroy(batch);
+
+    for (int i = 0; i < N_BATCH_BENCH_CUBES; i++) {
+        destroy_solve_list(solves[i]);
+        free((coord_cube_t *)cubes[i]);
+    }
+
+    double in_cube_rate = solves_per_second(N_BATCH_BENCH_CUBES, in_cube_start, in_cube_end);
+    double batch_rate   = solves_per_second(N_BATCH_BENCH_CUBES, batch_start, batch_end);
+
+    printf("  Cubes: %d  Threads: %d\n", N_BATCH_BENCH_CUBES, config->thread_count);
+    printf("  Parallel within each cube (solves/s): %.2f\n", in_cube_rate);
+    printf("  Parallel across cubes     (solves/s): %.2f\n", batch_rate);
+    printf("  Speedup: %.2fx\n", batch_rate / in_cube_rate);
+}
+
+// Largest --batch-interleave the benchmark tries, doubling from 1
+#define MAX_INTERLEAVE_BENCH 32
+
+void run_benchmark_interleave() {
+    const config_t *config = get_config();
+
+    printf("=== Interleave Benchmark ===\n\n");
+
+    uint64_t seeds[2];
+    entropy_getbytes((void *)seeds, sizeof(seeds));
+    pcg32_srandom(seeds[0], seeds[1]);
+
+    const coord_cube_t *cubes[N_BATCH_BENCH_CUBES];
+    solve_list_t       *solves[N_BATCH_BENCH_CUBES];
+
+    for (int i = 0; i < N_BATCH_BENCH_CUBES; i++) {
+        coord_cube_t *cube = get_coord_cube();
+        apply_random_scramble(cube, pcg32_boundedrand(n_scramble_moves / 2) + n_scramble_moves / 2);
+        cubes[i] = cube;
+    }
+
+    // Touches the tables first, so the first run does not pay for faulting them in
+    for (int i = 0; i < N_BATCH_BENCH_CUBES / 8; i++) {
+        destroy_solve_list(solve(cubes[i], config));
+    }
+
+    printf("  Cubes: %d  Threads: 1\n", N_BATCH_BENCH_CUBES);
+
+    double single_rate = 0;
+
+    // A single thread, so the rate is per core
+    for (int n_interleaved = 1; n_interleaved <= MAX_INTERLEAVE_BENCH; n_interleaved *= 2) {
+        batch_t *batch = batch_create_interleaved(1, n_interleaved);
+        uint64_t start = get_microseconds();
+
+        batch_solve(batch, cubes, solves, N_BATCH_BENCH_CUBES, config);
+
+        uint64_t end = get_microseconds();
+        batch_destroy(batch);
+
+        for (int i = 0; i < N_BATCH_BENCH_CUBES; i++) {
+            destroy_solve_list(solves[i]);
+        }
+
+        double rate = solves_per_second(N_BATCH_BENCH_CUBES, start, end);
+
+        if (n_interleaved == 1)
+            single_rate = rate;
+
+        printf("  %2d cubes at a time (solves/s per core): %8.2f  %.2fx\n", n_interleaved, rate, rate / single_rate);
+    }
+
+    for (int i = 0; i < N_BATCH_BENCH_CUBES; i++) {
+        free((coord_cube_t *)cubes[i]);
+    }
+}
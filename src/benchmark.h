@@ -29,6 +29,8 @@
 void run_benchmark_fast();
 void run_benchmark_slow();
 void run_benchmark_2x2();
+void run_benchmark_batch();
+void run_benchmark_interleave();
 
 void print_benchmark_results(const benchmark_result_t *result);
 void print_benchmark_comparison(const benchmark_result_t *current, const benchmark_result_t *previous);
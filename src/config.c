@@ -22,29 +22,54 @@
  */
 
 #include <stddef.h>
+#include <unistd.h>
 
 #include "config.h"
 
 static config_t config = {0};
 
+static int get_default_thread_count() {
+    long n_cores = sysconf(_SC_NPROCESSORS_ONLN);
+
+    if (n_cores < 1)
+        return 1;
+
+    return n_cores < MAX_THREAD_COUNT ? (int)n_cores : MAX_THREAD_COUNT;
+}
+
 void init_config() {
-    config.do_benchmark_fast = 0;
-    config.do_benchmark_slow = 0;
-    config.do_benchmark_2x2  = 0;
-    config.do_solve          = 0;
-    config.rebuild_tables    = 0;
-    config.max_depth         = 25;
-    config.n_solutions       = 1;
-    config.timeout           = 1;
-    config.scramble_moves    = NULL;
-
-    config.thread_count    = N_MOVES;
-    config.die             = false;
-    config.solutions_found = 0;
+    config.do_benchmark_fast       = 0;
+    config.do_benchmark_slow       = 0;
+    config.do_benchmark_2x2        = 0;
+    config.do_benchmark_batch      = 0;
+    config.do_benchmark_interleave = 0;
+    config.do_solve                = 0;
+    config.do_serve                = 0;
+    config.rebuild_tables          = 0;
+    config.mmap_tables             = 1;
+    config.verify_tables           = 0;
+    config.max_depth               = 25;
+    config.n_solutions             = 1;
+    config.target_length           = 0;
+    config.six_way                 = 0;
+    config.phase1_pruning          = PHASE1_PRUNING_PROJECTIONS;
+    config.simd                    = 1;
+    config.prefetch                = 1;
+    config.cache_line_move_tables  = 0;
+    config.timeout                 = 0;
+    config.scramble_moves          = NULL;
+
+    config.thread_count      = get_default_thread_count();
+    config.phase2_threads    = 0;
+    config.phase2_batch_size = 0;
+    config.phase2_cache      = 0;
+    config.batch_interleave  = 1;
 
     config.puzzle_type        = "3x3";
+    config.cache_file         = "cache/tables.bundle";
     config.compare_against    = NULL;
     config.compare_benchmarks = NULL;
+    config.batch_file         = NULL;
 
     for (int i = 0; i < N_MOVES; i++) {
         config.move_black_list[i] = MOVE_NULL;
@@ -24,21 +24,48 @@
 #ifndef __CONFIG_H
 #define __CONFIG_H
 
-#include <stdatomic.h>
-#include <stdbool.h>
 #include <stdint.h>
 
 #include "puzzle_types.h"
 
+// Upper bound for the default and --threads solver thread count
+#define MAX_THREAD_COUNT 256
+
+typedef enum {
+    // max of the corner/slice, edge/slice and corner/edge projection tables
+    PHASE1_PRUNING_PROJECTIONS = 0,
+    // full flipslice x twist table, reduced by the 16 symmetries that keep the UD axis
+    PHASE1_PRUNING_FLIPSLICE_TWIST = 1,
+} phase1_pruning_t;
+
 typedef struct {
     int do_benchmark_fast;
     int do_benchmark_slow;
     int do_benchmark_2x2;
+    int do_benchmark_batch;
+    int do_benchmark_interleave;
     int do_solve;
+    int do_serve;
     int rebuild_tables;
+    int mmap_tables;
+    int verify_tables;
     int max_depth;
     int n_solutions;
+    int target_length;
+    int six_way;
+
+    phase1_pruning_t phase1_pruning;
+
+    // Whether the phase1 search expands its nodes with AVX2 when the CPU has it
+    int simd;
+
+    // Whether the searches prefetch the table entries of the nodes they are about to visit
+    int prefetch;
 
+    // Whether every row of the 18 move tables is padded to a cache line of its own
+    int cache_line_move_tables;
+
+    // In seconds, 0 disables it. With a single solution wanted, the solve keeps improving it until then.
     float timeout;
 
     // we only have 18 moves, so the black list cant evet be greater than 18 in length
@@ -47,14 +74,26 @@ typedef struct {
 
     move_t *scramble_moves;
 
-    uint32_t   thread_count;
-    bool       die;
-    atomic_int solutions_found;
+    uint32_t thread_count;
+
+    // How many of the solver threads only run phase2, 0 runs it on the phase1 threads
+    int phase2_threads;
+
+    // How many phase1 solutions go through phase2 together, 0 or 1 runs phase2 on each one as soon as it is found
+    int phase2_batch_size;
+
+    // Whether each solve remembers the phase2 result of the G1 states it already searched
+    int phase2_cache;
+
+    // How many cubes each --batch thread searches at once, taking turns between them to hide the table latency
+    int batch_interleave;
 
     char *puzzle_type;
+    char *cache_file;
 
     char *compare_against;
     char *compare_benchmarks;
+    char *batch_file;
 } config_t;
 
 void      init_config();
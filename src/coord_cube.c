@@ -59,10 +59,24 @@ coord_cube_t *make_coord_cube(cube_cubie_t *cubie) {
     return coord_cube;
 }
 
+void coord_to_cubie_cube(const coord_cube_t *cube, cube_cubie_t *cubie) {
+    // The setters check the whole cube, so the orientations have to be valid before they are set
+    for (int i = 0; i < N_CORNERS; i++)
+        cubie->corner_orientations[i] = 0;
+
+    for (int i = 0; i < N_EDGES; i++)
+        cubie->edge_orientations[i] = 0;
+
+    coord_get_edge_permutations(cube, cubie->edge_permutations);
+    set_corner_permutations(cubie, cube->corner_permutations);
+    set_edge_orientations(cubie, cube->edge_orientations);
+    set_corner_orientations(cubie, cube->corner_orientations);
+}
+
 void copy_coord_cube(coord_cube_t *dest, const coord_cube_t *source) {
     assert(dest != NULL);
     assert(source != NULL);
-    memcpy_(dest, source, sizeof(coord_cube_t));
+    *dest = *source;
 }
 
 int are_all_coord_equal(const coord_cube_t *cube1, const coord_cube_t *cube2) {
@@ -116,7 +130,7 @@ int is_phase2_solved(const coord_cube_t *cube) {
 
 int is_coord_solved(const coord_cube_t *cube) { return is_phase1_solved(cube) && is_phase2_solved(cube); }
 
-int is_move_sequence_a_solution_for_cube(const coord_cube_t *cube, const move_t *moves) {
+int is_move_sequence_a_solution_for_cube(const coord_cube_t *cube, const uint8_t *moves) {
     coord_cube_t *temp_cube = get_coord_cube();
     copy_coord_cube(temp_cube, cube);
 
@@ -24,29 +24,34 @@
 #ifndef _COORD_CUBE
 #define _COORD_CUBE
 
+#include <stdint.h>
+
 #include "cubie_cube.h"
 
+// Every coord is stored in the narrowest type it fits in, so the search stacks and the phase2 batches take 20
+// bytes per cube instead of 32. Only the UD6 and UD7 coords need 32 bits, and only outside of G1.
 typedef struct {
-    int edge_orientations;
-    int corner_orientations;
-    int E_slice;
-    int E_sorted_slice;
-    int parity;
-    int UD6_edge_permutations;
-    int UD7_edge_permutations;
-    int corner_permutations;
+    uint32_t UD6_edge_permutations;
+    uint32_t UD7_edge_permutations;
+    uint16_t edge_orientations;
+    uint16_t corner_orientations;
+    uint16_t E_slice;
+    uint16_t E_sorted_slice;
+    uint16_t corner_permutations;
+    uint8_t  parity;
 } coord_cube_t;
 
 coord_cube_t *get_coord_cube();
 void          reset_coord_cube(coord_cube_t *cube);
 coord_cube_t *make_coord_cube(cube_cubie_t *);
+void          coord_to_cubie_cube(const coord_cube_t *cube, cube_cubie_t *cubie);
 void          copy_coord_cube(coord_cube_t *dest, const coord_cube_t *source);
 int           are_all_coord_equal(const coord_cube_t *cube1, const coord_cube_t *cube2);
 int           are_phase1_coord_equal(const coord_cube_t *cube1, const coord_cube_t *cube2);
 int           is_phase1_solved(const coord_cube_t *cube);
 int           is_phase2_solved(const coord_cube_t *cube);
 int           is_coord_solved(const coord_cube_t *cube);
-int           is_move_sequence_a_solution_for_cube(const coord_cube_t *cube, const move_t *moves);
+int           is_move_sequence_a_solution_for_cube(const coord_cube_t *cube, const uint8_t *moves);
 void          scramble_cube(coord_cube_t *cube, int n_moves);
 
 #endif /* end of include guard */
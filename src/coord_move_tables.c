@@ -23,7 +23,10 @@
 
 #include <assert.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
+#include "config.h"
 #include "coord_cube.h"
 #include "coord_move_tables.h"
 #include "cubie_cube.h"
@@ -31,24 +34,92 @@
 #include "definitions.h"
 #include "pruning_cache.h"
 
-static int *move_table_edge_orientations          = NULL;
-static int *move_table_corner_orientations        = NULL;
-static int *move_table_E_slice                    = NULL;
-static int *move_table_E_sorted_slice             = NULL;
+#define CACHE_LINE_SIZE 64
+
+// Every coord but the phase1 UD6 and UD7 ones fits in 16 bits, so their tables take half the memory of int ones.
+// A row holds the coords after each of the 18 moves, followed by padding up to move_table_stride entries.
+static uint16_t *move_table_edge_orientations   = NULL;
+static uint16_t *move_table_corner_orientations = NULL;
+static uint16_t *move_table_E_slice             = NULL;
+static uint16_t *move_table_E_sorted_slice      = NULL;
+static uint16_t *move_table_corner_permutations = NULL;
+static int       move_table_stride              = N_MOVES;
+
 static int *move_table_UD6_edge_permutations      = NULL;
 static int *move_table_UD7_edge_permutations      = NULL;
-static int *move_table_corner_permutations        = NULL;
-static int  move_table_parity[N_PARITY * N_MOVES] = {1, 0, 1, 1, 0, 1, 1, 0, 1, 1, 0, 1, 1, 0, 1, 1, 0, 1,
-                                                     0, 1, 0, 0, 1, 0, 0, 1, 0, 0, 1, 0, 0, 1, 0, 0, 1, 0};
-
-int *get_move_table_edge_orientations() { return move_table_edge_orientations; }
-int *get_move_table_corner_orientations() { return move_table_corner_orientations; }
-int *get_move_table_E_slice() { return move_table_E_slice; }
-int *get_move_table_E_sorted_slice() { return move_table_E_sorted_slice; }
-int *get_move_table_UD6_edge_permutations() { return move_table_UD6_edge_permutations; }
-int *get_move_table_UD7_edge_permutations() { return move_table_UD7_edge_permutations; }
-int *get_move_table_corner_permutations() { return move_table_corner_permutations; }
-int *get_move_table_parity() { return move_table_parity; }
+
+// Quarter turns swap the corner and edge permutation parity, half turns keep it. The parity table is built from
+// these with the same row stride as the other 18 move tables.
+static const uint16_t move_parity_flips[N_MOVES]                              = {1, 0, 1, 1, 0, 1, 1, 0, 1,
+                                                                                  1, 0, 1, 1, 0, 1, 1, 0, 1};
+static uint16_t       move_table_parity[N_PARITY * MOVE_TABLE_CACHE_LINE_STRIDE] = {0};
+
+// Phase2 only tables. They are indexed by the phase2 coords, which are much smaller than the phase1 ones once
+// the cube is in G1, and by the index of the move in phase2_moves.
+static const move_t phase2_moves[N_PHASE2_MOVES] = {MOVE_U1, MOVE_U2, MOVE_U3, MOVE_D1, MOVE_D2,
+                                                    MOVE_D3, MOVE_R2, MOVE_L2, MOVE_F2, MOVE_B2};
+
+static uint16_t *move_table_phase2_E_sorted_slice                    = NULL;
+static uint16_t *move_table_phase2_UD6_edge_permutations             = NULL;
+static uint16_t *move_table_phase2_UD7_edge_permutations             = NULL;
+static uint16_t *move_table_phase2_corner_permutations               = NULL;
+static uint16_t  move_table_phase2_parity[N_PARITY * N_PHASE2_MOVES] = {0};
+static int       move_edge_permutations[N_MOVES * N_EDGES]           = {0};
+static int       move_edge_permutations_built                        = 0;
+
+int       get_move_table_stride() { return move_table_stride; }
+uint16_t *get_move_table_edge_orientations() { return move_table_edge_orientations; }
+uint16_t *get_move_table_corner_orientations() { return move_table_corner_orientations; }
+uint16_t *get_move_table_E_slice() { return move_table_E_slice; }
+uint16_t *get_move_table_E_sorted_slice() { return move_table_E_sorted_slice; }
+uint16_t *get_move_table_corner_permutations() { return move_table_corner_permutations; }
+int      *get_move_table_UD6_edge_permutations() { return move_table_UD6_edge_permutations; }
+int      *get_move_table_UD7_edge_permutations() { return move_table_UD7_edge_permutations; }
+uint16_t *get_move_table_parity() { return move_table_parity; }
+
+const move_t *get_phase2_moves() { return phase2_moves; }
+uint16_t     *get_move_table_phase2_E_sorted_slice() { return move_table_phase2_E_sorted_slice; }
+uint16_t     *get_move_table_phase2_UD6_edge_permutations() { return move_table_phase2_UD6_edge_permutations; }
+uint16_t     *get_move_table_phase2_UD7_edge_permutations() { return move_table_phase2_UD7_edge_permutations; }
+uint16_t     *get_move_table_phase2_corner_permutations() { return move_table_phase2_corner_permutations; }
+
+// Applies only the edge permutation part of a move, which is all the UD6/UD7 coords depend on
+static void apply_move_to_edges(edge_t *edges, move_t move) {
+    edge_t     next[N_EDGES];
+    const int *move_edges = &move_edge_permutations[move * N_EDGES];
+
+    for (int i = 0; i < N_EDGES; i++)
+        next[i] = edges[move_edges[i]];
+
+    memcpy(edges, next, sizeof(next));
+}
+
+// Without the full UD6/UD7 move tables the coords are updated through the cubie representation. This is a lot
+// slower than a table lookup, but is only used outside of the search, where phase1 only tracks phase1 coords and
+// phase2 uses the phase2 tables. They start from a copy of the solved cube on the stack, since set_UD6_edges and
+// set_UD7_edges assert the whole cube is valid.
+static const cube_cubie_t solved_cubie_cube = {
+    .corner_permutations = {URF, UFL, ULB, UBR, DFR, DLF, DBL, DRB},
+    .edge_permutations   = {UR, UF, UL, UB, DR, DF, DL, DB, FR, FL, BL, BR},
+};
+
+static int apply_move_to_UD6_edges(int UD6_edge_permutations, move_t move) {
+    cube_cubie_t cube = solved_cubie_cube;
+
+    set_UD6_edges(&cube, UD6_edge_permutations);
+    apply_move_to_edges(cube.edge_permutations, move);
+
+    return get_UD6_edges(&cube);
+}
+
+static int apply_move_to_UD7_edges(int UD7_edge_permutations, move_t move) {
+    cube_cubie_t cube = solved_cubie_cube;
+
+    set_UD7_edges(&cube, UD7_edge_permutations);
+    apply_move_to_edges(cube.edge_permutations, move);
+
+    return get_UD7_edges(&cube);
+}
 
 void coord_apply_move_phase1(coord_cube_t *cube, move_t move) {
     assert(cube != NULL);
@@ -58,13 +129,13 @@ void coord_apply_move_phase1(coord_cube_t *cube, move_t move) {
     assert(move_table_corner_orientations != NULL);
     assert(move_table_E_slice != NULL);
 
-    assert(cube->edge_orientations * N_MOVES + move < N_EDGE_ORIENTATIONS * N_MOVES);
-    assert(cube->corner_orientations * N_MOVES + move < N_CORNER_ORIENTATIONS * N_MOVES);
-    assert(cube->E_slice * N_MOVES + move < N_SLICES * N_MOVES);
+    assert(cube->edge_orientations < N_EDGE_ORIENTATIONS);
+    assert(cube->corner_orientations < N_CORNER_ORIENTATIONS);
+    assert(cube->E_slice < N_SLICES);
 
-    cube->edge_orientations   = move_table_edge_orientations[cube->edge_orientations * N_MOVES + move];
-    cube->corner_orientations = move_table_corner_orientations[cube->corner_orientations * N_MOVES + move];
-    cube->E_slice             = move_table_E_slice[cube->E_slice * N_MOVES + move];
+    cube->edge_orientations   = move_table_edge_orientations[cube->edge_orientations * move_table_stride + move];
+    cube->corner_orientations = move_table_corner_orientations[cube->corner_orientations * move_table_stride + move];
+    cube->E_slice             = move_table_E_slice[cube->E_slice * move_table_stride + move];
 
     assert(cube->edge_orientations >= 0);
     assert(cube->corner_orientations >= 0);
@@ -82,30 +153,39 @@ void coord_apply_move(coord_cube_t *cube, move_t move) {
     assert(move_table_corner_orientations != NULL);
     assert(move_table_E_slice != NULL);
     assert(move_table_E_sorted_slice != NULL);
-    assert(move_table_UD6_edge_permutations != NULL);
-    assert(move_table_UD7_edge_permutations != NULL);
     assert(move_table_corner_permutations != NULL);
+    assert(move_edge_permutations_built);
 
-    assert(cube->edge_orientations * N_MOVES + move < N_EDGE_ORIENTATIONS * N_MOVES);
-    assert(cube->corner_orientations * N_MOVES + move < N_CORNER_ORIENTATIONS * N_MOVES);
-    assert(cube->E_slice * N_MOVES + move < N_SLICES * N_MOVES);
-    assert(cube->E_sorted_slice * N_MOVES + move < N_SORTED_SLICES * N_MOVES);
-    assert(cube->UD6_edge_permutations * N_MOVES + move < N_UD6_PHASE1_PERMUTATIONS * N_MOVES);
-    assert(cube->UD7_edge_permutations * N_MOVES + move < N_UD7_PHASE1_PERMUTATIONS * N_MOVES);
-    assert(cube->corner_permutations * N_MOVES + move < N_CORNER_PERMUTATIONS * N_MOVES);
-    assert(cube->parity * N_MOVES + move < N_PARITY * N_MOVES);
+    assert(cube->edge_orientations < N_EDGE_ORIENTATIONS);
+    assert(cube->corner_orientations < N_CORNER_ORIENTATIONS);
+    assert(cube->E_slice < N_SLICES);
+    assert(cube->E_sorted_slice < N_SORTED_SLICES);
+    assert(cube->UD6_edge_permutations < N_UD6_PHASE1_PERMUTATIONS);
+    assert(cube->UD7_edge_permutations < N_UD7_PHASE1_PERMUTATIONS);
+    assert(cube->corner_permutations < N_CORNER_PERMUTATIONS);
+    assert(cube->parity < N_PARITY);
 
     // Phase 1
-    cube->edge_orientations   = move_table_edge_orientations[cube->edge_orientations * N_MOVES + move];
-    cube->corner_orientations = move_table_corner_orientations[cube->corner_orientations * N_MOVES + move];
-    cube->E_slice             = move_table_E_slice[cube->E_slice * N_MOVES + move];
+    cube->edge_orientations   = move_table_edge_orientations[cube->edge_orientations * move_table_stride + move];
+    cube->corner_orientations = move_table_corner_orientations[cube->corner_orientations * move_table_stride + move];
+    cube->E_slice             = move_table_E_slice[cube->E_slice * move_table_stride + move];
 
     // Phase 2
-    cube->E_sorted_slice        = move_table_E_sorted_slice[cube->E_sorted_slice * N_MOVES + move];
-    cube->parity                = move_table_parity[cube->parity * N_MOVES + move];
-    cube->UD6_edge_permutations = move_table_UD6_edge_permutations[cube->UD6_edge_permutations * N_MOVES + move];
-    cube->UD7_edge_permutations = move_table_UD7_edge_permutations[cube->UD7_edge_permutations * N_MOVES + move];
-    cube->corner_permutations   = move_table_corner_permutations[cube->corner_permutations * N_MOVES + move];
+    cube->E_sorted_slice        = move_table_E_sorted_slice[cube->E_sorted_slice * move_table_stride + move];
+    cube->parity                = move_table_parity[cube->parity * move_table_stride + move];
+    cube->corner_permutations   = move_table_corner_permutations[cube->corner_permutations * move_table_stride + move];
+
+    if (move_table_UD6_edge_permutations != NULL) {
+        cube->UD6_edge_permutations = move_table_UD6_edge_permutations[cube->UD6_edge_permutations * N_MOVES + move];
+    } else {
+        cube->UD6_edge_permutations = apply_move_to_UD6_edges(cube->UD6_edge_permutations, move);
+    }
+
+    if (move_table_UD7_edge_permutations != NULL) {
+        cube->UD7_edge_permutations = move_table_UD7_edge_permutations[cube->UD7_edge_permutations * N_MOVES + move];
+    } else {
+        cube->UD7_edge_permutations = apply_move_to_UD7_edges(cube->UD7_edge_permutations, move);
+    }
 
     // Post conditions
     assert(cube->edge_orientations >= 0);
@@ -113,8 +193,6 @@ void coord_apply_move(coord_cube_t *cube, move_t move) {
     assert(cube->E_slice >= 0);
     assert(cube->E_sorted_slice >= 0);
     assert(cube->parity >= 0);
-    assert(cube->UD6_edge_permutations >= 0);
-    assert(cube->UD7_edge_permutations >= 0);
     assert(cube->corner_permutations >= 0);
 
     assert(cube->edge_orientations < N_EDGE_ORIENTATIONS);
@@ -133,100 +211,230 @@ void coord_apply_moves(coord_cube_t *cube, const move_t *moves, int n_moves) {
     }
 }
 
-void coord_build_move_tables() {
-    cube_cubie_t *cube = NULL;
+void coord_apply_move_phase2(coord_cube_t *cube, int phase2_move) { coord_get_phase2_child(cube, cube, phase2_move); }
 
-    // Edge orientation move tables
-    if (move_table_edge_orientations == NULL) {
-        move_table_edge_orientations = (int *)malloc(sizeof(int) * N_EDGE_ORIENTATIONS * N_MOVES);
+void coord_get_phase2_child(coord_cube_t *child, const coord_cube_t *cube, int phase2_move) {
+    assert(cube != NULL);
+    assert(child != NULL);
+    assert(phase2_move >= 0);
+    assert(phase2_move < N_PHASE2_MOVES);
+    assert(is_phase1_solved(cube));
+    assert(cube->E_sorted_slice < N_SORTED_SLICES_PHASE2);
+    assert(cube->UD6_edge_permutations < N_UD6_PHASE2_PERMUTATIONS);
+    assert(cube->UD7_edge_permutations < N_UD7_PHASE2_PERMUTATIONS);
+
+    const int index = phase2_move;
+
+    child->E_sorted_slice = move_table_phase2_E_sorted_slice[cube->E_sorted_slice * N_PHASE2_MOVES + index];
+    child->parity         = move_table_phase2_parity[cube->parity * N_PHASE2_MOVES + index];
+    child->UD6_edge_permutations =
+        move_table_phase2_UD6_edge_permutations[cube->UD6_edge_permutations * N_PHASE2_MOVES + index];
+    child->UD7_edge_permutations =
+        move_table_phase2_UD7_edge_permutations[cube->UD7_edge_permutations * N_PHASE2_MOVES + index];
+    child->corner_permutations =
+        move_table_phase2_corner_permutations[cube->corner_permutations * N_PHASE2_MOVES + index];
+}
 
-        cube = init_cubie_cube();
+void prefetch_phase2_move_rows(const coord_cube_t *cube) {
+    __builtin_prefetch(&move_table_phase2_E_sorted_slice[cube->E_sorted_slice * N_PHASE2_MOVES]);
+    __builtin_prefetch(&move_table_phase2_UD6_edge_permutations[cube->UD6_edge_permutations * N_PHASE2_MOVES]);
+    __builtin_prefetch(&move_table_phase2_UD7_edge_permutations[cube->UD7_edge_permutations * N_PHASE2_MOVES]);
+    __builtin_prefetch(&move_table_phase2_corner_permutations[cube->corner_permutations * N_PHASE2_MOVES]);
+}
 
-        for (int edge_orientations = 0; edge_orientations < N_EDGE_ORIENTATIONS; edge_orientations++) {
-            for (int move = 0; move < N_MOVES; move++) {
-                set_edge_orientations(cube, edge_orientations);
-                cubie_apply_move(cube, move);
-                move_table_edge_orientations[edge_orientations * N_MOVES + move] = get_edge_orientations(cube);
-            }
+void coord_get_edge_permutations(const coord_cube_t *cube, edge_t edges[N_EDGES]) {
+    cube_cubie_t *slice_cube = init_cubie_cube();
+    cube_cubie_t *UD7_cube   = init_cubie_cube();
+
+    set_E_sorted_slice(slice_cube, cube->E_sorted_slice);
+    set_UD7_edges(UD7_cube, cube->UD7_edge_permutations);
+
+    // The sorted slice places FR, FL, BL and BR, the UD7 coord places UR to DL, and DB goes where is left
+    for (int i = 0; i < N_EDGES; i++) {
+        if (slice_cube->edge_permutations[i] >= FR) {
+            edges[i] = slice_cube->edge_permutations[i];
+        } else if (UD7_cube->edge_permutations[i] <= DL) {
+            edges[i] = UD7_cube->edge_permutations[i];
+        } else {
+            edges[i] = DB;
         }
+    }
+
+    free(slice_cube);
+    free(UD7_cube);
+}
 
-        free(cube);
+void coord_set_phase2_coords(coord_cube_t *cube, const coord_cube_t *start, const edge_t start_edges[N_EDGES],
+                             const move_t *moves, int n_moves) {
+    assert(move_edge_permutations_built);
+
+    cube_cubie_t edge_cube;
+    int          corner_permutations = start->corner_permutations;
+    int          parity              = start->parity;
+
+    memcpy(edge_cube.edge_permutations, start_edges, sizeof(edge_t) * N_EDGES);
+
+    for (int i = 0; i < n_moves; i++) {
+        apply_move_to_edges(edge_cube.edge_permutations, moves[i]);
+        corner_permutations = move_table_corner_permutations[corner_permutations * move_table_stride + moves[i]];
+        parity              = move_table_parity[parity * move_table_stride + moves[i]];
     }
 
-    // Corner orientation move tables
-    if (move_table_corner_orientations == NULL) {
-        move_table_corner_orientations = (int *)malloc(sizeof(int) * N_CORNER_ORIENTATIONS * N_MOVES);
+    cube->E_sorted_slice        = get_E_sorted_slice(&edge_cube);
+    cube->UD6_edge_permutations = get_UD6_edges(&edge_cube);
+    cube->UD7_edge_permutations = get_UD7_edges(&edge_cube);
+    cube->corner_permutations   = corner_permutations;
+    cube->parity                = parity;
+}
 
-        cube = init_cubie_cube();
+// Aligned to a cache line, so that with the cache line stride every row of a table sits in exactly one line
+static uint16_t *alloc_move_table(int n_entries) {
+    size_t    size  = (sizeof(uint16_t) * n_entries + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE * CACHE_LINE_SIZE;
+    uint16_t *table = (uint16_t *)aligned_alloc(CACHE_LINE_SIZE, size);
 
-        for (int corner_orientations = 0; corner_orientations < N_CORNER_ORIENTATIONS; corner_orientations++) {
-            for (int move = 0; move < N_MOVES; move++) {
-                set_corner_orientations(cube, corner_orientations);
-                cubie_apply_move(cube, move);
-                move_table_corner_orientations[corner_orientations * N_MOVES + move] = get_corner_orientations(cube);
-            }
-        }
+    // The padding of the rows is cached too, so it has to be the same every time
+    memset(table, 0, size);
+
+    return table;
+}
+
+// The move table of a coord that fits in 16 bits, for all 18 moves. It is cached along with its stride, so a table
+// cached with the other layout is rebuilt instead of misread.
+static uint16_t *build_coord_move_table(const char *name, int n_coords, void (*set_coord)(cube_cubie_t *, int),
+                                        int (*get_coord)(cube_cubie_t *)) {
+    uint16_t      *table  = NULL;
+    cache_layout_t layout = {
+        .element_bits = 16,
+        .dims         = {n_coords, move_table_stride, 0},
+        .move_set     = CACHE_MOVE_SET_ALL,
+    };
+
+    if (pruning_table_cache_load("move_tables", name, &layout, (void **)&table))
+        return table;
 
-        free(cube);
+    table = alloc_move_table(n_coords * move_table_stride);
+
+    cube_cubie_t *cube = init_cubie_cube();
+
+    for (int coord = 0; coord < n_coords; coord++) {
+        for (int move = 0; move < N_MOVES; move++) {
+            set_coord(cube, coord);
+            cubie_apply_move(cube, move);
+            table[coord * move_table_stride + move] = get_coord(cube);
+        }
     }
 
-    // E slice move table
-    if (move_table_E_slice == NULL) {
-        move_table_E_slice = (int *)malloc(sizeof(int) * N_SLICES * N_MOVES);
+    free(cube);
+
+    pruning_table_cache_store("move_tables", name, &layout, table);
+
+    return table;
+}
+
+static void build_phase2_move_tables() {
+    if (move_table_phase2_UD7_edge_permutations != NULL)
+        return;
+
+    move_table_phase2_E_sorted_slice        = alloc_move_table(N_SORTED_SLICES_PHASE2 * N_PHASE2_MOVES);
+    move_table_phase2_UD6_edge_permutations = alloc_move_table(N_UD6_PHASE2_PERMUTATIONS * N_PHASE2_MOVES);
+    move_table_phase2_UD7_edge_permutations = alloc_move_table(N_UD7_PHASE2_PERMUTATIONS * N_PHASE2_MOVES);
+    move_table_phase2_corner_permutations   = alloc_move_table(N_CORNER_PERMUTATIONS * N_PHASE2_MOVES);
 
-        cube = init_cubie_cube();
+    cube_cubie_t *cube = init_cubie_cube();
 
-        for (int slice = 0; slice < N_SLICES; slice++) {
-            for (int move = 0; move < N_MOVES; move++) {
-                set_E_slice(cube, slice);
-                cubie_apply_move(cube, move);
-                move_table_E_slice[slice * N_MOVES + move] = get_E_slice(cube);
-            }
+    // Phase2 moves keep the cube in G1, so every coord stays below its phase2 bound
+    for (int move = 0; move < N_PHASE2_MOVES; move++) {
+        for (int slice = 0; slice < N_SORTED_SLICES_PHASE2; slice++) {
+            set_E_sorted_slice(cube, slice);
+            apply_move_to_edges(cube->edge_permutations, phase2_moves[move]);
+            move_table_phase2_E_sorted_slice[slice * N_PHASE2_MOVES + move] = get_E_sorted_slice(cube);
+            assert(move_table_phase2_E_sorted_slice[slice * N_PHASE2_MOVES + move] < N_SORTED_SLICES_PHASE2);
         }
 
-        free(cube);
+        for (int permutations = 0; permutations < N_UD6_PHASE2_PERMUTATIONS; permutations++) {
+            set_UD6_edges(cube, permutations);
+            apply_move_to_edges(cube->edge_permutations, phase2_moves[move]);
+            move_table_phase2_UD6_edge_permutations[permutations * N_PHASE2_MOVES + move] = get_UD6_edges(cube);
+            assert(move_table_phase2_UD6_edge_permutations[permutations * N_PHASE2_MOVES + move] <
+                   N_UD6_PHASE2_PERMUTATIONS);
+        }
+
+        for (int permutations = 0; permutations < N_UD7_PHASE2_PERMUTATIONS; permutations++) {
+            set_UD7_edges(cube, permutations);
+            apply_move_to_edges(cube->edge_permutations, phase2_moves[move]);
+            move_table_phase2_UD7_edge_permutations[permutations * N_PHASE2_MOVES + move] = get_UD7_edges(cube);
+            assert(move_table_phase2_UD7_edge_permutations[permutations * N_PHASE2_MOVES + move] <
+                   N_UD7_PHASE2_PERMUTATIONS);
+        }
+
+        for (int permutations = 0; permutations < N_CORNER_PERMUTATIONS; permutations++) {
+            move_table_phase2_corner_permutations[permutations * N_PHASE2_MOVES + move] =
+                move_table_corner_permutations[permutations * move_table_stride + phase2_moves[move]];
+        }
+
+        for (int parity = 0; parity < N_PARITY; parity++) {
+            move_table_phase2_parity[parity * N_PHASE2_MOVES + move] =
+                move_table_parity[parity * move_table_stride + phase2_moves[move]];
+        }
     }
 
-    // E sorted slice move table
-    if (move_table_E_sorted_slice == NULL) {
-        move_table_E_sorted_slice = (int *)malloc(sizeof(int) * N_SORTED_SLICES * N_MOVES);
+    free(cube);
+}
+
+void coord_build_move_tables() {
+    cube_cubie_t *cube = NULL;
 
-        cube = init_cubie_cube();
+    // The stride is picked by the first build, the tables are never built again
+    if (move_table_edge_orientations == NULL) {
+        move_table_stride = get_config()->cache_line_move_tables ? MOVE_TABLE_CACHE_LINE_STRIDE : N_MOVES;
 
-        for (int slice = 0; slice < N_SORTED_SLICES; slice++) {
-            for (int move = 0; move < N_MOVES; move++) {
-                set_E_sorted_slice(cube, slice);
-                cubie_apply_move(cube, move);
-                assert(slice * N_MOVES + move < N_SORTED_SLICES * N_MOVES);
-                move_table_E_sorted_slice[slice * N_MOVES + move] = get_E_sorted_slice(cube);
-            }
+        for (int parity = 0; parity < N_PARITY; parity++) {
+            for (int move = 0; move < N_MOVES; move++)
+                move_table_parity[parity * move_table_stride + move] = parity ^ move_parity_flips[move];
         }
+    }
 
-        free(cube);
+    if (move_table_edge_orientations == NULL) {
+        move_table_edge_orientations = build_coord_move_table("edge_orientations", N_EDGE_ORIENTATIONS,
+                                                              set_edge_orientations, get_edge_orientations);
     }
 
-    // UD6 edge permutations move table
-    build_UD6_edge_permutations_move_table();
+    if (move_table_corner_orientations == NULL) {
+        move_table_corner_orientations = build_coord_move_table("corner_orientations", N_CORNER_ORIENTATIONS,
+                                                                set_corner_orientations, get_corner_orientations);
+    }
 
-    // UD7 edge permutations move table
-    build_UD7_edge_permutations_move_table();
+    if (move_table_E_slice == NULL)
+        move_table_E_slice = build_coord_move_table("E_slice", N_SLICES, set_E_slice, get_E_slice);
 
-    // Corner permutations move table
-    if (move_table_corner_permutations == NULL) {
-        move_table_corner_permutations = (int *)malloc(sizeof(int) * N_CORNER_PERMUTATIONS * N_MOVES);
+    if (move_table_E_sorted_slice == NULL) {
+        move_table_E_sorted_slice =
+            build_coord_move_table("E_sorted_slice", N_SORTED_SLICES, set_E_sorted_slice, get_E_sorted_slice);
+    }
+
+    // Edge permutation of every move, used to follow the UD6/UD7 coords without their full move tables.
+    // Those are only built on demand with build_UD6_edge_permutations_move_table and
+    // build_UD7_edge_permutations_move_table, since together they take over 300MB.
+    if (!move_edge_permutations_built) {
+        for (int move = 0; move < N_MOVES; move++) {
+            cube = init_cubie_cube();
+            cubie_apply_move(cube, move);
 
-        cube = init_cubie_cube();
+            for (int i = 0; i < N_EDGES; i++)
+                move_edge_permutations[move * N_EDGES + i] = cube->edge_permutations[i];
 
-        for (int permutations = 0; permutations < N_CORNER_PERMUTATIONS; permutations++) {
-            for (int move = 0; move < N_MOVES; move++) {
-                set_corner_permutations(cube, permutations);
-                cubie_apply_move(cube, move);
-                move_table_corner_permutations[permutations * N_MOVES + move] = get_corner_permutations(cube);
-            }
+            free(cube);
         }
 
-        free(cube);
+        move_edge_permutations_built = 1;
     }
+
+    if (move_table_corner_permutations == NULL) {
+        move_table_corner_permutations = build_coord_move_table("corner_permutations", N_CORNER_PERMUTATIONS,
+                                                                set_corner_permutations, get_corner_permutations);
+    }
+
+    build_phase2_move_tables();
 }
 
 void build_UD6_edge_permutations_move_table() {
@@ -235,8 +443,14 @@ void build_UD6_edge_permutations_move_table() {
     if (move_table_UD6_edge_permutations != NULL)
         return;
 
-    if (pruning_table_cache_load("move_tables", "UD6_edge_permutations", &move_table_UD6_edge_permutations,
-                                 N_UD6_PHASE1_PERMUTATIONS * N_MOVES))
+    cache_layout_t layout = {
+        .element_bits = 32,
+        .dims         = {N_UD6_PHASE1_PERMUTATIONS, N_MOVES, 0},
+        .move_set     = CACHE_MOVE_SET_ALL,
+    };
+
+    if (pruning_table_cache_load("move_tables", "UD6_edge_permutations", &layout,
+                                 (void **)&move_table_UD6_edge_permutations))
         return;
 
     move_table_UD6_edge_permutations = (int *)malloc(sizeof(int) * N_UD6_PHASE1_PERMUTATIONS * N_MOVES);
@@ -251,8 +465,8 @@ void build_UD6_edge_permutations_move_table() {
         }
     }
 
-    pruning_table_cache_store("move_tables", "UD6_edge_permutations", move_table_UD6_edge_permutations,
-                              N_UD6_PHASE1_PERMUTATIONS * N_MOVES);
+    pruning_table_cache_store("move_tables", "UD6_edge_permutations", &layout, move_table_UD6_edge_permutations);
+    pruning_table_cache_flush();
 
     free(cube);
 }
@@ -263,8 +477,14 @@ void build_UD7_edge_permutations_move_table() {
     if (move_table_UD7_edge_permutations != NULL)
         return;
 
-    if (pruning_table_cache_load("move_tables", "UD7_edge_permutations", &move_table_UD7_edge_permutations,
-                                 N_UD7_PHASE1_PERMUTATIONS * N_MOVES))
+    cache_layout_t layout = {
+        .element_bits = 32,
+        .dims         = {N_UD7_PHASE1_PERMUTATIONS, N_MOVES, 0},
+        .move_set     = CACHE_MOVE_SET_ALL,
+    };
+
+    if (pruning_table_cache_load("move_tables", "UD7_edge_permutations", &layout,
+                                 (void **)&move_table_UD7_edge_permutations))
         return;
 
     move_table_UD7_edge_permutations = (int *)malloc(sizeof(int) * N_UD7_PHASE1_PERMUTATIONS * N_MOVES);
@@ -284,8 +504,8 @@ void build_UD7_edge_permutations_move_table() {
         }
     }
 
-    pruning_table_cache_store("move_tables", "UD7_edge_permutations", move_table_UD7_edge_permutations,
-                              N_UD7_PHASE1_PERMUTATIONS * N_MOVES);
+    pruning_table_cache_store("move_tables", "UD7_edge_permutations", &layout, move_table_UD7_edge_permutations);
+    pruning_table_cache_flush();
 
     free(cube);
 }
@@ -24,6 +24,8 @@
 #ifndef _COORD_MOVE_TABLES
 #define _COORD_MOVE_TABLES
 
+#include <stdint.h>
+
 #include "coord_cube.h"
 #include "cubie_cube.h"
 #include "definitions.h"
@@ -32,15 +34,43 @@ void coord_build_move_tables();
 void coord_apply_move(coord_cube_t *cube, move_t move);
 void coord_apply_move_phase1(coord_cube_t *cube, move_t move);
 void coord_apply_moves(coord_cube_t *cube, const move_t *moves, int n_moves);
+void coord_apply_move_phase2(coord_cube_t *cube, int phase2_move);
+
+// Writes the phase2 coords of the cube after the move into child, leaving the cube and the phase1 coords of child
+// alone, so the phase2 search never has to copy a cube or restore it
+void coord_get_phase2_child(coord_cube_t *child, const coord_cube_t *cube, int phase2_move);
+
+// Prefetches the phase2 move table rows that coord_get_phase2_child reads for the children of the cube
+void prefetch_phase2_move_rows(const coord_cube_t *cube);
+
+void coord_get_edge_permutations(const coord_cube_t *cube, edge_t edges[N_EDGES]);
+void coord_set_phase2_coords(coord_cube_t *cube, const coord_cube_t *start, const edge_t start_edges[N_EDGES],
+                             const move_t *moves, int n_moves);
 
-int *get_move_table_edge_orientations();
-int *get_move_table_corner_orientations();
-int *get_move_table_E_slice();
-int *get_move_table_E_sorted_slice();
+// Entries per row of the 18 move tables below. A row is N_MOVES entries long, or a whole cache line with
+// config_t.cache_line_move_tables, so that all the children of a coord are read from a single line.
+#define MOVE_TABLE_CACHE_LINE_STRIDE 32
+
+int       get_move_table_stride();
+uint16_t *get_move_table_edge_orientations();
+uint16_t *get_move_table_corner_orientations();
+uint16_t *get_move_table_E_slice();
+uint16_t *get_move_table_E_sorted_slice();
+uint16_t *get_move_table_corner_permutations();
+
+// The phase1 UD6 and UD7 coords need 32 bits, and their rows are always N_MOVES entries long
 int *get_move_table_UD6_edge_permutations();
 int *get_move_table_UD7_edge_permutations();
-int *get_move_table_corner_permutations();
-int *get_move_table_parity();
+
+// Rows of get_move_table_stride() entries, like the 16 bit tables above
+uint16_t *get_move_table_parity();
+
+// Rows of N_PHASE2_MOVES entries
+const move_t *get_phase2_moves();
+uint16_t     *get_move_table_phase2_E_sorted_slice();
+uint16_t     *get_move_table_phase2_UD6_edge_permutations();
+uint16_t     *get_move_table_phase2_UD7_edge_permutations();
+uint16_t     *get_move_table_phase2_corner_permutations();
 
 void build_UD6_edge_permutations_move_table();
 void build_UD7_edge_permutations_move_table();
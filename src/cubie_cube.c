@@ -466,8 +466,11 @@ void multiply_cube_cubie_corners(cube_cubie_t *cube1, cube_cubie_t *cube2) {
 
             if (orientation < 3)
                 orientation += 3;
-        } else if (orientation_a >= 3 && 3 >= orientation_b) {
+        } else if (orientation_a >= 3 && orientation_b >= 3) {
             orientation = orientation_a - orientation_b;
+
+            if (orientation < 0)
+                orientation += 3;
         } else {
             // This should never happen
             abort();
@@ -482,6 +485,32 @@ void multiply_cube_cubie_corners(cube_cubie_t *cube1, cube_cubie_t *cube2) {
     }
 }
 
+// Only for proper cubes, mirrored ones have corner orientations above 2
+void invert_cubie_cube(const cube_cubie_t *cube, cube_cubie_t *inverse) {
+    for (int i = 0; i < N_EDGES; i++) {
+        inverse->edge_permutations[cube->edge_permutations[i]] = i;
+        inverse->edge_orientations[cube->edge_permutations[i]] = cube->edge_orientations[i];
+    }
+
+    for (int i = 0; i < N_CORNERS; i++) {
+        inverse->corner_permutations[cube->corner_permutations[i]] = i;
+        inverse->corner_orientations[cube->corner_permutations[i]] = (3 - cube->corner_orientations[i]) % 3;
+    }
+}
+
+// cube = symmetry * cube * symmetry^-1, which is the same cube seen from another orientation
+void conjugate_cubie_cube(cube_cubie_t *cube, const cube_cubie_t *symmetry, const cube_cubie_t *inverse_symmetry) {
+    cube_cubie_t result = *symmetry;
+    cube_cubie_t right  = *inverse_symmetry;
+
+    multiply_cube_cubie_edges(&result, cube);
+    multiply_cube_cubie_corners(&result, cube);
+    multiply_cube_cubie_edges(&result, &right);
+    multiply_cube_cubie_corners(&result, &right);
+
+    *cube = result;
+}
+
 int are_cubie_equal(const cube_cubie_t *cube1, const cube_cubie_t *cube2) {
     for (int i = 0; i < N_EDGES; i++) {
         if (cube1->edge_permutations[i] != cube2->edge_permutations[i])
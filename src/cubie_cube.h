@@ -42,6 +42,9 @@ cube_cubie_t *init_cubie_cube();
 void          multiply_cube_cubie(cube_cubie_t *cube1, cube_cubie_t *cube2);
 void          multiply_cube_cubie_edges(cube_cubie_t *cube1, cube_cubie_t *cube2);
 void          multiply_cube_cubie_corners(cube_cubie_t *cube1, cube_cubie_t *cube2);
+void          invert_cubie_cube(const cube_cubie_t *cube, cube_cubie_t *inverse);
+void          conjugate_cubie_cube(cube_cubie_t *cube, const cube_cubie_t *symmetry,
+                                   const cube_cubie_t *inverse_symmetry);
 
 void set_corner_orientations(cube_cubie_t *cube, int orientations);
 int  get_corner_orientations(cube_cubie_t *cube);
@@ -38,6 +38,9 @@
 #define N_EDGES    12
 #define N_FACELETS 54
 
+// U, D and the half turns of R, F, L and B
+#define N_PHASE2_MOVES 10
+
 typedef enum {
     UR = 0,
     UF = 1,
@@ -81,10 +81,9 @@ color_t *build_facelet(const char facelets[N_FACELETS]) {
     return facelet_cube;
 }
 
-cube_cubie_t *build_cubie_cube_from_str(char facelets[N_FACELETS]) {
-    cube_cubie_t *cubie_cube = init_cubie_cube();
-    color_t      *color_cube = build_facelet(facelets);
-
+// Reads the corners and edges of the facelets into the cube. Returns 0 if a corner or an edge has colors that no
+// piece of the solved cube has.
+static int read_cubie_cube(cube_cubie_t *cubie_cube, const color_t *color_cube) {
     for (int i = 0; i < N_CORNERS; i++) {
         int orientation = 0;
         for (orientation = 0; orientation < 3; orientation++) {
@@ -92,23 +91,34 @@ cube_cubie_t *build_cubie_cube_from_str(char facelets[N_FACELETS]) {
                 break;
         }
 
+        if (orientation == 3)
+            return 0;
+
         color_t color_a = color_cube[corner_facelets[i][(orientation + 1) % 3]];
         color_t color_b = color_cube[corner_facelets[i][(orientation + 2) % 3]];
+        int     found   = 0;
 
         for (int j = 0; j < N_CORNERS; j++) {
             if (color_a == corner_colors[j][1] && color_b == corner_colors[j][2]) {
                 cubie_cube->corner_permutations[i] = j;
                 cubie_cube->corner_orientations[i] = orientation;
+                found                              = 1;
             }
         }
+
+        if (!found)
+            return 0;
     }
 
     for (int i = 0; i < N_EDGES; i++) {
+        int found = 0;
+
         for (int j = 0; j < N_EDGES; j++) {
             if (color_cube[edge_facelets[i][0]] == edge_colors[j][0] &&
                 color_cube[edge_facelets[i][1]] == edge_colors[j][1]) {
                 cubie_cube->edge_permutations[i] = j;
                 cubie_cube->edge_orientations[i] = 0;
+                found                            = 1;
                 break;
             }
 
@@ -116,11 +126,38 @@ cube_cubie_t *build_cubie_cube_from_str(char facelets[N_FACELETS]) {
                 color_cube[edge_facelets[i][1]] == edge_colors[j][0]) {
                 cubie_cube->edge_permutations[i] = j;
                 cubie_cube->edge_orientations[i] = 1;
+                found                            = 1;
                 break;
             }
         }
+
+        if (!found)
+            return 0;
     }
 
+    return 1;
+}
+
+int are_facelets_solvable(const char facelets[N_FACELETS]) {
+    if (!verify_valid_facelets(facelets))
+        return 0;
+
+    cube_cubie_t cubie_cube;
+    color_t     *color_cube = build_facelet(facelets);
+    int          read       = read_cubie_cube(&cubie_cube, color_cube);
+
+    free(color_cube);
+
+    // is_valid checks that every piece is there once and the orientation sums, but not the parity
+    return read && is_valid(&cubie_cube) && get_corner_parity(&cubie_cube) == get_edge_parity(&cubie_cube);
+}
+
+cube_cubie_t *build_cubie_cube_from_str(char facelets[N_FACELETS]) {
+    cube_cubie_t *cubie_cube = init_cubie_cube();
+    color_t      *color_cube = build_facelet(facelets);
+
+    read_cubie_cube(cubie_cube, color_cube);
+
     free(color_cube);
 
     assert(is_valid(cubie_cube));
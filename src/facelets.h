@@ -31,4 +31,9 @@ int           verify_valid_facelets(const char facelets[N_FACELETS]);
 color_t      *build_facelet(const char facelets[N_FACELETS]);
 cube_cubie_t *build_cubie_cube_from_str(char facelets[N_FACELETS]);
 
+// Whether the facelets are a cube that can be solved: every corner and edge is there exactly once, the
+// orientations add up, and the corner and edge permutations have the same parity. build_cubie_cube_from_str
+// asserts on most cubes that fail this, so untrusted facelets have to be checked with it first.
+int are_facelets_solvable(const char facelets[N_FACELETS]);
+
 #endif /* end of include guard */
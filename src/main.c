@@ -25,14 +25,18 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 
+#include "batch.h"
 #include "benchmark.h"
 #include "config.h"
 #include "definitions.h"
 #include "mem_utils.h"
 #include "move_tables.h"
 #include "pruning.h"
+#include "pruning_cache.h"
 #include "puzzle.h"
+#include "serve.h"
 #include "solution.h"
 #include "solve.h"
 #include "solver.h"
@@ -50,13 +54,31 @@ int main(int argc, char **argv) {
     struct option long_options[] = {{"benchmark-fast", no_argument, &config->do_benchmark_fast, 1},
                                     {"benchmark-slow", no_argument, &config->do_benchmark_slow, 1},
                                     {"benchmark-2x2", no_argument, &config->do_benchmark_2x2, 1},
+                                    {"benchmark-batch", no_argument, &config->do_benchmark_batch, 1},
+                                    {"benchmark-interleave", no_argument, &config->do_benchmark_interleave, 1},
                                     {"rebuild-tables", no_argument, &config->rebuild_tables, 1},
+                                    {"no-mmap-tables", no_argument, &config->mmap_tables, 0},
+                                    {"verify-tables", no_argument, &config->verify_tables, 1},
+                                    {"serve", no_argument, &config->do_serve, 1},
+                                    {"six-way", no_argument, &config->six_way, 1},
+                                    {"no-simd", no_argument, &config->simd, 0},
+                                    {"no-prefetch", no_argument, &config->prefetch, 0},
+                                    {"cache-line-move-tables", no_argument, &config->cache_line_move_tables, 1},
+                                    {"phase2-cache", no_argument, &config->phase2_cache, 1},
+                                    {"batch", required_argument, 0, 'F'},
+                                    {"batch-interleave", required_argument, 0, 'I'},
                                     {"solve", required_argument, 0, 's'},
                                     {"solve-scramble", required_argument, 0, 'c'},
                                     {"puzzle", required_argument, 0, 'p'},
                                     {"max-depth", required_argument, 0, 'm'},
                                     {"n-solutions", required_argument, 0, 'n'},
+                                    {"threads", required_argument, 0, 't'},
+                                    {"phase2-threads", required_argument, 0, 'W'},
+                                    {"phase2-batch", required_argument, 0, 'G'},
+                                    {"timeout", required_argument, 0, 'T'},
+                                    {"target-length", required_argument, 0, 'L'},
                                     {"move-blacklist", required_argument, 0, 'b'},
+                                    {"phase1-pruning", required_argument, 0, 'P'},
                                     {"compare-against", required_argument, 0, 'A'},
                                     {"compare-benchmarks", required_argument, 0, 'B'},
                                     {"list-puzzles", no_argument, 0, 1},
@@ -140,6 +162,116 @@ int main(int argc, char **argv) {
                 config->n_solutions = atoi(optarg);
             } break;
 
+            case 't': {
+                if (optarg == NULL) {
+                    fprintf(stderr, "optarg is missing for threads");
+                    break;
+                }
+
+                int thread_count = atoi(optarg);
+
+                if (thread_count < 1 || thread_count > MAX_THREAD_COUNT) {
+                    fprintf(stderr, "Error: threads must be between 1 and %d\n", MAX_THREAD_COUNT);
+                    return 1;
+                }
+
+                config->thread_count = thread_count;
+            } break;
+
+            case 'W': {
+                if (optarg == NULL) {
+                    fprintf(stderr, "optarg is missing for phase2 threads");
+                    break;
+                }
+
+                int phase2_threads = atoi(optarg);
+
+                if (phase2_threads < 0 || phase2_threads >= MAX_THREAD_COUNT) {
+                    fprintf(stderr, "Error: phase2 threads must be between 0 and %d\n", MAX_THREAD_COUNT - 1);
+                    return 1;
+                }
+
+                config->phase2_threads = phase2_threads;
+            } break;
+
+            case 'G': {
+                if (optarg == NULL) {
+                    fprintf(stderr, "optarg is missing for phase2 batch");
+                    break;
+                }
+
+                int phase2_batch_size = atoi(optarg);
+
+                if (phase2_batch_size < 0 || phase2_batch_size > MAX_PHASE2_BATCH) {
+                    fprintf(stderr, "Error: phase2 batch must be between 0 and %d\n", MAX_PHASE2_BATCH);
+                    return 1;
+                }
+
+                config->phase2_batch_size = phase2_batch_size;
+            } break;
+
+            case 'I': {
+                if (optarg == NULL) {
+                    fprintf(stderr, "optarg is missing for batch interleave");
+                    break;
+                }
+
+                int batch_interleave = atoi(optarg);
+
+                if (batch_interleave < 1 || batch_interleave > MAX_BATCH_INTERLEAVE) {
+                    fprintf(stderr, "Error: batch interleave must be between 1 and %d\n", MAX_BATCH_INTERLEAVE);
+                    return 1;
+                }
+
+                config->batch_interleave = batch_interleave;
+            } break;
+
+            case 'T': {
+                if (optarg == NULL) {
+                    fprintf(stderr, "optarg is missing for timeout");
+                    break;
+                }
+
+                float timeout = atof(optarg);
+
+                if (timeout < 0) {
+                    fprintf(stderr, "Error: timeout must not be negative\n");
+                    return 1;
+                }
+
+                config->timeout = timeout;
+            } break;
+
+            case 'L': {
+                if (optarg == NULL) {
+                    fprintf(stderr, "optarg is missing for target length");
+                    break;
+                }
+
+                config->target_length = atoi(optarg);
+
+                if (config->target_length < 0 || config->target_length > MAX_MOVES - 1) {
+                    fprintf(stderr, "Error: target length must be between 0 and %d\n", MAX_MOVES - 1);
+                    return 1;
+                }
+            } break;
+
+            case 'P': {
+                if (optarg == NULL) {
+                    fprintf(stderr, "optarg is missing for phase1 pruning");
+                    break;
+                }
+
+                if (strcmp(optarg, "projections") == 0) {
+                    config->phase1_pruning = PHASE1_PRUNING_PROJECTIONS;
+                } else if (strcmp(optarg, "flipslice-twist") == 0) {
+                    config->phase1_pruning = PHASE1_PRUNING_FLIPSLICE_TWIST;
+                } else {
+                    fprintf(stderr, "Error: unknown phase1 pruning table '%s'\n", optarg);
+                    return 1;
+                }
+            } break;
+
             case 'c': {
                 if (optarg == NULL) {
                     fprintf(stderr, "optarg is missing for scramble");
@@ -150,6 +282,10 @@ int main(int argc, char **argv) {
                 config->scramble_moves = move_sequence_str_to_moves(optarg);
             } break;
 
+            case 'F': {
+                config->batch_file = strdup(optarg);
+            } break;
+
             case 'A': {
                 config->compare_against = strdup(optarg);
             } break;
@@ -203,30 +339,55 @@ int main(int argc, char **argv) {
 
         build_move_tables();
         build_pruning_tables();
+        pruning_table_cache_flush();
 
         compare_benchmark_files(file1, file2);
         return 0;
     }
 
-    if (!config->do_benchmark_fast && !config->do_benchmark_slow && !config->do_benchmark_2x2 && !config->do_solve &&
-        config->compare_benchmarks == NULL) {
+    if (!config->do_benchmark_fast && !config->do_benchmark_slow && !config->do_benchmark_2x2 &&
+        !config->do_benchmark_batch && !config->do_benchmark_interleave && !config->do_solve && !config->do_serve &&
+        config->batch_file == NULL && config->compare_benchmarks == NULL) {
         print_help();
         return 0;
     }
 
+    // In serve and batch modes stdout only carries answers, so everything else printed there, like the table
+    // building progress, is sent to stderr instead
+    FILE *serve_out = NULL;
+
+    if (config->do_serve || config->batch_file != NULL) {
+        fflush(stdout);
+        serve_out = fdopen(dup(STDOUT_FILENO), "w");
+        dup2(STDERR_FILENO, STDOUT_FILENO);
+    }
+
     if (config->rebuild_tables) {
-        rmrf("move_tables");
-        rmrf("pruning_tables");
+        pruning_table_cache_clear();
     }
 
     build_move_tables();
     build_pruning_tables();
+    pruning_table_cache_flush();
     if (config->do_benchmark_fast) {
         run_benchmark_fast();
     } else if (config->do_benchmark_slow) {
         run_benchmark_slow();
     } else if (config->do_benchmark_2x2) {
         run_benchmark_2x2();
+    } else if (config->do_benchmark_batch) {
+        run_benchmark_batch();
+    } else if (config->do_benchmark_interleave) {
+        run_benchmark_interleave();
+    } else if (config->do_serve) {
+        run_serve(stdin, serve_out);
+        fclose(serve_out);
+    } else if (config->batch_file != NULL) {
+        int status = run_batch(config->batch_file, serve_out, config->thread_count);
+        fclose(serve_out);
+
+        if (status != 0)
+            return status;
     } else if (config->do_solve) {
         solve_list_t *solution = NULL;
 
@@ -271,7 +432,10 @@ int main(int argc, char **argv) {
         free(facelets_to_solve);
     }
 
-    purge_cubie_move_table();
+    // Stops the solver thread pools and frees their tables
+    init_registry();
+    for (int i = 0; i < solver_count(); i++)
+        solver_by_index(i)->cleanup();
 
     return 0;
 }
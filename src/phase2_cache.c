@@ -0,0 +1,112 @@
+/*
+ * Copyright <2026> <Renan S Silva, aka h3nnn4n>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "phase2_cache.h"
+
+// The coords phase2 reads, which together identify a G1 state
+static uint64_t get_phase2_key(const coord_cube_t *cube) {
+    return ((uint64_t)cube->corner_permutations * N_UD6_PHASE2_PERMUTATIONS + cube->UD6_edge_permutations) *
+               N_SORTED_SLICES_PHASE2 +
+           cube->E_sorted_slice;
+}
+
+static uint64_t get_phase2_slot(uint64_t key) { return (key * 0x9E3779B97F4A7C15ULL) >> (64 - PHASE2_CACHE_BITS); }
+
+phase2_cache_t *make_phase2_cache() {
+    phase2_cache_t *cache = (phase2_cache_t *)malloc(sizeof(phase2_cache_t));
+    assert(cache != NULL);
+
+    memset(cache, 0, sizeof(phase2_cache_t));
+    cache->generation = 1;
+
+    return cache;
+}
+
+void destroy_phase2_cache(phase2_cache_t *cache) { free(cache); }
+
+void clear_phase2_cache(phase2_cache_t *cache) {
+    cache->generation++;
+
+    // Entries left from 2^32 clears ago would look current again
+    if (cache->generation == 0) {
+        memset(cache->entries, 0, sizeof(cache->entries));
+        cache->generation = 1;
+    }
+}
+
+const phase2_cache_entry_t *get_phase2_cache_entry(const phase2_cache_t *cache, const coord_cube_t *cube) {
+    uint64_t                    key   = get_phase2_key(cube);
+    const phase2_cache_entry_t *entry = &cache->entries[get_phase2_slot(key)];
+
+    if (entry->generation != cache->generation || entry->key != key)
+        return NULL;
+
+    return entry;
+}
+
+static phase2_cache_entry_t *claim_phase2_cache_entry(phase2_cache_t *cache, const coord_cube_t *cube) {
+    uint64_t              key   = get_phase2_key(cube);
+    phase2_cache_entry_t *entry = &cache->entries[get_phase2_slot(key)];
+
+    if (entry->generation != cache->generation || entry->key != key) {
+        entry->key            = key;
+        entry->generation     = cache->generation;
+        entry->searched_depth = 0;
+        entry->length         = -1;
+    }
+
+    return entry;
+}
+
+void store_phase2_cache_miss(phase2_cache_t *cache, const coord_cube_t *cube, int depth) {
+    phase2_cache_entry_t *entry = claim_phase2_cache_entry(cache, cube);
+
+    if (depth > entry->searched_depth)
+        entry->searched_depth = (int8_t)depth;
+}
+
+void store_phase2_cache_solution(phase2_cache_t *cache, const coord_cube_t *cube, const uint8_t *solution) {
+    int length = 0;
+    while (solution[length] != MOVE_NULL)
+        length++;
+
+    if (length > PHASE2_CACHE_MAX_LENGTH)
+        return;
+
+    phase2_cache_entry_t *entry = claim_phase2_cache_entry(cache, cube);
+
+    entry->searched_depth = (int8_t)(length - 1);
+    entry->length         = (int8_t)length;
+    memcpy(entry->moves, solution, length);
+}
+
+void get_phase2_cache_solution(const phase2_cache_entry_t *entry, uint8_t *solution) {
+    assert(entry->length >= 0);
+
+    memcpy(solution, entry->moves, entry->length);
+    solution[entry->length] = MOVE_NULL;
+}
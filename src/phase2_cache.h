@@ -0,0 +1,71 @@
+/*
+ * Copyright <2026> <Renan S Silva, aka h3nnn4n>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef _PHASE2_CACHE
+#define _PHASE2_CACHE
+
+#include <stdint.h>
+
+#include "coord_cube.h"
+#include "definitions.h"
+
+#define PHASE2_CACHE_BITS 12
+#define PHASE2_CACHE_SIZE (1 << PHASE2_CACHE_BITS)
+
+// No phase2 solution is longer than this, longer ones are not worth caching
+#define PHASE2_CACHE_MAX_LENGTH 18
+
+// What is known about the phase2 search of one G1 state: no solution up to searched_depth moves, and the
+// shortest solution if length is not -1.
+typedef struct {
+    uint64_t key;
+    uint32_t generation;
+    int8_t   searched_depth;
+    int8_t   length;
+    uint8_t  moves[PHASE2_CACHE_MAX_LENGTH];
+} phase2_cache_entry_t;
+
+// Many phase1 solutions end at the same G1 state, so the phase2 results are kept in a direct mapped table keyed
+// by the phase2 coords. Entries from an older generation are empty, which makes clearing it free.
+typedef struct {
+    uint32_t             generation;
+    phase2_cache_entry_t entries[PHASE2_CACHE_SIZE];
+} phase2_cache_t;
+
+phase2_cache_t *make_phase2_cache();
+void            destroy_phase2_cache(phase2_cache_t *cache);
+void            clear_phase2_cache(phase2_cache_t *cache);
+
+// Returns the entry of the cube, or NULL if nothing is known about it
+const phase2_cache_entry_t *get_phase2_cache_entry(const phase2_cache_t *cache, const coord_cube_t *cube);
+
+// Records that the cube has no phase2 solution of up to depth moves
+void store_phase2_cache_miss(phase2_cache_t *cache, const coord_cube_t *cube, int depth);
+
+// Records the shortest phase2 solution of the cube, terminated by MOVE_NULL
+void store_phase2_cache_solution(phase2_cache_t *cache, const coord_cube_t *cube, const uint8_t *solution);
+
+// Copies the solution of the entry into solution, terminated by MOVE_NULL
+void get_phase2_cache_solution(const phase2_cache_entry_t *entry, uint8_t *solution);
+
+#endif /* end of include guard */
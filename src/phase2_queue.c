@@ -0,0 +1,143 @@
+/*
+ * Copyright <2026> <Renan S Silva, aka h3nnn4n>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include <assert.h>
+#include <stdlib.h>
+
+#include "phase2_queue.h"
+
+#define CACHE_LINE_SIZE 64
+
+// Every cell has a sequence number that tells whose turn it is: it equals the position of the next push into the
+// cell once it is free, and that position plus one once it holds a candidate. Producers and consumers claim
+// positions with a compare and swap on their own counter, so they never wait on each other's locks.
+typedef struct {
+    atomic_size_t      sequence;
+    phase2_candidate_t candidate;
+} phase2_queue_cell_t;
+
+struct phase2_queue_s {
+    phase2_queue_cell_t *cells;
+    size_t               mask;
+
+    // Kept on their own cache lines, since producers and consumers write them all the time
+    char          padding0[CACHE_LINE_SIZE];
+    atomic_size_t push_position;
+    char          padding1[CACHE_LINE_SIZE];
+    atomic_size_t pop_position;
+    char          padding2[CACHE_LINE_SIZE];
+    atomic_int    n_producers;
+};
+
+phase2_queue_t *make_phase2_queue(int capacity) {
+    assert(capacity > 0);
+
+    size_t size = 1;
+    while (size < (size_t)capacity)
+        size *= 2;
+
+    phase2_queue_t *queue = (phase2_queue_t *)malloc(sizeof(phase2_queue_t));
+    assert(queue != NULL);
+
+    queue->cells = (phase2_queue_cell_t *)malloc(sizeof(phase2_queue_cell_t) * size);
+    assert(queue->cells != NULL);
+    queue->mask = size - 1;
+
+    reset_phase2_queue(queue, 0);
+
+    return queue;
+}
+
+void destroy_phase2_queue(phase2_queue_t *queue) {
+    free(queue->cells);
+    free(queue);
+}
+
+void reset_phase2_queue(phase2_queue_t *queue, int n_producers) {
+    for (size_t i = 0; i <= queue->mask; i++)
+        atomic_store_explicit(&queue->cells[i].sequence, i, memory_order_relaxed);
+
+    atomic_store_explicit(&queue->push_position, 0, memory_order_relaxed);
+    atomic_store_explicit(&queue->pop_position, 0, memory_order_relaxed);
+    atomic_store(&queue->n_producers, n_producers);
+}
+
+bool push_phase2_candidate(phase2_queue_t *queue, const phase2_candidate_t *candidate) {
+    size_t               position = atomic_load_explicit(&queue->push_position, memory_order_relaxed);
+    phase2_queue_cell_t *cell;
+
+    while (1) {
+        cell = &queue->cells[position & queue->mask];
+
+        size_t   sequence = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+        intptr_t diff     = (intptr_t)sequence - (intptr_t)position;
+
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&queue->push_position, &position, position + 1,
+                                                      memory_order_relaxed, memory_order_relaxed))
+                break;
+        } else if (diff < 0) {
+            // The cell still holds the candidate pushed one lap ago
+            return false;
+        } else {
+            position = atomic_load_explicit(&queue->push_position, memory_order_relaxed);
+        }
+    }
+
+    cell->candidate = *candidate;
+    atomic_store_explicit(&cell->sequence, position + 1, memory_order_release);
+
+    return true;
+}
+
+bool pop_phase2_candidate(phase2_queue_t *queue, phase2_candidate_t *candidate) {
+    size_t               position = atomic_load_explicit(&queue->pop_position, memory_order_relaxed);
+    phase2_queue_cell_t *cell;
+
+    while (1) {
+        cell = &queue->cells[position & queue->mask];
+
+        size_t   sequence = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+        intptr_t diff     = (intptr_t)sequence - (intptr_t)(position + 1);
+
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&queue->pop_position, &position, position + 1,
+                                                      memory_order_relaxed, memory_order_relaxed))
+                break;
+        } else if (diff < 0) {
+            // Nothing was pushed into the cell yet
+            return false;
+        } else {
+            position = atomic_load_explicit(&queue->pop_position, memory_order_relaxed);
+        }
+    }
+
+    *candidate = cell->candidate;
+    atomic_store_explicit(&cell->sequence, position + queue->mask + 1, memory_order_release);
+
+    return true;
+}
+
+void close_phase2_producer(phase2_queue_t *queue) { atomic_fetch_sub(&queue->n_producers, 1); }
+
+bool has_phase2_producers(phase2_queue_t *queue) { return atomic_load(&queue->n_producers) > 0; }
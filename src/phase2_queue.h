@@ -0,0 +1,64 @@
+/*
+ * Copyright <2026> <Renan S Silva, aka h3nnn4n>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef _PHASE2_QUEUE
+#define _PHASE2_QUEUE
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "coord_cube.h"
+
+// Longest phase1 solution a candidate can carry
+#define PHASE2_QUEUE_MAX_MOVES 32
+
+// A phase1 solution that brought the cube into G1, waiting for its phase2 search. The cube holds the phase2
+// coords, and the moves are the phase1 solution of the given view of the cube.
+typedef struct {
+    coord_cube_t cube;
+    int8_t       view;
+    int8_t       phase1_length;
+    int8_t       phase2_depth;
+    uint8_t      moves[PHASE2_QUEUE_MAX_MOVES];
+} phase2_candidate_t;
+
+typedef struct phase2_queue_s phase2_queue_t;
+
+// A bounded lock-free queue that any number of phase1 workers push candidates into and any number of phase2
+// workers pop them from. The capacity is rounded up to a power of two.
+phase2_queue_t *make_phase2_queue(int capacity);
+void            destroy_phase2_queue(phase2_queue_t *queue);
+
+// Empties the queue for a new solve with the given number of producers. Nobody can be using it at that point.
+void reset_phase2_queue(phase2_queue_t *queue, int n_producers);
+
+// Both return false instead of waiting when the queue is full or empty
+bool push_phase2_candidate(phase2_queue_t *queue, const phase2_candidate_t *candidate);
+bool pop_phase2_candidate(phase2_queue_t *queue, phase2_candidate_t *candidate);
+
+// Called by every producer once it is done pushing. Once they all are, an empty queue stays empty.
+void close_phase2_producer(phase2_queue_t *queue);
+bool has_phase2_producers(phase2_queue_t *queue);
+
+#endif /* end of include guard */
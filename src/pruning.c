@@ -22,14 +22,26 @@
  */
 
 #include <assert.h>
+#include <pthread.h>
+#include <stdatomic.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
 
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define HAVE_AVX2_KERNELS
+#endif
+
+#include "config.h"
 #include "coord_cube.h"
 #include "coord_move_tables.h"
 #include "definitions.h"
 #include "pruning.h"
 #include "pruning_cache.h"
+#include "symmetry.h"
 #include "utils.h"
 
 /*
@@ -44,39 +56,256 @@ With UD7
 
 #define USE_UD7
 
-static int *pruning_phase1_edge     = NULL;
-static int *pruning_phase1_corner   = NULL;
-static int *pruning_phase1_combined = NULL;
-static int *pruning_phase2_UD6_edge = NULL;
-static int *pruning_phase2_UD7_edge = NULL;
-static int *pruning_phase2_corner   = NULL;
+// Pruning depths never go above 14, so the tables store two entries per byte,
+// low nibble first. An entry the BFS has not reached yet holds PRUNING_EMPTY.
+#define PRUNING_EMPTY          0xF
+#define PRUNING_TABLE_BYTES(n) (((n) + 1) / 2)
+
+// The vectorized lookups read the tables a 32 bit word at a time, which can go up to 3 bytes past the end
+#define PRUNING_TABLE_PADDING 3
+
+#define N_FLIPSLICE_TWIST (N_FLIPSLICE_CLASSES * N_CORNER_ORIENTATIONS)
+
+static uint8_t *pruning_phase1_edge     = NULL;
+static uint8_t *pruning_phase1_corner   = NULL;
+static uint8_t *pruning_phase1_combined = NULL;
+static uint8_t *pruning_phase2_UD6_edge = NULL;
+static uint8_t *pruning_phase2_UD7_edge = NULL;
+static uint8_t *pruning_phase2_corner   = NULL;
+
+static uint8_t *pruning_phase1_flipslice_twist = NULL;
+
+// The class index and the symmetry of each flipslice, fused into classidx * N_SYMMETRIES_D4H + sym, so a lookup
+// takes one cache miss instead of one per table
+static uint32_t       *flipslice_class_sym = NULL;
+static const uint16_t *twist_conj          = NULL;
+
+static int has_avx2 = 0;
+
+static inline int get_pruning_value(const uint8_t *table, int index) {
+    return (table[index >> 1] >> ((index & 1) << 2)) & 0xF;
+}
+
+static inline void set_pruning_value(uint8_t *table, int index, int value) {
+    int shift = (index & 1) << 2;
+
+    table[index >> 1] = (uint8_t)((table[index >> 1] & ~(0xF << shift)) | ((value & 0xF) << shift));
+}
+
+static uint8_t *make_pruning_table(int size) {
+    uint8_t *table = (uint8_t *)malloc(PRUNING_TABLE_BYTES(size) + PRUNING_TABLE_PADDING);
+    memset(table, 0xFF, PRUNING_TABLE_BYTES(size) + PRUNING_TABLE_PADDING);
+    return table;
+}
 
 void build_pruning_tables() {
+#if defined(HAVE_AVX2_KERNELS)
+    has_avx2 = __builtin_cpu_supports("avx2");
+#endif
+
     build_phase1_corner_table();
     build_phase1_edge_table();
     build_phase1_combined_table();
 
+    if (get_config()->phase1_pruning == PHASE1_PRUNING_FLIPSLICE_TWIST)
+        build_phase1_flipslice_twist_table();
+
     build_phase2_UD6_edge_table();
     build_phase2_UD7_edge_table();
     build_phase2_corner_table();
 }
 
-int get_phase1_pruning(const coord_cube_t *cube) {
+static inline int get_flipslice_twist_index(int edge_orientations, int E_slice, int corner_orientations) {
+    int flipslice = E_slice * N_EDGE_ORIENTATIONS + edge_orientations;
+    int class_sym = flipslice_class_sym[flipslice];
+    int classidx  = class_sym / N_SYMMETRIES_D4H;
+    int twist     = twist_conj[corner_orientations * N_SYMMETRIES_D4H + class_sym % N_SYMMETRIES_D4H];
+
+    return classidx * N_CORNER_ORIENTATIONS + twist;
+}
+
+static inline int get_phase1_projections_pruning(int edge_orientations, int corner_orientations, int E_slice) {
     assert(pruning_phase1_corner != NULL);
     assert(pruning_phase1_edge != NULL);
     assert(pruning_phase1_combined != NULL);
 
-    int value1 = pruning_phase1_corner[cube->corner_orientations * N_SLICES + cube->E_slice];
-    int value2 = pruning_phase1_edge[cube->edge_orientations * N_SLICES + cube->E_slice];
-    int value3 = pruning_phase1_combined[cube->corner_orientations * N_EDGE_ORIENTATIONS + cube->edge_orientations];
+    int index1 = corner_orientations * N_SLICES + E_slice;
+    int index2 = edge_orientations * N_SLICES + E_slice;
+    int index3 = corner_orientations * N_EDGE_ORIENTATIONS + edge_orientations;
 
-    assert(value1 >= 0 && value1 < N_SLICES * N_CORNER_ORIENTATIONS);
-    assert(value2 >= 0 && value2 < N_SLICES * N_EDGE_ORIENTATIONS);
-    assert(value3 >= 0 && value3 < N_CORNER_ORIENTATIONS * N_EDGE_ORIENTATIONS);
+    assert(index1 >= 0 && index1 < N_SLICES * N_CORNER_ORIENTATIONS);
+    assert(index2 >= 0 && index2 < N_SLICES * N_EDGE_ORIENTATIONS);
+    assert(index3 >= 0 && index3 < N_CORNER_ORIENTATIONS * N_EDGE_ORIENTATIONS);
+
+    int value1 = get_pruning_value(pruning_phase1_corner, index1);
+    int value2 = get_pruning_value(pruning_phase1_edge, index2);
+    int value3 = get_pruning_value(pruning_phase1_combined, index3);
+
+    assert(value1 != PRUNING_EMPTY);
+    assert(value2 != PRUNING_EMPTY);
+    assert(value3 != PRUNING_EMPTY);
 
     return MAX(MAX(value1, value2), value3);
 }
 
+static int get_phase1_flipslice_twist_pruning(const coord_cube_t *cube) {
+    assert(pruning_phase1_flipslice_twist != NULL);
+
+    int index = get_flipslice_twist_index(cube->edge_orientations, cube->E_slice, cube->corner_orientations);
+
+    assert(index >= 0 && index < N_FLIPSLICE_TWIST);
+
+    int value = get_pruning_value(pruning_phase1_flipslice_twist, index);
+
+    assert(value != PRUNING_EMPTY);
+
+    return value;
+}
+
+int get_phase1_pruning(const coord_cube_t *cube) {
+    if (get_config()->phase1_pruning == PHASE1_PRUNING_FLIPSLICE_TWIST)
+        return get_phase1_flipslice_twist_pruning(cube);
+
+    return get_phase1_projections_pruning(cube->edge_orientations, cube->corner_orientations, cube->E_slice);
+}
+
+static void get_phase1_children_scalar(const coord_cube_t *cube, phase1_children_t *children) {
+    const int       stride              = get_move_table_stride();
+    const uint16_t *edge_orientations   = get_move_table_edge_orientations() + cube->edge_orientations * stride;
+    const uint16_t *corner_orientations = get_move_table_corner_orientations() + cube->corner_orientations * stride;
+    const uint16_t *E_slice             = get_move_table_E_slice() + cube->E_slice * stride;
+
+    int use_projections = get_config()->phase1_pruning != PHASE1_PRUNING_FLIPSLICE_TWIST;
+
+    for (int move = 0; move < N_MOVES; move++) {
+        children->edge_orientations[move]   = edge_orientations[move];
+        children->corner_orientations[move] = corner_orientations[move];
+        children->E_slice[move]             = E_slice[move];
+
+        if (use_projections) {
+            children->pruning[move] =
+                get_phase1_projections_pruning(edge_orientations[move], corner_orientations[move], E_slice[move]);
+        } else {
+            children->pruning[move] = get_pruning_value(
+                pruning_phase1_flipslice_twist,
+                get_flipslice_twist_index(edge_orientations[move], E_slice[move], corner_orientations[move]));
+        }
+    }
+}
+
+#if defined(HAVE_AVX2_KERNELS)
+// The entries at index of a table of two entries per byte, for the lanes in mask. The other lanes are 0.
+__attribute__((target("avx2"))) static inline __m256i gather_pruning_values(const uint8_t *table, __m256i index,
+                                                                            __m256i mask) {
+    __m256i words = _mm256_mask_i32gather_epi32(_mm256_setzero_si256(), (const int *)table,
+                                                _mm256_srli_epi32(index, 3), mask, 4);
+    __m256i shift = _mm256_slli_epi32(_mm256_and_si256(index, _mm256_set1_epi32(7)), 2);
+
+    return _mm256_and_si256(_mm256_srlv_epi32(words, shift), _mm256_set1_epi32(0xF));
+}
+
+_Static_assert(N_MOVES % 8 == 2, "load_move_row expects two moves in the last group of eight");
+
+// The entries of moves move to move + 7 of a move table row, widened to 32 bits. Entries past the last move are 0,
+// and nothing past the end of the row is read, since a packed row can be the last one of its table.
+__attribute__((target("avx2"))) static inline __m256i load_move_row(const uint16_t *row, int move) {
+    if (move + 8 <= N_MOVES)
+        return _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)(row + move)));
+
+    uint32_t last;
+    memcpy(&last, row + move, sizeof(last));
+
+    return _mm256_cvtepu16_epi32(_mm_cvtsi32_si128((int)last));
+}
+
+// Eight moves at a time. The move table rows of the cube hold the children of all 18 moves next to each other,
+// so only the pruning tables need gathers.
+__attribute__((target("avx2"))) static void get_phase1_children_avx2(const coord_cube_t *cube,
+                                                                     phase1_children_t *children) {
+    const int       stride              = get_move_table_stride();
+    const uint16_t *edge_orientations   = get_move_table_edge_orientations() + cube->edge_orientations * stride;
+    const uint16_t *corner_orientations = get_move_table_corner_orientations() + cube->corner_orientations * stride;
+    const uint16_t *E_slice             = get_move_table_E_slice() + cube->E_slice * stride;
+
+    const __m256i n_slices            = _mm256_set1_epi32(N_SLICES);
+    const __m256i n_edge_orientations = _mm256_set1_epi32(N_EDGE_ORIENTATIONS);
+
+    for (int move = 0; move < N_MOVES; move += 8) {
+        // Lanes past the last move are not gathered
+        __m256i lane = _mm256_add_epi32(_mm256_set1_epi32(move), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+        __m256i mask = _mm256_cmpgt_epi32(_mm256_set1_epi32(N_MOVES), lane);
+
+        __m256i edge   = load_move_row(edge_orientations, move);
+        __m256i corner = load_move_row(corner_orientations, move);
+        __m256i slice  = load_move_row(E_slice, move);
+
+        __m256i index1 = _mm256_add_epi32(_mm256_mullo_epi32(corner, n_slices), slice);
+        __m256i index2 = _mm256_add_epi32(_mm256_mullo_epi32(edge, n_slices), slice);
+        __m256i index3 = _mm256_add_epi32(_mm256_mullo_epi32(corner, n_edge_orientations), edge);
+
+        __m256i value1 = gather_pruning_values(pruning_phase1_corner, index1, mask);
+        __m256i value2 = gather_pruning_values(pruning_phase1_edge, index2, mask);
+        __m256i value3 = gather_pruning_values(pruning_phase1_combined, index3, mask);
+
+        __m256i pruning = _mm256_max_epi32(_mm256_max_epi32(value1, value2), value3);
+
+        _mm256_storeu_si256((__m256i *)&children->edge_orientations[move], edge);
+        _mm256_storeu_si256((__m256i *)&children->corner_orientations[move], corner);
+        _mm256_storeu_si256((__m256i *)&children->E_slice[move], slice);
+        _mm256_storeu_si256((__m256i *)&children->pruning[move], pruning);
+    }
+}
+#endif
+
+void get_phase1_children(const coord_cube_t *cube, phase1_children_t *children) {
+#if defined(HAVE_AVX2_KERNELS)
+    const config_t *config = get_config();
+
+    if (has_avx2 && config->simd && config->phase1_pruning == PHASE1_PRUNING_PROJECTIONS) {
+        get_phase1_children_avx2(cube, children);
+        return;
+    }
+#endif
+
+    get_phase1_children_scalar(cube, children);
+}
+
+void prefetch_phase1_children(const phase1_children_t *siblings, int move) {
+    // The flipslice/twist index needs the symmetry class of the children first, which are cache misses of their
+    // own. Prefetching it would be most of the lookup done twice, and was no faster in the benchmarks.
+    if (get_config()->phase1_pruning == PHASE1_PRUNING_FLIPSLICE_TWIST)
+        return;
+
+    const int       stride            = get_move_table_stride();
+    const uint16_t *edge_orientations = get_move_table_edge_orientations() + siblings->edge_orientations[move] * stride;
+    const uint16_t *corner_orientations =
+        get_move_table_corner_orientations() + siblings->corner_orientations[move] * stride;
+    const uint16_t *E_slice = get_move_table_E_slice() + siblings->E_slice[move] * stride;
+
+    for (int child = 0; child < N_MOVES; child++) {
+        int index1 = corner_orientations[child] * N_SLICES + E_slice[child];
+        int index2 = edge_orientations[child] * N_SLICES + E_slice[child];
+        int index3 = corner_orientations[child] * N_EDGE_ORIENTATIONS + edge_orientations[child];
+
+        __builtin_prefetch(&pruning_phase1_corner[index1 >> 1]);
+        __builtin_prefetch(&pruning_phase1_edge[index2 >> 1]);
+        __builtin_prefetch(&pruning_phase1_combined[index3 >> 1]);
+    }
+}
+
+void prefetch_phase2_pruning(const coord_cube_t *cube) {
+    int index_corner = cube->corner_permutations * N_SORTED_SLICES_PHASE2 + cube->E_sorted_slice;
+    __builtin_prefetch(&pruning_phase2_corner[index_corner >> 1]);
+
+#if defined(USE_UD7)
+    int index_UD7_edge = cube->UD7_edge_permutations * N_SORTED_SLICES_PHASE2 + cube->E_sorted_slice;
+    __builtin_prefetch(&pruning_phase2_UD7_edge[index_UD7_edge >> 1]);
+#else
+    int index_UD6_edge = cube->UD6_edge_permutations * N_SORTED_SLICES_PHASE2 + cube->E_sorted_slice;
+    __builtin_prefetch(&pruning_phase2_UD6_edge[index_UD6_edge >> 1]);
+#endif
+}
+
 int get_phase2_pruning(const coord_cube_t *cube) {
     assert(pruning_phase2_corner != NULL);
     assert(is_phase1_solved(cube)); // UD6_slices and UD7_slices only works for phase2
@@ -86,7 +315,7 @@ int get_phase2_pruning(const coord_cube_t *cube) {
     assert(index_corner >= 0);
     assert(index_corner < N_CORNER_PERMUTATIONS * N_SORTED_SLICES_PHASE2);
 
-    int value_corner = pruning_phase2_corner[index_corner];
+    int value_corner = get_pruning_value(pruning_phase2_corner, index_corner);
 
     int value_edge = 0;
 
@@ -95,470 +324,507 @@ int get_phase2_pruning(const coord_cube_t *cube) {
     int index_UD7_edge = cube->UD7_edge_permutations * N_SORTED_SLICES_PHASE2 + cube->E_sorted_slice;
     assert(index_UD7_edge >= 0);
     assert(index_UD7_edge < N_UD7_PHASE2_PERMUTATIONS * N_SORTED_SLICES_PHASE2);
-    int value_UD7_edge = pruning_phase2_UD7_edge[index_UD7_edge];
+    int value_UD7_edge = get_pruning_value(pruning_phase2_UD7_edge, index_UD7_edge);
     value_edge         = value_UD7_edge;
 #else
     assert(pruning_phase2_UD6_edge != NULL);
     int index_UD6_edge = cube->UD6_edge_permutations * N_SORTED_SLICES_PHASE2 + cube->E_sorted_slice;
     assert(index_UD6_edge >= 0);
     assert(index_UD6_edge < N_UD6_PHASE2_PERMUTATIONS * N_SORTED_SLICES_PHASE2);
-    int value_UD6_edge = pruning_phase2_UD6_edge[index_UD6_edge];
+    int value_UD6_edge = get_pruning_value(pruning_phase2_UD6_edge, index_UD6_edge);
     value_edge         = value_UD6_edge;
 #endif
 
     return MAX(value_corner, value_edge);
 }
 
-void build_phase1_corner_table() {
-    if (pruning_phase1_corner != NULL)
-        return;
-
-    if (pruning_table_cache_load("pruning_tables", "phase1_corner", &pruning_phase1_corner,
-                                 N_CORNER_ORIENTATIONS * N_SLICES))
-        return;
-
-    printf("bulding phase1 corner orientations pruning table\n");
+// Every table is filled with a breadth first search from the solved cube. Each depth level is split in chunks
+// that worker threads grab from a shared counter. Two entries share a byte, so new entries are published with a
+// compare and swap on the whole byte, and only the thread that wins it counts the entry.
+typedef struct pruning_bfs_s pruning_bfs_t;
+
+struct pruning_bfs_s {
+    const char   *name;
+    uint8_t      *table;
+    int           size;
+    int           max_depth;
+    const move_t *moves;
+    int           n_moves;
+
+    // Most tables index a pair of coords as major * n_minor + minor. Their move tables have one column per entry
+    // of moves, in the same order, in rows of row_length entries.
+    int             n_minor;
+    int             row_length;
+    const uint16_t *major_move_table;
+    const uint16_t *minor_move_table;
+
+    // Optional, for tables that do not fit the pair of coords layout
+    int (*get_neighbour)(const pruning_bfs_t *bfs, int index, move_t move);
+    // Optional, fills the other entries that stand for the same cube and returns how many were filled
+    int (*fill_symmetric)(const pruning_bfs_t *bfs, int index, int value);
+};
+
+typedef struct {
+    const pruning_bfs_t *bfs;
+    atomic_int          *next_chunk;
+    int                  depth;
+    int                  backwards;
+    int                  filled;
+} pruning_bfs_worker_t;
+
+#define PRUNING_BFS_CHUNK_SIZE  (1 << 16)
+#define PRUNING_BFS_MAX_THREADS 64
+
+static const move_t phase1_moves[] = {MOVE_U1, MOVE_U2, MOVE_U3, MOVE_R1, MOVE_R2, MOVE_R3,
+                                      MOVE_F1, MOVE_F2, MOVE_F3, MOVE_D1, MOVE_D2, MOVE_D3,
+                                      MOVE_L1, MOVE_L2, MOVE_L3, MOVE_B1, MOVE_B2, MOVE_B3};
+
+static cache_layout_t make_pruning_table_layout(int n_major, int n_minor, const move_t *moves, int n_moves) {
+    cache_layout_t layout = {
+        .element_bits = 4,
+        .dims         = {n_major, n_minor, 0},
+        .move_set     = cache_move_set(moves, n_moves),
+    };
+
+    return layout;
+}
 
-    uint64_t start_time   = get_microseconds();
-    pruning_phase1_corner = (int *)malloc(sizeof(int) * N_CORNER_ORIENTATIONS * N_SLICES);
+static inline int load_pruning_value(const uint8_t *table, int index) {
+    uint8_t byte = atomic_load_explicit((_Atomic uint8_t *)&table[index >> 1], memory_order_relaxed);
 
-    for (int i = 0; i < N_CORNER_ORIENTATIONS * N_SLICES; i++)
-        pruning_phase1_corner[i] = -1;
+    return (byte >> ((index & 1) << 2)) & 0xF;
+}
 
-    // The solved phase1 cube has coord zero and can be solved in zero moves
-    pruning_phase1_corner[0] = 0;
+// Returns 1 if the entry was empty and now holds value, 0 if it was already filled
+static inline int claim_pruning_value(uint8_t *table, int index, int value) {
+    _Atomic uint8_t *byte  = (_Atomic uint8_t *)&table[index >> 1];
+    int              shift = (index & 1) << 2;
+    uint8_t          old   = atomic_load_explicit(byte, memory_order_relaxed);
+    uint8_t          new;
 
-    const int *slice_move_table               = get_move_table_E_slice();
-    const int *corner_orientations_move_table = get_move_table_corner_orientations();
+    do {
+        if (((old >> shift) & 0xF) != PRUNING_EMPTY)
+            return 0;
 
-    int missing = N_CORNER_ORIENTATIONS * N_SLICES - 1;
-    int depth   = 0;
+        new = (uint8_t)((old & ~(0xF << shift)) | (value << shift));
+    } while (!atomic_compare_exchange_weak_explicit(byte, &old, new, memory_order_relaxed, memory_order_relaxed));
 
-    int depth_dist[20] = {0};
-
-    while (missing > 0) {
-        for (int i = 0; i < N_CORNER_ORIENTATIONS * N_SLICES; i++) {
-            if (pruning_phase1_corner[i] == depth) {
-                int slice               = i % N_SLICES;
-                int corner_orientations = i / N_SLICES;
-
-                for (int move = 0; move < N_MOVES; move++) {
-                    int next_slice               = slice_move_table[slice * N_MOVES + move];
-                    int next_corner_orientations = corner_orientations_move_table[corner_orientations * N_MOVES + move];
-
-                    if (pruning_phase1_corner[next_corner_orientations * N_SLICES + next_slice] == -1) {
-                        pruning_phase1_corner[next_corner_orientations * N_SLICES + next_slice] = depth + 1;
-                        missing--;
-                        depth_dist[depth]++;
-                    }
-                }
-            }
-        }
-        printf("finished depth %2d: %8d %8d\n", depth, depth_dist[depth], (N_CORNER_ORIENTATIONS * N_SLICES) - missing);
-
-        assert(depth <= 8);
-        depth++;
-    }
-
-    uint64_t end_time = get_microseconds();
+    return 1;
+}
 
-    printf("elapsed time: %f seconds - ", (float)(end_time - start_time) / 1000000.0);
-    printf("nodes per second : %.2f\n",
-           ((float)(N_CORNER_ORIENTATIONS * N_SLICES) / (end_time - start_time)) * 1000000.0);
-    printf("\n");
+static inline int get_pruning_bfs_neighbour(const pruning_bfs_t *bfs, int index, int move_index) {
+    if (bfs->get_neighbour != NULL)
+        return bfs->get_neighbour(bfs, index, bfs->moves[move_index]);
 
-    for (int i = 0; i < N_CORNER_ORIENTATIONS * N_SLICES; i++) {
-        if (pruning_phase1_corner[i] == -1) {
-            printf("phase1 corner pruning is not correctly populated!\n");
-            abort();
-        }
-    }
+    int major = bfs->major_move_table[(index / bfs->n_minor) * bfs->row_length + move_index];
+    int minor = bfs->minor_move_table[(index % bfs->n_minor) * bfs->row_length + move_index];
 
-    pruning_table_cache_store("pruning_tables", "phase1_corner", pruning_phase1_corner,
-                              N_CORNER_ORIENTATIONS * N_SLICES);
+    return major * bfs->n_minor + minor;
 }
 
-void build_phase1_edge_table() {
-    if (pruning_phase1_edge != NULL)
-        return;
+static void *pruning_bfs_worker(void *arg) {
+    pruning_bfs_worker_t *worker = (pruning_bfs_worker_t *)arg;
+    const pruning_bfs_t  *bfs    = worker->bfs;
+    const int             depth  = worker->depth;
 
-    if (pruning_table_cache_load("pruning_tables", "phase1_edge", &pruning_phase1_edge, N_EDGE_ORIENTATIONS * N_SLICES))
-        return;
+    worker->filled = 0;
 
-    printf("bulding phase1 edge orientations pruning table\n");
+    while (1) {
+        int start = atomic_fetch_add(worker->next_chunk, PRUNING_BFS_CHUNK_SIZE);
 
-    uint64_t start_time = get_microseconds();
-    pruning_phase1_edge = (int *)malloc(sizeof(int) * N_EDGE_ORIENTATIONS * N_SLICES);
+        if (start >= bfs->size)
+            break;
 
-    for (int i = 0; i < N_EDGE_ORIENTATIONS * N_SLICES; i++)
-        pruning_phase1_edge[i] = -1;
+        int end = MIN(start + PRUNING_BFS_CHUNK_SIZE, bfs->size);
 
-    // The solved phase1 cube has coord zero and can be solved in zero moves
-    pruning_phase1_edge[0] = 0;
+        for (int i = start; i < end; i++) {
+            int value = load_pruning_value(bfs->table, i);
 
-    const int *slice_move_table             = get_move_table_E_slice();
-    const int *edge_orientations_move_table = get_move_table_edge_orientations();
+            if (worker->backwards) {
+                if (value != PRUNING_EMPTY)
+                    continue;
 
-    int missing = N_EDGE_ORIENTATIONS * N_SLICES - 1;
-    int depth   = 0;
+                for (int move_index = 0; move_index < bfs->n_moves; move_index++) {
+                    int next_index = get_pruning_bfs_neighbour(bfs, i, move_index);
 
-    int depth_dist[20] = {0};
+                    assert(next_index >= 0 && next_index < bfs->size);
 
-    while (missing > 0) {
-        for (int i = 0; i < N_EDGE_ORIENTATIONS * N_SLICES; i++) {
-            if (pruning_phase1_edge[i] == depth) {
-                int slice             = i % N_SLICES;
-                int edge_orientations = i / N_SLICES;
-
-                for (int move = 0; move < N_MOVES; move++) {
-                    int next_slice             = slice_move_table[slice * N_MOVES + move];
-                    int next_edge_orientations = edge_orientations_move_table[edge_orientations * N_MOVES + move];
-
-                    if (pruning_phase1_edge[next_edge_orientations * N_SLICES + next_slice] == -1) {
-                        pruning_phase1_edge[next_edge_orientations * N_SLICES + next_slice] = depth + 1;
-                        missing--;
-                        depth_dist[depth]++;
+                    if (load_pruning_value(bfs->table, next_index) == depth) {
+                        worker->filled += claim_pruning_value(bfs->table, i, depth + 1);
+                        break;
                     }
                 }
+
+                continue;
             }
-        }
-        printf("finished depth %2d: %8d %8d\n", depth, depth_dist[depth], (N_EDGE_ORIENTATIONS * N_SLICES) - missing);
 
-        assert(depth <= 12);
-        depth++;
-    }
+            if (value != depth)
+                continue;
 
-    uint64_t end_time = get_microseconds();
+            for (int move_index = 0; move_index < bfs->n_moves; move_index++) {
+                int next_index = get_pruning_bfs_neighbour(bfs, i, move_index);
 
-    printf("elapsed time: %f seconds - ", (float)(end_time - start_time) / 1000000.0);
-    printf("nodes per second : %.2f\n",
-           ((float)(N_EDGE_ORIENTATIONS * N_SLICES) / (end_time - start_time)) * 1000000.0);
-    printf("\n");
+                assert(next_index >= 0 && next_index < bfs->size);
 
-    for (int i = 0; i < N_EDGE_ORIENTATIONS * N_SLICES; i++) {
-        if (pruning_phase1_edge[i] == -1) {
-            printf("phase1 edge pruning is not correctly populated!\n");
-            abort();
+                if (!claim_pruning_value(bfs->table, next_index, depth + 1))
+                    continue;
+
+                worker->filled++;
+
+                if (bfs->fill_symmetric != NULL)
+                    worker->filled += bfs->fill_symmetric(bfs, next_index, depth + 1);
+            }
         }
     }
 
-    pruning_table_cache_store("pruning_tables", "phase1_edge", pruning_phase1_edge, N_EDGE_ORIENTATIONS * N_SLICES);
+    return NULL;
 }
 
-void build_phase1_combined_table() {
-    if (pruning_phase1_combined != NULL)
-        return;
+static int get_pruning_bfs_thread_count() {
+    long n_cores = sysconf(_SC_NPROCESSORS_ONLN);
 
-    if (pruning_table_cache_load("pruning_tables", "phase1_combined", &pruning_phase1_combined,
-                                 N_CORNER_ORIENTATIONS * N_EDGE_ORIENTATIONS))
-        return;
+    if (n_cores < 1)
+        return 1;
 
-    printf("bulding phase1 combined corner/edge orientations pruning table\n");
-
-    uint64_t start_time     = get_microseconds();
-    pruning_phase1_combined = (int *)malloc(sizeof(int) * N_CORNER_ORIENTATIONS * N_EDGE_ORIENTATIONS);
-
-    for (int i = 0; i < N_CORNER_ORIENTATIONS * N_EDGE_ORIENTATIONS; i++)
-        pruning_phase1_combined[i] = -1;
+    return MIN((int)n_cores, PRUNING_BFS_MAX_THREADS);
+}
 
-    pruning_phase1_combined[0] = 0;
+static void run_pruning_bfs(const pruning_bfs_t *bfs) {
+    uint64_t start_time = get_microseconds();
+    int      n_threads  = get_pruning_bfs_thread_count();
 
-    const int *corner_orientations_move_table = get_move_table_corner_orientations();
-    const int *edge_orientations_move_table   = get_move_table_edge_orientations();
+    // The solved cube has coord zero and can be solved in zero moves
+    claim_pruning_value(bfs->table, 0, 0);
 
-    int missing = N_CORNER_ORIENTATIONS * N_EDGE_ORIENTATIONS - 1;
+    int missing = bfs->size - 1;
     int depth   = 0;
 
-    int depth_dist[20] = {0};
+    if (bfs->fill_symmetric != NULL)
+        missing -= bfs->fill_symmetric(bfs, 0, 0);
 
-    while (missing > 0) {
-        for (int i = 0; i < N_CORNER_ORIENTATIONS * N_EDGE_ORIENTATIONS; i++) {
-            if (pruning_phase1_combined[i] != depth)
-                continue;
+    pthread_t            threads[PRUNING_BFS_MAX_THREADS];
+    pruning_bfs_worker_t workers[PRUNING_BFS_MAX_THREADS];
 
-            int corner_orientations = i / N_EDGE_ORIENTATIONS;
-            int edge_orientations   = i % N_EDGE_ORIENTATIONS;
+    while (missing > 0) {
+        // Once more than half of the table is filled most of the frontier expands into known entries, and it
+        // becomes cheaper to look for empty entries that have a neighbour at the current depth.
+        int        backwards  = missing < bfs->size / 2;
+        atomic_int next_chunk = 0;
+
+        for (int i = 0; i < n_threads; i++) {
+            workers[i].bfs        = bfs;
+            workers[i].next_chunk = &next_chunk;
+            workers[i].depth      = depth;
+            workers[i].backwards  = backwards;
+            pthread_create(&threads[i], NULL, pruning_bfs_worker, &workers[i]);
+        }
 
-            for (int move = 0; move < N_MOVES; move++) {
-                int next_corner_orientations = corner_orientations_move_table[corner_orientations * N_MOVES + move];
-                int next_edge_orientations   = edge_orientations_move_table[edge_orientations * N_MOVES + move];
-                int next_index               = next_corner_orientations * N_EDGE_ORIENTATIONS + next_edge_orientations;
+        int filled = 0;
 
-                if (pruning_phase1_combined[next_index] == -1) {
-                    pruning_phase1_combined[next_index] = depth + 1;
-                    missing--;
-                    depth_dist[depth]++;
-                }
-            }
+        for (int i = 0; i < n_threads; i++) {
+            pthread_join(threads[i], NULL);
+            filled += workers[i].filled;
         }
 
-        printf("finished depth %2d: %8d %8d\n", depth, depth_dist[depth],
-               (N_CORNER_ORIENTATIONS * N_EDGE_ORIENTATIONS) - missing);
+        missing -= filled;
 
-        assert(depth <= 13);
+        printf("finished depth %2d: %9d %9d %9d %s\n", depth, filled, bfs->size - missing, missing,
+               backwards ? "backwards" : "forwards");
+
+        assert(depth <= bfs->max_depth);
         depth++;
     }
 
     uint64_t end_time = get_microseconds();
 
     printf("elapsed time: %f seconds - ", (float)(end_time - start_time) / 1000000.0);
-    printf("nodes per second : %.2f\n",
-           ((float)(N_CORNER_ORIENTATIONS * N_EDGE_ORIENTATIONS) / (end_time - start_time)) * 1000000.0);
+    printf("nodes per second : %.2f - threads: %d\n", ((float)bfs->size / (end_time - start_time)) * 1000000.0,
+           n_threads);
     printf("\n");
 
-    for (int i = 0; i < N_CORNER_ORIENTATIONS * N_EDGE_ORIENTATIONS; i++) {
-        if (pruning_phase1_combined[i] == -1) {
-            printf("phase1 combined pruning is not correctly populated!\n");
+    for (int i = 0; i < bfs->size; i++) {
+        if (get_pruning_value(bfs->table, i) == PRUNING_EMPTY) {
+            printf("%s pruning is not correctly populated!\n", bfs->name);
             abort();
         }
     }
-
-    pruning_table_cache_store("pruning_tables", "phase1_combined", pruning_phase1_combined,
-                              N_CORNER_ORIENTATIONS * N_EDGE_ORIENTATIONS);
 }
 
-void build_phase2_UD6_edge_table() {
-    if (pruning_phase2_UD6_edge != NULL)
+void build_phase1_corner_table() {
+    if (pruning_phase1_corner != NULL)
         return;
 
-    if (pruning_table_cache_load("pruning_tables", "phase2_UD6_edge", &pruning_phase2_UD6_edge,
-                                 N_UD6_PHASE2_PERMUTATIONS * N_SORTED_SLICES_PHASE2))
+    cache_layout_t layout = make_pruning_table_layout(N_CORNER_ORIENTATIONS, N_SLICES, phase1_moves, N_MOVES);
+
+    if (pruning_table_cache_load("pruning_tables", "phase1_corner", &layout, (void **)&pruning_phase1_corner))
         return;
 
-    printf("bulding phase2 UD6_edge permutations pruning table\n");
+    printf("bulding phase1 corner orientations pruning table\n");
 
-    uint64_t start_time     = get_microseconds();
-    pruning_phase2_UD6_edge = (int *)malloc(sizeof(int) * N_UD6_PHASE2_PERMUTATIONS * N_SORTED_SLICES_PHASE2);
+    pruning_phase1_corner = make_pruning_table(N_CORNER_ORIENTATIONS * N_SLICES);
 
-    for (int i = 0; i < N_UD6_PHASE2_PERMUTATIONS * N_SORTED_SLICES_PHASE2; i++)
-        pruning_phase2_UD6_edge[i] = -1;
+    pruning_bfs_t bfs = {
+        .name             = "phase1 corner",
+        .table            = pruning_phase1_corner,
+        .size             = N_CORNER_ORIENTATIONS * N_SLICES,
+        .max_depth        = 8,
+        .moves            = phase1_moves,
+        .n_moves          = N_MOVES,
+        .n_minor          = N_SLICES,
+        .row_length       = get_move_table_stride(),
+        .major_move_table = get_move_table_corner_orientations(),
+        .minor_move_table = get_move_table_E_slice(),
+    };
 
-    // The solved phase2 cube has coord zero and can be solved in zero moves
-    pruning_phase2_UD6_edge[0] = 0;
+    run_pruning_bfs(&bfs);
 
-    const int *sorted_slice_move_table          = get_move_table_E_sorted_slice();
-    const int *UD6_edge_permutations_move_table = get_move_table_UD6_edge_permutations();
+    pruning_table_cache_store("pruning_tables", "phase1_corner", &layout, pruning_phase1_corner);
+}
 
-    int missing = N_UD6_PHASE2_PERMUTATIONS * N_SORTED_SLICES_PHASE2 - 1;
-    int depth   = 0;
+void build_phase1_edge_table() {
+    if (pruning_phase1_edge != NULL)
+        return;
 
-    int depth_dist[20] = {0};
+    cache_layout_t layout = make_pruning_table_layout(N_EDGE_ORIENTATIONS, N_SLICES, phase1_moves, N_MOVES);
 
-    move_t moves[] = {MOVE_U1, MOVE_U2, MOVE_U3, MOVE_R2, MOVE_F2, MOVE_D1, MOVE_D2, MOVE_D3, MOVE_L2, MOVE_B2};
-    int    n_moves = 10;
+    if (pruning_table_cache_load("pruning_tables", "phase1_edge", &layout, (void **)&pruning_phase1_edge))
+        return;
 
-    while (missing > 0) {
-        for (int i = 0; i < N_UD6_PHASE2_PERMUTATIONS * N_SORTED_SLICES_PHASE2; i++) {
-            if (pruning_phase2_UD6_edge[i] != depth)
-                continue;
+    printf("bulding phase1 edge orientations pruning table\n");
 
-            int UD6_edge_permutation = i / N_SORTED_SLICES_PHASE2;
-            int sorted_slice         = i % N_SORTED_SLICES_PHASE2;
+    pruning_phase1_edge = make_pruning_table(N_EDGE_ORIENTATIONS * N_SLICES);
 
-            for (int move_index = 0; move_index < n_moves; move_index++) {
-                int move = moves[move_index];
+    pruning_bfs_t bfs = {
+        .name             = "phase1 edge",
+        .table            = pruning_phase1_edge,
+        .size             = N_EDGE_ORIENTATIONS * N_SLICES,
+        .max_depth        = 12,
+        .moves            = phase1_moves,
+        .n_moves          = N_MOVES,
+        .n_minor          = N_SLICES,
+        .row_length       = get_move_table_stride(),
+        .major_move_table = get_move_table_edge_orientations(),
+        .minor_move_table = get_move_table_E_slice(),
+    };
 
-                int next_UD6_edge_permutation = UD6_edge_permutations_move_table[UD6_edge_permutation * N_MOVES + move];
-                int next_sorted_slice         = sorted_slice_move_table[sorted_slice * N_MOVES + move];
+    run_pruning_bfs(&bfs);
 
-                int index = next_UD6_edge_permutation * N_SORTED_SLICES_PHASE2 + next_sorted_slice;
+    pruning_table_cache_store("pruning_tables", "phase1_edge", &layout, pruning_phase1_edge);
+}
 
-                assert(index >= 0);
-                assert(index < N_UD6_PHASE2_PERMUTATIONS * N_SORTED_SLICES_PHASE2);
+void build_phase1_combined_table() {
+    if (pruning_phase1_combined != NULL)
+        return;
 
-                if (pruning_phase2_UD6_edge[index] == -1) {
-                    pruning_phase2_UD6_edge[index] = depth + 1;
+    cache_layout_t layout =
+        make_pruning_table_layout(N_CORNER_ORIENTATIONS, N_EDGE_ORIENTATIONS, phase1_moves, N_MOVES);
 
-                    missing--;
-                    depth_dist[depth]++;
-                }
-            }
-        }
+    if (pruning_table_cache_load("pruning_tables", "phase1_combined", &layout, (void **)&pruning_phase1_combined))
+        return;
 
-        printf("finished depth %2d: %8d %8d %8d\n", depth, depth_dist[depth],
-               (N_UD6_PHASE2_PERMUTATIONS * N_SORTED_SLICES_PHASE2) - missing, missing);
-        assert(depth <= 9);
-        depth++;
-    }
+    printf("bulding phase1 combined corner/edge orientations pruning table\n");
 
-    uint64_t end_time = get_microseconds();
+    pruning_phase1_combined = make_pruning_table(N_CORNER_ORIENTATIONS * N_EDGE_ORIENTATIONS);
 
-    printf("elapsed time: %f seconds - ", (float)(end_time - start_time) / 1000000.0);
-    printf("nodes per second : %.2f\n",
-           ((float)(N_UD6_PHASE2_PERMUTATIONS * N_SORTED_SLICES_PHASE2) / (end_time - start_time)) * 1000000.0);
-    printf("\n");
+    pruning_bfs_t bfs = {
+        .name             = "phase1 combined",
+        .table            = pruning_phase1_combined,
+        .size             = N_CORNER_ORIENTATIONS * N_EDGE_ORIENTATIONS,
+        .max_depth        = 13,
+        .moves            = phase1_moves,
+        .n_moves          = N_MOVES,
+        .n_minor          = N_EDGE_ORIENTATIONS,
+        .row_length       = get_move_table_stride(),
+        .major_move_table = get_move_table_corner_orientations(),
+        .minor_move_table = get_move_table_edge_orientations(),
+    };
 
-    for (int i = 0; i < N_UD6_PHASE2_PERMUTATIONS * N_SORTED_SLICES_PHASE2; i++) {
-        if (pruning_phase2_UD6_edge[i] == -1) {
-            printf("phase2 edge pruning is not correctly populated!\n");
-            abort();
-        }
-    }
+    run_pruning_bfs(&bfs);
 
-    pruning_table_cache_store("pruning_tables", "phase2_UD6_edge", pruning_phase2_UD6_edge,
-                              N_UD6_PHASE2_PERMUTATIONS * N_SORTED_SLICES_PHASE2);
+    pruning_table_cache_store("pruning_tables", "phase1_combined", &layout, pruning_phase1_combined);
 }
 
-void build_phase2_UD7_edge_table() {
-    if (pruning_phase2_UD7_edge != NULL)
-        return;
+static const uint16_t *flipslice_twist_slice_move_table               = NULL;
+static const uint16_t *flipslice_twist_edge_orientations_move_table   = NULL;
+static const uint16_t *flipslice_twist_corner_orientations_move_table = NULL;
+static const uint32_t *flipslice_rep                                  = NULL;
+static const uint16_t *flipslice_self_symmetries                      = NULL;
 
-    if (pruning_table_cache_load("pruning_tables", "phase2_UD7_edge", &pruning_phase2_UD7_edge,
-                                 N_UD7_PHASE2_PERMUTATIONS * N_SORTED_SLICES_PHASE2))
-        return;
+static int get_flipslice_twist_neighbour(const pruning_bfs_t *bfs, int index, move_t move) {
+    (void)bfs;
 
-    printf("bulding phase2 UD7_edge permutations pruning table\n");
+    int classidx            = index / N_CORNER_ORIENTATIONS;
+    int corner_orientations = index % N_CORNER_ORIENTATIONS;
+    int slice               = flipslice_rep[classidx] / N_EDGE_ORIENTATIONS;
+    int edge_orientations   = flipslice_rep[classidx] % N_EDGE_ORIENTATIONS;
 
-    uint64_t start_time     = get_microseconds();
-    pruning_phase2_UD7_edge = (int *)malloc(sizeof(int) * N_UD7_PHASE2_PERMUTATIONS * N_SORTED_SLICES_PHASE2);
+    int stride = get_move_table_stride();
 
-    for (int i = 0; i < N_UD7_PHASE2_PERMUTATIONS * N_SORTED_SLICES_PHASE2; i++)
-        pruning_phase2_UD7_edge[i] = -1;
+    return get_flipslice_twist_index(
+        flipslice_twist_edge_orientations_move_table[edge_orientations * stride + move],
+        flipslice_twist_slice_move_table[slice * stride + move],
+        flipslice_twist_corner_orientations_move_table[corner_orientations * stride + move]);
+}
 
-    // The solved phase2 cube has coord zero and can be solved in zero moves
-    pruning_phase2_UD7_edge[0] = 0;
+// If the class representant is symmetric, the same cube shows up under more than one twist
+static int fill_flipslice_twist_symmetric(const pruning_bfs_t *bfs, int index, int value) {
+    int      classidx   = index / N_CORNER_ORIENTATIONS;
+    int      twist      = index % N_CORNER_ORIENTATIONS;
+    uint16_t symmetries = flipslice_self_symmetries[classidx];
+    int      filled     = 0;
 
-    const int *sorted_slice_move_table          = get_move_table_E_sorted_slice();
-    const int *UD7_edge_permutations_move_table = get_move_table_UD7_edge_permutations();
+    for (int s = 1; s < N_SYMMETRIES_D4H; s++) {
+        if (!(symmetries & (1 << s)))
+            continue;
 
-    int missing = N_UD7_PHASE2_PERMUTATIONS * N_SORTED_SLICES_PHASE2 - 1;
-    int depth   = 0;
+        int symmetric_index = classidx * N_CORNER_ORIENTATIONS + twist_conj[twist * N_SYMMETRIES_D4H + s];
 
-    int depth_dist[20] = {0};
+        filled += claim_pruning_value(bfs->table, symmetric_index, value);
+    }
 
-    move_t moves[] = {MOVE_U1, MOVE_U2, MOVE_U3, MOVE_R2, MOVE_F2, MOVE_D1, MOVE_D2, MOVE_D3, MOVE_L2, MOVE_B2};
-    int    n_moves = 10;
+    return filled;
+}
 
-    while (missing > 0) {
-        for (int i = 0; i < N_UD7_PHASE2_PERMUTATIONS * N_SORTED_SLICES_PHASE2; i++) {
-            if (pruning_phase2_UD7_edge[i] != depth)
-                continue;
+void build_phase1_flipslice_twist_table() {
+    if (pruning_phase1_flipslice_twist != NULL)
+        return;
 
-            int UD7_edge_permutation = i / N_SORTED_SLICES_PHASE2;
-            int sorted_slice         = i % N_SORTED_SLICES_PHASE2;
+    build_symmetry_tables();
 
-            for (int move_index = 0; move_index < n_moves; move_index++) {
-                int move = moves[move_index];
+    const uint16_t *classidx = get_flipslice_classidx_table();
+    const uint8_t  *sym      = get_flipslice_sym_table();
 
-                int next_UD7_edge_permutation = UD7_edge_permutations_move_table[UD7_edge_permutation * N_MOVES + move];
-                int next_sorted_slice         = sorted_slice_move_table[sorted_slice * N_MOVES + move];
+    flipslice_class_sym = (uint32_t *)malloc(sizeof(uint32_t) * N_FLIPSLICE);
+    for (int flipslice = 0; flipslice < N_FLIPSLICE; flipslice++)
+        flipslice_class_sym[flipslice] = classidx[flipslice] * N_SYMMETRIES_D4H + sym[flipslice];
 
-                int index = next_UD7_edge_permutation * N_SORTED_SLICES_PHASE2 + next_sorted_slice;
+    twist_conj = get_twist_conj_table();
 
-                assert(index >= 0);
-                assert(index < N_UD7_PHASE2_PERMUTATIONS * N_SORTED_SLICES_PHASE2);
+    cache_layout_t layout =
+        make_pruning_table_layout(N_FLIPSLICE_CLASSES, N_CORNER_ORIENTATIONS, phase1_moves, N_MOVES);
 
-                if (pruning_phase2_UD7_edge[index] == -1) {
-                    pruning_phase2_UD7_edge[index] = depth + 1;
+    if (pruning_table_cache_load("pruning_tables", "phase1_flipslice_twist", &layout,
+                                 (void **)&pruning_phase1_flipslice_twist))
+        return;
 
-                    missing--;
-                    depth_dist[depth]++;
-                }
-            }
-        }
+    printf("bulding phase1 flipslice/twist symmetry reduced pruning table\n");
 
-        printf("finished depth %2d: %8d %8d %8d\n", depth, depth_dist[depth],
-               (N_UD7_PHASE2_PERMUTATIONS * N_SORTED_SLICES_PHASE2) - missing, missing);
-        assert(depth <= 11);
-        depth++;
-    }
+    pruning_phase1_flipslice_twist = make_pruning_table(N_FLIPSLICE_TWIST);
 
-    uint64_t end_time = get_microseconds();
+    flipslice_twist_slice_move_table               = get_move_table_E_slice();
+    flipslice_twist_edge_orientations_move_table   = get_move_table_edge_orientations();
+    flipslice_twist_corner_orientations_move_table = get_move_table_corner_orientations();
+    flipslice_rep                                  = get_flipslice_rep_table();
+    flipslice_self_symmetries                      = get_flipslice_self_symmetries_table();
 
-    printf("elapsed time: %f seconds - ", (float)(end_time - start_time) / 1000000.0);
-    printf("nodes per second : %.2f\n",
-           ((float)(N_UD7_PHASE2_PERMUTATIONS * N_SORTED_SLICES_PHASE2) / (end_time - start_time)) * 1000000.0);
-    printf("\n");
+    pruning_bfs_t bfs = {
+        .name           = "phase1 flipslice/twist",
+        .table          = pruning_phase1_flipslice_twist,
+        .size           = N_FLIPSLICE_TWIST,
+        .max_depth      = 12,
+        .moves          = phase1_moves,
+        .n_moves        = N_MOVES,
+        .get_neighbour  = get_flipslice_twist_neighbour,
+        .fill_symmetric = fill_flipslice_twist_symmetric,
+    };
 
-    for (int i = 0; i < N_UD7_PHASE2_PERMUTATIONS * N_SORTED_SLICES_PHASE2; i++) {
-        if (pruning_phase2_UD7_edge[i] == -1) {
-            printf("phase2 edge pruning is not correctly populated!\n");
-            abort();
-        }
-    }
+    run_pruning_bfs(&bfs);
 
-    pruning_table_cache_store("pruning_tables", "phase2_UD7_edge", pruning_phase2_UD7_edge,
-                              N_UD7_PHASE2_PERMUTATIONS * N_SORTED_SLICES_PHASE2);
+    pruning_table_cache_store("pruning_tables", "phase1_flipslice_twist", &layout, pruning_phase1_flipslice_twist);
 }
 
-void build_phase2_corner_table() {
-    if (pruning_phase2_corner != NULL)
+void build_phase2_UD6_edge_table() {
+    if (pruning_phase2_UD6_edge != NULL)
         return;
 
-    if (pruning_table_cache_load("pruning_tables", "phase2_corner", &pruning_phase2_corner,
-                                 N_CORNER_PERMUTATIONS * N_SORTED_SLICES_PHASE2))
+    cache_layout_t layout = make_pruning_table_layout(N_UD6_PHASE2_PERMUTATIONS, N_SORTED_SLICES_PHASE2,
+                                                      get_phase2_moves(), N_PHASE2_MOVES);
+
+    if (pruning_table_cache_load("pruning_tables", "phase2_UD6_edge", &layout, (void **)&pruning_phase2_UD6_edge))
         return;
 
-    printf("bulding phase2 corner orientations pruning table\n");
+    printf("bulding phase2 UD6_edge permutations pruning table\n");
 
-    uint64_t start_time   = get_microseconds();
-    pruning_phase2_corner = (int *)malloc(sizeof(int) * N_CORNER_PERMUTATIONS * N_SORTED_SLICES_PHASE2);
+    pruning_phase2_UD6_edge = make_pruning_table(N_UD6_PHASE2_PERMUTATIONS * N_SORTED_SLICES_PHASE2);
 
-    for (int i = 0; i < N_CORNER_PERMUTATIONS * N_SORTED_SLICES_PHASE2; i++)
-        pruning_phase2_corner[i] = -1;
+    pruning_bfs_t bfs = {
+        .name             = "phase2 UD6 edge",
+        .table            = pruning_phase2_UD6_edge,
+        .size             = N_UD6_PHASE2_PERMUTATIONS * N_SORTED_SLICES_PHASE2,
+        .max_depth        = 9,
+        .moves            = get_phase2_moves(),
+        .n_moves          = N_PHASE2_MOVES,
+        .n_minor          = N_SORTED_SLICES_PHASE2,
+        .row_length       = N_PHASE2_MOVES,
+        .major_move_table = get_move_table_phase2_UD6_edge_permutations(),
+        .minor_move_table = get_move_table_phase2_E_sorted_slice(),
+    };
 
-    // The solved phase2 cube has coord zero and can be solved in zero moves
-    pruning_phase2_corner[0] = 0;
+    run_pruning_bfs(&bfs);
 
-    const int *sorted_slice_move_table        = get_move_table_E_sorted_slice();
-    const int *corner_permutations_move_table = get_move_table_corner_permutations();
+    pruning_table_cache_store("pruning_tables", "phase2_UD6_edge", &layout, pruning_phase2_UD6_edge);
+}
 
-    int missing = N_CORNER_PERMUTATIONS * N_SORTED_SLICES_PHASE2 - 1;
-    int depth   = 0;
+void build_phase2_UD7_edge_table() {
+    if (pruning_phase2_UD7_edge != NULL)
+        return;
 
-    int depth_dist[20] = {0};
+    cache_layout_t layout = make_pruning_table_layout(N_UD7_PHASE2_PERMUTATIONS, N_SORTED_SLICES_PHASE2,
+                                                      get_phase2_moves(), N_PHASE2_MOVES);
 
-    move_t moves[] = {MOVE_U1, MOVE_U2, MOVE_U3, MOVE_R2, MOVE_F2, MOVE_D1, MOVE_D2, MOVE_D3, MOVE_L2, MOVE_B2};
-    int    n_moves = 10;
+    if (pruning_table_cache_load("pruning_tables", "phase2_UD7_edge", &layout, (void **)&pruning_phase2_UD7_edge))
+        return;
 
-    while (missing > 0) {
-        for (int i = 0; i < N_CORNER_PERMUTATIONS * N_SORTED_SLICES_PHASE2; i++) {
-            if (pruning_phase2_corner[i] != depth)
-                continue;
+    printf("bulding phase2 UD7_edge permutations pruning table\n");
 
-            int corner_permutation = i / N_SORTED_SLICES_PHASE2;
-            int sorted_slice       = i % N_SORTED_SLICES_PHASE2;
+    pruning_phase2_UD7_edge = make_pruning_table(N_UD7_PHASE2_PERMUTATIONS * N_SORTED_SLICES_PHASE2);
 
-            for (int move_index = 0; move_index < n_moves; move_index++) {
-                int move = moves[move_index];
+    pruning_bfs_t bfs = {
+        .name             = "phase2 UD7 edge",
+        .table            = pruning_phase2_UD7_edge,
+        .size             = N_UD7_PHASE2_PERMUTATIONS * N_SORTED_SLICES_PHASE2,
+        .max_depth        = 11,
+        .moves            = get_phase2_moves(),
+        .n_moves          = N_PHASE2_MOVES,
+        .n_minor          = N_SORTED_SLICES_PHASE2,
+        .row_length       = N_PHASE2_MOVES,
+        .major_move_table = get_move_table_phase2_UD7_edge_permutations(),
+        .minor_move_table = get_move_table_phase2_E_sorted_slice(),
+    };
 
-                int next_corner_permutation = corner_permutations_move_table[corner_permutation * N_MOVES + move];
-                int next_sorted_slice       = sorted_slice_move_table[sorted_slice * N_MOVES + move];
+    run_pruning_bfs(&bfs);
 
-                int index = next_corner_permutation * N_SORTED_SLICES_PHASE2 + next_sorted_slice;
+    pruning_table_cache_store("pruning_tables", "phase2_UD7_edge", &layout, pruning_phase2_UD7_edge);
+}
 
-                assert(index >= 0);
-                assert(index < N_CORNER_PERMUTATIONS * N_SORTED_SLICES_PHASE2);
+void build_phase2_corner_table() {
+    if (pruning_phase2_corner != NULL)
+        return;
 
-                if (pruning_phase2_corner[index] == -1) {
-                    pruning_phase2_corner[index] = depth + 1;
+    cache_layout_t layout =
+        make_pruning_table_layout(N_CORNER_PERMUTATIONS, N_SORTED_SLICES_PHASE2, get_phase2_moves(), N_PHASE2_MOVES);
 
-                    missing--;
-                    depth_dist[depth]++;
-                }
-            }
-        }
+    if (pruning_table_cache_load("pruning_tables", "phase2_corner", &layout, (void **)&pruning_phase2_corner))
+        return;
 
-        printf("finished depth %2d: %8d %8d %8d\n", depth, depth_dist[depth],
-               (N_CORNER_PERMUTATIONS * N_SORTED_SLICES_PHASE2) - missing, missing);
-        assert(depth <= 13);
-        depth++;
-    }
+    printf("bulding phase2 corner orientations pruning table\n");
 
-    uint64_t end_time = get_microseconds();
+    pruning_phase2_corner = make_pruning_table(N_CORNER_PERMUTATIONS * N_SORTED_SLICES_PHASE2);
 
-    printf("elapsed time: %f seconds - ", (float)(end_time - start_time) / 1000000.0);
-    printf("nodes per second : %.2f\n",
-           ((float)(N_CORNER_PERMUTATIONS * N_SORTED_SLICES_PHASE2) / (end_time - start_time)) * 1000000.0);
-    printf("\n");
+    pruning_bfs_t bfs = {
+        .name             = "phase2 corner",
+        .table            = pruning_phase2_corner,
+        .size             = N_CORNER_PERMUTATIONS * N_SORTED_SLICES_PHASE2,
+        .max_depth        = 13,
+        .moves            = get_phase2_moves(),
+        .n_moves          = N_PHASE2_MOVES,
+        .n_minor          = N_SORTED_SLICES_PHASE2,
+        .row_length       = N_PHASE2_MOVES,
+        .major_move_table = get_move_table_phase2_corner_permutations(),
+        .minor_move_table = get_move_table_phase2_E_sorted_slice(),
+    };
 
-    for (int i = 0; i < N_CORNER_PERMUTATIONS * N_SORTED_SLICES_PHASE2; i++) {
-        if (pruning_phase2_corner[i] == -1) {
-            printf("phase2 corner pruning is not correctly populated!\n");
-            abort();
-        }
-    }
+    run_pruning_bfs(&bfs);
 
-    pruning_table_cache_store("pruning_tables", "phase2_corner", pruning_phase2_corner,
-                              N_CORNER_PERMUTATIONS * N_SORTED_SLICES_PHASE2);
+    pruning_table_cache_store("pruning_tables", "phase2_corner", &layout, pruning_phase2_corner);
 }
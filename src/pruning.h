@@ -24,16 +24,42 @@
 #ifndef _PRINING
 #define _PRINING
 
+#include <stdint.h>
+
 #include "coord_cube.h"
+#include "definitions.h"
+
+// Room for one entry per move, rounded up to whole vectors of 8
+#define PHASE1_CHILDREN_STRIDE 24
+
+// The phase1 coords of the children of a cube, one for each move in move order, and their phase1 pruning values
+typedef struct {
+    int32_t edge_orientations[PHASE1_CHILDREN_STRIDE];
+    int32_t corner_orientations[PHASE1_CHILDREN_STRIDE];
+    int32_t E_slice[PHASE1_CHILDREN_STRIDE];
+    int32_t pruning[PHASE1_CHILDREN_STRIDE];
+} phase1_children_t;
 
 void build_pruning_tables();
 void build_phase1_corner_table();
 void build_phase1_edge_table();
 void build_phase1_combined_table();
+void build_phase1_flipslice_twist_table();
 void build_phase2_UD6_edge_table();
 void build_phase2_UD7_edge_table();
 void build_phase2_corner_table();
 int  get_phase1_pruning(const coord_cube_t *cube);
 int  get_phase2_pruning(const coord_cube_t *cube);
 
+// Applies every move to the cube at once. With the projection tables and a CPU with AVX2 the pruning values of
+// all the children are gathered together, so their cache misses overlap instead of waiting on each other.
+void get_phase1_children(const coord_cube_t *cube, phase1_children_t *children);
+
+// Prefetches the pruning entries that get_phase1_children reads for the child of siblings at move, so they are
+// loaded while the search is busy with the siblings before it
+void prefetch_phase1_children(const phase1_children_t *siblings, int move);
+
+// Prefetches the phase2 pruning entries of the cube, ahead of a get_phase2_pruning
+void prefetch_phase2_pruning(const coord_cube_t *cube);
+
 #endif /* end of include guard */
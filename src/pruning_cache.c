@@ -21,59 +21,461 @@
  *
  */
 
+#include <assert.h>
+#include <fcntl.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
+#include <unistd.h>
 
+#include "config.h"
 #include "file_utils.h"
 #include "pruning_cache.h"
 #include "utils.h"
 
-int pruning_table_cache_load(const char *cache_name, const char *table_name, int **pruning_table, int table_size) {
-    char filepath[512];
+/*
+All cached tables live in a single bundle file:
+
+    bundle_header_t, padded to CACHE_BUNDLE_ALIGNMENT
+    table data, each one starting at a multiple of CACHE_BUNDLE_ALIGNMENT
+
+The header holds the index of every table with its layout and a checksum of its data, and is itself
+covered by a checksum. A bundle is always written in full to a temp file which is then renamed over the
+old one, so readers either see the old bundle or the new one, never a partially written file.
+*/
+
+#define CACHE_BUNDLE_MAGIC      0x4e4f52544f425543ull // "CUBOTRON"
+#define CACHE_BUNDLE_VERSION    1
+#define CACHE_BUNDLE_MAX_TABLES 32
+#define CACHE_BUNDLE_ALIGNMENT  4096
+#define CACHE_TABLE_NAME_LENGTH 64
+
+// Vectorized lookups read the tables a 32 bit word at a time, which can go a few bytes past their end. Every
+// table is followed by at least this many bytes of the file, so those reads never go past the end of the mapping.
+#define CACHE_TABLE_PADDING 3
+#define CACHE_LINE_SIZE     64
+
+typedef struct {
+    char     name[CACHE_TABLE_NAME_LENGTH];
+    uint32_t element_bits;
+    uint32_t dims[CACHE_MAX_DIMS];
+    uint32_t move_set;
+    uint32_t padding;
+    uint64_t offset;
+    uint64_t size;
+    uint64_t checksum;
+} bundle_entry_t;
+
+typedef struct {
+    uint64_t       magic;
+    uint32_t       version;
+    uint32_t       n_tables;
+    bundle_entry_t tables[CACHE_BUNDLE_MAX_TABLES];
+    uint64_t       header_checksum;
+} bundle_header_t;
+
+_Static_assert(sizeof(bundle_header_t) <= CACHE_BUNDLE_ALIGNMENT, "bundle header does not fit its page");
+
+typedef struct {
+    uint8_t         *address;
+    size_t           size;
+    bundle_header_t *header;
+    int              n_handed_out;
+    uint32_t         verified; // bit i is set once the checksum of table i was checked
+} bundle_mapping_t;
+
+// The bundle currently on disk, mapped once and shared by every table loaded from it. Mappings of older
+// bundles are kept alive while tables handed out from them are still in use.
+#define MAX_BUNDLE_MAPPINGS 32
+
+static bundle_mapping_t bundle_mappings[MAX_BUNDLE_MAPPINGS];
+static int              n_bundle_mappings = 0;
+static int              current_bundle    = -1;
+
+// Tables stored since the last flush. They are written to a new bundle all at once, so building all the tables
+// from scratch writes the bundle a single time instead of once per table.
+typedef struct {
+    bundle_entry_t entry;
+    const void    *table;
+} pending_table_t;
+
+static pending_table_t pending_tables[CACHE_BUNDLE_MAX_TABLES];
+static int             n_pending_tables = 0;
+
+static uint64_t checksum64(const void *data, size_t size) {
+    const uint8_t *bytes = (const uint8_t *)data;
+    uint64_t       hash  = 0xcbf29ce484222325ull;
+    size_t         i     = 0;
+
+    // FNV-1a, a word at a time so that checking a few hundred MB stays cheap
+    for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+        uint64_t word;
+        memcpy(&word, &bytes[i], sizeof(word));
+        hash = (hash ^ word) * 0x100000001b3ull;
+    }
+
+    for (; i < size; i++)
+        hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+
+    return hash;
+}
+
+static uint64_t header_checksum(const bundle_header_t *header) {
+    return checksum64(header, offsetof(bundle_header_t, header_checksum));
+}
+
+static size_t align_offset(size_t offset) {
+    return (offset + CACHE_BUNDLE_ALIGNMENT - 1) / CACHE_BUNDLE_ALIGNMENT * CACHE_BUNDLE_ALIGNMENT;
+}
+
+size_t cache_layout_bytes(const cache_layout_t *layout) {
+    size_t n_elements = 1;
+
+    for (int i = 0; i < CACHE_MAX_DIMS && layout->dims[i] > 0; i++)
+        n_elements *= layout->dims[i];
+
+    return (n_elements * layout->element_bits + 7) / 8;
+}
+
+uint32_t cache_move_set(const move_t *moves, int n_moves) {
+    uint32_t move_set = 0;
+
+    for (int i = 0; i < n_moves; i++)
+        move_set |= 1u << moves[i];
+
+    return move_set;
+}
+
+static int is_bundle_valid(const bundle_mapping_t *mapping, const char *filepath) {
+    const bundle_header_t *header = mapping->header;
+
+    if (mapping->size < sizeof(bundle_header_t) || header->magic != CACHE_BUNDLE_MAGIC) {
+        printf("table cache %s is not a table bundle. Ignoring it\n", filepath);
+        return 0;
+    }
+
+    if (header->version != CACHE_BUNDLE_VERSION) {
+        printf("table cache %s has version %u, expected %u. Ignoring it\n", filepath, header->version,
+               CACHE_BUNDLE_VERSION);
+        return 0;
+    }
+
+    if (header->n_tables > CACHE_BUNDLE_MAX_TABLES || header->header_checksum != header_checksum(header)) {
+        printf("table cache %s has a corrupt header. Ignoring it\n", filepath);
+        return 0;
+    }
+
+    for (uint32_t i = 0; i < header->n_tables; i++) {
+        if (header->tables[i].offset + header->tables[i].size + CACHE_TABLE_PADDING > mapping->size) {
+            printf("table cache %s is truncated. Ignoring it\n", filepath);
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+static bundle_mapping_t *open_bundle() {
+    if (current_bundle >= 0)
+        return &bundle_mappings[current_bundle];
+
+    const char *filepath  = get_config()->cache_file;
+    struct stat file_stat = {0};
+
+    if (n_bundle_mappings == MAX_BUNDLE_MAPPINGS || stat(filepath, &file_stat) != 0)
+        return NULL;
+
+    int fd = open(filepath, O_RDONLY);
+
+    if (fd < 0)
+        return NULL;
+
+    void *address = mmap(NULL, file_stat.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (address == MAP_FAILED)
+        return NULL;
+
+    bundle_mapping_t mapping = {
+        .address      = (uint8_t *)address,
+        .size         = file_stat.st_size,
+        .header       = (bundle_header_t *)address,
+        .n_handed_out = 0,
+        .verified     = 0,
+    };
+
+    if (!is_bundle_valid(&mapping, filepath)) {
+        munmap(address, mapping.size);
+        return NULL;
+    }
+
+    current_bundle                     = n_bundle_mappings;
+    bundle_mappings[n_bundle_mappings] = mapping;
+    n_bundle_mappings++;
+
+    return &bundle_mappings[current_bundle];
+}
+
+// Drops the current bundle after it was replaced on disk. Its mapping is kept if tables still point into it.
+static void close_bundle() {
+    if (current_bundle < 0)
+        return;
+
+    bundle_mapping_t *mapping = &bundle_mappings[current_bundle];
+    current_bundle            = -1;
+
+    if (mapping->n_handed_out > 0)
+        return;
+
+    munmap(mapping->address, mapping->size);
+    *mapping = bundle_mappings[--n_bundle_mappings];
+}
+
+static const bundle_entry_t *find_entry(const bundle_header_t *header, const char *name) {
+    for (uint32_t i = 0; i < header->n_tables; i++) {
+        if (strncmp(header->tables[i].name, name, CACHE_TABLE_NAME_LENGTH) == 0)
+            return &header->tables[i];
+    }
+
+    return NULL;
+}
+
+static int is_same_layout(const bundle_entry_t *entry, const cache_layout_t *layout) {
+    if (entry->element_bits != (uint32_t)layout->element_bits || entry->move_set != layout->move_set)
+        return 0;
+
+    for (int i = 0; i < CACHE_MAX_DIMS; i++) {
+        if (entry->dims[i] != (uint32_t)layout->dims[i])
+            return 0;
+    }
+
+    return entry->size == cache_layout_bytes(layout);
+}
+
+int pruning_table_cache_load(const char *cache_name, const char *table_name, const cache_layout_t *layout,
+                             void **table) {
+    char name[CACHE_TABLE_NAME_LENGTH];
     // NOLINTNEXTLINE(clang-analyzer-security.insecureAPI.DeprecatedOrUnsafeBufferHandling)
-    snprintf(filepath, sizeof(filepath), "cache/%s/%s", cache_name, table_name);
+    snprintf(name, sizeof(name), "%s/%s", cache_name, table_name);
+
+    bundle_mapping_t *mapping = open_bundle();
+
+    if (mapping == NULL)
+        return 0;
+
+    const bundle_entry_t *entry = find_entry(mapping->header, name);
 
-    if (!file_exists(filepath))
+    if (entry == NULL)
         return 0;
 
-    fflush(stdout);
-    FILE *f = fopen(filepath, "rb");
+    // Written by a build with a different table layout. Treat it as missing so it gets rebuilt and replaced.
+    if (!is_same_layout(entry, layout)) {
+        printf("table cache entry %s has a different layout than expected. Ignoring it\n", name);
+        return 0;
+    }
+
+    const uint8_t *data  = mapping->address + entry->offset;
+    uint32_t       index = entry - mapping->header->tables;
 
-    *pruning_table = (int *)malloc(sizeof(int) * table_size);
+    // Copying a table reads all of it anyway, so checking it costs little on top. A mapped table is only checked
+    // when asked to, since that would read every page of it at startup. Each table is checked once per bundle.
+    int verify = !get_config()->mmap_tables || get_config()->verify_tables;
 
-    size_t n = fread(*pruning_table, sizeof(int), table_size, f);
-    fclose(f);
+    if (verify && !(mapping->verified & (1u << index))) {
+        if (checksum64(data, entry->size) != entry->checksum) {
+            printf("table cache entry %s has a bad checksum. Ignoring it\n", name);
+            return 0;
+        }
+
+        mapping->verified |= 1u << index;
+    }
 
-    if ((int)n != table_size) {
-        printf("pruning cache read error: expected %d entries, got %zu\n", table_size, n);
-        fflush(stdout);
-        abort();
+    if (get_config()->mmap_tables) {
+        mapping->n_handed_out++;
+        *table = (void *)data;
+        return 1;
     }
 
+    // Aligned like the tables that are built, so padded move table rows stay on one cache line each
+    size_t size = (entry->size + CACHE_TABLE_PADDING + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE * CACHE_LINE_SIZE;
+
+    *table = aligned_alloc(CACHE_LINE_SIZE, size);
+    memset(*table, 0, size);
+    memcpy(*table, data, entry->size);
+
     return 1;
 }
 
-void pruning_table_cache_store(const char *cache_name, const char *table_name, const int *pruning_table,
-                               int table_size) {
-    char filepath[512];
-    char cachepath[512];
+static int write_all(int fd, const void *data, size_t size) {
+    const uint8_t *bytes = (const uint8_t *)data;
+
+    while (size > 0) {
+        ssize_t written = write(fd, bytes, size);
+
+        if (written <= 0)
+            return 0;
+
+        bytes += written;
+        size -= written;
+    }
+
+    return 1;
+}
+
+void pruning_table_cache_store(const char *cache_name, const char *table_name, const cache_layout_t *layout,
+                               const void *table) {
+    char name[CACHE_TABLE_NAME_LENGTH];
+    // NOLINTNEXTLINE(clang-analyzer-security.insecureAPI.DeprecatedOrUnsafeBufferHandling)
+    snprintf(name, sizeof(name), "%s/%s", cache_name, table_name);
+
+    // Storing a table again before the flush replaces the pending one
+    int i = 0;
+    while (i < n_pending_tables && strncmp(pending_tables[i].entry.name, name, CACHE_TABLE_NAME_LENGTH) != 0)
+        i++;
+
+    if (i == CACHE_BUNDLE_MAX_TABLES) {
+        printf("too many tables to cache, not storing %s\n", name);
+        return;
+    }
+
+    bundle_entry_t *entry = &pending_tables[i].entry;
+    // NOLINTNEXTLINE(clang-analyzer-security.insecureAPI.DeprecatedOrUnsafeBufferHandling)
+    snprintf(entry->name, sizeof(entry->name), "%s", name);
+    entry->element_bits = layout->element_bits;
+    entry->move_set     = layout->move_set;
+    entry->size         = cache_layout_bytes(layout);
+
+    for (int j = 0; j < CACHE_MAX_DIMS; j++)
+        entry->dims[j] = layout->dims[j];
+
+    pending_tables[i].table = table;
+
+    if (i == n_pending_tables)
+        n_pending_tables++;
+}
+
+void pruning_table_cache_flush() {
+    if (n_pending_tables == 0)
+        return;
+
+    const char *filepath = get_config()->cache_file;
+    char        temppath[512];
+    char        cachepath[512];
 
     // NOLINTNEXTLINE(clang-analyzer-security.insecureAPI.DeprecatedOrUnsafeBufferHandling)
-    snprintf(filepath, sizeof(filepath), "cache/%s/%s", cache_name, table_name);
+    snprintf(temppath, sizeof(temppath), "%s.tmp.%d", filepath, (int)getpid());
     // NOLINTNEXTLINE(clang-analyzer-security.insecureAPI.DeprecatedOrUnsafeBufferHandling)
-    snprintf(cachepath, sizeof(cachepath), "cache/%s", cache_name);
+    snprintf(cachepath, sizeof(cachepath), "%s", filepath);
+
+    char *last_slash = strrchr(cachepath, '/');
+    if (last_slash != NULL) {
+        *last_slash = '\0';
+        ensure_directory_exists(cachepath);
+    }
+
+    uint64_t start_time = get_microseconds();
+
+    // The new bundle keeps every table from the current one, except older copies of the pending ones
+    bundle_mapping_t *old_mapping = open_bundle();
+    bundle_header_t  *header      = (bundle_header_t *)calloc(1, sizeof(bundle_header_t));
+    const void       *sources[CACHE_BUNDLE_MAX_TABLES];
+
+    if (old_mapping != NULL) {
+        for (uint32_t i = 0; i < old_mapping->header->n_tables; i++) {
+            const bundle_entry_t *old_entry = &old_mapping->header->tables[i];
+            int                   replaced  = 0;
+
+            for (int j = 0; j < n_pending_tables; j++)
+                replaced |= strncmp(old_entry->name, pending_tables[j].entry.name, CACHE_TABLE_NAME_LENGTH) == 0;
+
+            if (replaced || header->n_tables == (uint32_t)(CACHE_BUNDLE_MAX_TABLES - n_pending_tables))
+                continue;
+
+            sources[header->n_tables]          = old_mapping->address + old_entry->offset;
+            header->tables[header->n_tables++] = *old_entry;
+        }
+    }
+
+    for (int i = 0; i < n_pending_tables; i++) {
+        bundle_entry_t *entry = &header->tables[header->n_tables];
+
+        *entry                    = pending_tables[i].entry;
+        entry->checksum           = checksum64(pending_tables[i].table, entry->size);
+        sources[header->n_tables] = pending_tables[i].table;
+        header->n_tables++;
+    }
+
+    size_t offset = CACHE_BUNDLE_ALIGNMENT;
+    for (uint32_t i = 0; i < header->n_tables; i++) {
+        header->tables[i].offset = offset;
+        offset                   = align_offset(offset + header->tables[i].size + CACHE_TABLE_PADDING);
+    }
+
+    header->magic           = CACHE_BUNDLE_MAGIC;
+    header->version         = CACHE_BUNDLE_VERSION;
+    header->header_checksum = header_checksum(header);
+
+    int fd = open(temppath, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    int ok = fd >= 0 && write_all(fd, header, sizeof(bundle_header_t));
+
+    for (uint32_t i = 0; ok && i < header->n_tables; i++)
+        ok = lseek(fd, header->tables[i].offset, SEEK_SET) >= 0 && write_all(fd, sources[i], header->tables[i].size);
 
-    uint32_t start_time = get_microseconds();
-    ensure_directory_exists(cachepath);
+    // Extend the file past the padding of the last table, to the end of its page
+    ok = ok && ftruncate(fd, offset) == 0;
 
-    FILE  *f                = fopen(filepath, "wb");
-    size_t elements_written = fwrite(pruning_table, sizeof(int), table_size, f);
-    fclose(f);
+    if (fd >= 0)
+        close(fd);
 
-    uint32_t bytes_written = (uint32_t)(elements_written * sizeof(int));
-    uint32_t end_time      = get_microseconds();
-    printf("storing: %-45s %10u bytes stored in %6.4f seconds\n", filepath, bytes_written,
+    n_pending_tables = 0;
+
+    if (!ok || rename(temppath, filepath) != 0) {
+        printf("failed to write table cache %s\n", filepath);
+        remove(temppath);
+        free(header);
+        return;
+    }
+
+    close_bundle();
+
+    uint64_t end_time = get_microseconds();
+    printf("storing: %-45s %10llu bytes stored in %6.4f seconds\n", filepath, (unsigned long long)offset,
            (float)(end_time - start_time) / 1000000.0);
+
+    free(header);
+}
+
+void pruning_table_cache_release(void *table) {
+    if (table == NULL)
+        return;
+
+    for (int i = 0; i < n_bundle_mappings; i++) {
+        bundle_mapping_t *mapping = &bundle_mappings[i];
+
+        if ((uint8_t *)table < mapping->address || (uint8_t *)table >= mapping->address + mapping->size)
+            continue;
+
+        mapping->n_handed_out--;
+
+        if (mapping->n_handed_out == 0 && i != current_bundle) {
+            munmap(mapping->address, mapping->size);
+            *mapping = bundle_mappings[--n_bundle_mappings];
+
+            if (current_bundle == n_bundle_mappings)
+                current_bundle = i;
+        }
+
+        return;
+    }
+
+    free(table);
+}
+
+void pruning_table_cache_clear() {
+    n_pending_tables = 0;
+    close_bundle();
+    remove(get_config()->cache_file);
 }
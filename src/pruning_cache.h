@@ -24,8 +24,35 @@
 #ifndef _PRUNING_CACHE
 #define _PRUNING_CACHE
 
-int  pruning_table_cache_load(const char *cache_name, const char *table_name, int **pruning_table, int table_size);
-void pruning_table_cache_store(const char *cache_name, const char *table_name, const int *pruning_table,
-                               int table_size);
+#include <stddef.h>
+#include <stdint.h>
+
+#include "puzzle_types.h"
+
+#define CACHE_MAX_DIMS     3
+#define CACHE_MOVE_SET_ALL ((1u << N_MOVES) - 1)
+
+// How a cached table is laid out. A cached table is only used if it was stored with the exact same
+// layout, so changing the shape or move set of a table makes it get rebuilt instead of misread.
+typedef struct {
+    int      element_bits;         // 32 for int tables, 4 for the nibble packed pruning tables
+    int      dims[CACHE_MAX_DIMS]; // unused trailing dimensions are 0
+    uint32_t move_set;             // bitmask of the moves the table was built with
+} cache_layout_t;
+
+size_t   cache_layout_bytes(const cache_layout_t *layout);
+uint32_t cache_move_set(const move_t *moves, int n_moves);
+
+// Tables returned by load may be a read only mapping of the cache bundle (see config_t.mmap_tables), so
+// they must never be written to, and have to be released with pruning_table_cache_release instead of free.
+int pruning_table_cache_load(const char *cache_name, const char *table_name, const cache_layout_t *layout,
+                             void **table);
+
+// Stored tables are only written to the bundle by pruning_table_cache_flush, so they have to stay alive until then
+void pruning_table_cache_store(const char *cache_name, const char *table_name, const cache_layout_t *layout,
+                               const void *table);
+void pruning_table_cache_flush();
+void pruning_table_cache_release(void *table);
+void pruning_table_cache_clear();
 
 #endif /* end of include guard */
@@ -53,6 +53,9 @@ static void apply_move(void *state, move_t move) { cubie_apply_move((cube_cubie_
 static void copy(void *dst, const void *src) { memcpy(dst, src, sizeof(cube_cubie_t)); }
 
 static int from_string(void *state, const char *str) {
+    if (!are_facelets_solvable(str))
+        return 0;
+
     cube_cubie_t *tmp = build_cubie_cube_from_str((char *)str);
     memcpy(state, tmp, sizeof(cube_cubie_t));
     free(tmp);
@@ -69,6 +72,10 @@ static void to_string(const void *state, char *buf, size_t bufsz) {
     extern color_t   corner_colors[N_CORNERS][3];
     extern color_t   edge_colors[N_EDGES][2];
 
+    // Centers never move, the middle facelet of each face has its color
+    for (color_t color = U; color <= B; color++)
+        facelet_cube[color * 9 + 4] = color;
+
     for (int i = 0; i < N_CORNERS; i++) {
         int corner = cube->corner_permutations[i];
         int orient = cube->corner_orientations[i];
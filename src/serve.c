@@ -0,0 +1,281 @@
+/*
+ * Copyright <2026> <Renan S Silva, aka h3nnn4n>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "config.h"
+#include "puzzle.h"
+#include "serve.h"
+#include "solution.h"
+#include "solve.h"
+#include "solver.h"
+#include "utils.h"
+
+#define SERVE_DELIMITERS " \t\r\n"
+
+static const char *parse_serve_int(const char *value, int min, int max, int *result) {
+    char *end;
+    long  n = strtol(value, &end, 10);
+
+    if (*value == '\0' || *end != '\0' || n < min || n > max)
+        return "invalid number";
+
+    *result = (int)n;
+
+    return NULL;
+}
+
+static const char *parse_serve_seconds(const char *value, float *result) {
+    char *end;
+    float seconds = strtof(value, &end);
+
+    if (*value == '\0' || *end != '\0' || !(seconds >= 0))
+        return "invalid timeout";
+
+    *result = seconds;
+
+    return NULL;
+}
+
+static const char *parse_serve_scramble(const char *moves_str, move_t **scramble) {
+    size_t  max_moves = strlen(moves_str) + 1;
+    move_t *moves     = (move_t *)malloc(sizeof(move_t) * max_moves);
+    char   *copy      = strdup(moves_str);
+    char   *saveptr   = NULL;
+    size_t  n_moves   = 0;
+
+    for (char *token = strtok_r(copy, SERVE_DELIMITERS, &saveptr); token != NULL;
+         token       = strtok_r(NULL, SERVE_DELIMITERS, &saveptr)) {
+        move_t move = str_to_move(token);
+
+        if (move == MOVE_NULL) {
+            free(copy);
+            free(moves);
+            return "invalid move in scramble";
+        }
+
+        moves[n_moves++] = move;
+    }
+
+    moves[n_moves] = MOVE_NULL;
+    free(copy);
+
+    *scramble = moves;
+
+    return NULL;
+}
+
+const char *parse_serve_request(char *line, serve_request_t *request) {
+    const config_t *config = get_config();
+
+    request->puzzle_type   = config->puzzle_type;
+    request->facelets      = NULL;
+    request->scramble      = NULL;
+    request->max_depth     = config->max_depth;
+    request->n_solutions   = config->n_solutions;
+    request->timeout       = config->timeout;
+    request->target_length = config->target_length;
+
+    // The scramble has spaces between its moves, so it is split off before tokenizing the rest of the line
+    char *scramble = strstr(line, "scramble=");
+
+    if (scramble != NULL) {
+        *scramble = '\0';
+        scramble += strlen("scramble=");
+    }
+
+    const char *error   = NULL;
+    char       *saveptr = NULL;
+
+    for (char *token = strtok_r(line, SERVE_DELIMITERS, &saveptr); token != NULL && error == NULL;
+         token       = strtok_r(NULL, SERVE_DELIMITERS, &saveptr)) {
+        if (strncmp(token, "puzzle=", 7) == 0) {
+            request->puzzle_type = token + 7;
+        } else if (strncmp(token, "max-depth=", 10) == 0) {
+            error = parse_serve_int(token + 10, 1, MAX_MOVES - 1, &request->max_depth);
+        } else if (strncmp(token, "n-solutions=", 12) == 0) {
+            error = parse_serve_int(token + 12, -1, MAX_MOVES * N_MOVES, &request->n_solutions);
+        } else if (strncmp(token, "timeout=", 8) == 0) {
+            error = parse_serve_seconds(token + 8, &request->timeout);
+        } else if (strncmp(token, "target-length=", 14) == 0) {
+            error = parse_serve_int(token + 14, 0, MAX_MOVES - 1, &request->target_length);
+        } else if (strchr(token, '=') != NULL) {
+            error = "unknown field";
+        } else if (request->facelets == NULL) {
+            request->facelets = token;
+        } else {
+            error = "more than one cube";
+        }
+    }
+
+    if (error == NULL && scramble != NULL) {
+        if (request->facelets != NULL)
+            error = "both facelets and scramble given";
+        else
+            error = parse_serve_scramble(scramble, &request->scramble);
+    }
+
+    if (error == NULL && request->facelets == NULL && request->scramble == NULL)
+        error = "missing cube";
+
+    return error;
+}
+
+void free_serve_request(serve_request_t *request) {
+    free(request->scramble);
+    request->scramble = NULL;
+}
+
+// The facelets must have exactly as many stickers of each color as the solved puzzle, and be a state the puzzle
+// accepts, which for the 3x3 means one that can be solved. The puzzle is left in that state.
+int are_serve_facelets_valid(const puzzle_t *puzzle, const char *facelets) {
+    char solved[256];
+    int  counts[256] = {0};
+
+    puzzle->ops->reset(puzzle->state);
+    puzzle->ops->to_string(puzzle->state, solved, sizeof(solved));
+
+    if (strlen(facelets) != strlen(solved))
+        return 0;
+
+    for (size_t i = 0; solved[i] != '\0'; i++) {
+        counts[(unsigned char)solved[i]]++;
+        counts[(unsigned char)facelets[i]]--;
+    }
+
+    for (int i = 0; i < 256; i++) {
+        if (counts[i] != 0)
+            return 0;
+    }
+
+    return puzzle->ops->from_string(puzzle->state, facelets);
+}
+
+static void write_serve_solution(const uint8_t *solution, FILE *out) {
+    int length = 0;
+    while (solution[length] != MOVE_NULL)
+        length++;
+
+    fprintf(out, "%d", length);
+
+    for (int i = 0; i < length; i++) {
+        // Move names are padded to two characters
+        const char *move_str = move_to_str(solution[i]);
+        fprintf(out, " %.*s", (int)strcspn(move_str, " "), move_str);
+    }
+}
+
+void write_serve_answer(const solve_list_t *solves, FILE *out) {
+    if (solves == NULL || solves->solution == NULL) {
+        fprintf(out, "error no solution found\n");
+        return;
+    }
+
+    fprintf(out, "ok ");
+
+    for (const solve_list_t *current = solves; current != NULL && current->solution != NULL;
+         current                     = current->next) {
+        if (current != solves)
+            fprintf(out, " | ");
+
+        write_serve_solution(current->solution, out);
+    }
+
+    fprintf(out, "\n");
+}
+
+void serve_request(const serve_request_t *request, FILE *out) {
+    puzzle_t *puzzle = puzzle_create(request->puzzle_type);
+
+    if (puzzle == NULL || solver_lookup(request->puzzle_type) == NULL) {
+        fprintf(out, "error unknown puzzle\n");
+
+        if (puzzle != NULL)
+            puzzle_destroy(puzzle);
+
+        return;
+    }
+
+    char facelets[256];
+
+    if (request->scramble != NULL) {
+        puzzle->ops->reset(puzzle->state);
+
+        for (int i = 0; request->scramble[i] != MOVE_NULL; i++)
+            puzzle->ops->apply_move(puzzle->state, request->scramble[i]);
+
+        puzzle->ops->to_string(puzzle->state, facelets, sizeof(facelets));
+    } else if (are_serve_facelets_valid(puzzle, request->facelets)) {
+        snprintf(facelets, sizeof(facelets), "%s", request->facelets);
+    } else {
+        fprintf(out, "error invalid facelets\n");
+        puzzle_destroy(puzzle);
+        return;
+    }
+
+    puzzle_destroy(puzzle);
+
+    solve_request_t solve_request;
+    init_solve_request(&solve_request, get_config());
+    solve_request.max_depth     = request->max_depth;
+    solve_request.n_solutions   = request->n_solutions;
+    solve_request.target_length = request->target_length;
+    set_solve_request_timeout(&solve_request, request->timeout);
+
+    solve_list_t *solves = solve_puzzle_with_request(request->puzzle_type, facelets, get_config(), &solve_request);
+
+    write_serve_answer(solves, out);
+    destroy_solve_list(solves);
+}
+
+void run_serve(FILE *in, FILE *out) {
+    char  *line      = NULL;
+    size_t line_size = 0;
+
+    // Loads the tables of every solver upfront, so no request pays for it
+    init_registry();
+    for (int i = 0; i < solver_count(); i++)
+        solver_by_index(i)->init();
+
+    while (getline(&line, &line_size, in) != -1) {
+        // Blank lines and comments are skipped without an answer
+        size_t start = strspn(line, SERVE_DELIMITERS);
+        if (line[start] == '\0' || line[start] == '#')
+            continue;
+
+        serve_request_t request;
+        const char     *error = parse_serve_request(line, &request);
+
+        if (error != NULL) {
+            fprintf(out, "error %s\n", error);
+        } else {
+            serve_request(&request, out);
+        }
+
+        free_serve_request(&request);
+        fflush(out);
+    }
+
+    free(line);
+}
@@ -0,0 +1,61 @@
+/*
+ * Copyright <2026> <Renan S Silva, aka h3nnn4n>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef _SERVE
+#define _SERVE
+
+#include <stdio.h>
+
+#include "definitions.h"
+#include "puzzle.h"
+#include "solution.h"
+
+// A single line of the --serve protocol. The fields point into the parsed line, except for the scramble.
+typedef struct {
+    const char *puzzle_type;
+    const char *facelets;
+    move_t     *scramble;
+    int         max_depth;
+    int         n_solutions;
+    float       timeout;
+    int         target_length;
+} serve_request_t;
+
+// Parses "[puzzle=<name>] [max-depth=<n>] [n-solutions=<n>] [timeout=<seconds>] [target-length=<n>]
+// (<facelets> | scramble=<moves>)". The scramble takes the rest of the line. Unset fields default to the global config. Returns NULL on success, or an
+// error message otherwise. The line is modified in place.
+const char *parse_serve_request(char *line, serve_request_t *request);
+void        free_serve_request(serve_request_t *request);
+
+// Writes the result of a request as a single "ok ..." or "error ..." line
+void serve_request(const serve_request_t *request, FILE *out);
+void write_serve_answer(const solve_list_t *solves, FILE *out);
+
+// Whether the facelets have exactly as many stickers of each color as the solved puzzle and are a state the
+// puzzle can be solved from. On success the puzzle is set to that state.
+int are_serve_facelets_valid(const puzzle_t *puzzle, const char *facelets);
+
+// Answers one request per input line until EOF, flushing after every answer
+void run_serve(FILE *in, FILE *out);
+
+#endif /* end of include guard */
@@ -24,28 +24,45 @@
 #ifndef _SOLUTION
 #define _SOLUTION
 
+#include <stdint.h>
+
 #include "puzzle_types.h"
+#include "solve_arena.h"
 #include "stats.h"
 
+// Room for the moves of any solution and the MOVE_NULL that ends them
+#define SOLUTION_CAPACITY 32
+
 typedef struct solve_list_s solve_list_t;
 
+// The solutions are one byte per move, ended by MOVE_NULL, and NULL when missing. The nodes, their solutions and
+// their stats all live in the arena of the list.
 typedef struct solve_list_s {
     solve_list_t *next;
 
-    move_t *phase1_solution;
-    move_t *phase2_solution;
-    move_t *solution;
+    uint8_t *phase1_solution;
+    uint8_t *phase2_solution;
+    uint8_t *solution;
 
     solve_stats_t     *stats;
     aggregate_stats_t *aggregate;
+    solve_arena_t     *arena;
 } solve_list_t;
 
-solve_list_t *new_solve_list_node();
-void          destroy_solve_list_node(solve_list_t *node);
-void          destroy_solve_list(solve_list_t *solves);
+solve_list_t *new_solve_list_node(solve_arena_t *arena);
+
+// Returns room for a solution of up to SOLUTION_CAPACITY - 1 moves, holding none yet
+uint8_t *new_solution(solve_arena_t *arena);
 
-int  are_solutions_equal(const move_t *a, const move_t *b);
-int  is_duplicate_solution(solve_list_t *solves_head, const move_t *solution);
+// Frees the arena of the list, and so every node that came from it
+void destroy_solve_list(solve_list_t *solves);
+
+int  get_solution_length(const uint8_t *solution);
+int  are_solutions_equal(const uint8_t *a, const uint8_t *b);
+int  is_duplicate_solution(solve_list_t *solves_head, const uint8_t *solution);
 void truncate_solutions(solve_list_t *solves, int n_solutions);
 
+// Sorts a list where every node has a solution, shortest first, and returns its new head
+solve_list_t *sort_solutions_by_length(solve_list_t *solves);
+
 #endif /* end of include guard */
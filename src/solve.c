@@ -23,69 +23,44 @@
 
 #include <assert.h>
 #include <pthread.h>
+#include <sched.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "config.h"
 #include "coord_move_tables.h"
 #include "cubie_cube.h"
 #include "facelets.h"
+#include "phase2_cache.h"
+#include "phase2_queue.h"
 #include "pruning.h"
 #include "solve.h"
+#include "solve_arena.h"
 #include "stats.h"
+#include "symmetry.h"
+#include "thread_pool.h"
 #include "utils.h"
 
-solve_list_t *new_solve_list_node() {
-    solve_list_t *node = (solve_list_t *)malloc(sizeof(solve_list_t));
+solve_list_t *new_solve_list_node(solve_arena_t *arena) {
+    solve_list_t *node = (solve_list_t *)solve_arena_alloc(arena, sizeof(solve_list_t));
 
-    node->next            = NULL;
-    node->stats           = NULL;
-    node->aggregate       = NULL;
-    node->phase1_solution = NULL;
-    node->phase2_solution = NULL;
-    node->solution        = NULL;
+    node->arena = arena;
 
     return node;
 }
 
-void destroy_solve_list_node(solve_list_t *node) {
-    if (node->phase1_solution != NULL) {
-        free(node->phase1_solution);
-        node->phase1_solution = NULL;
-    }
-
-    if (node->phase2_solution != NULL) {
-        free(node->phase2_solution);
-        node->phase2_solution = NULL;
-    }
-
-    if (node->solution != NULL) {
-        free(node->solution);
-        node->solution = NULL;
-    }
-
-    free(node->aggregate);
-    node->aggregate = NULL;
+uint8_t *new_solution(solve_arena_t *arena) {
+    uint8_t *solution = (uint8_t *)solve_arena_alloc(arena, SOLUTION_CAPACITY);
+    solution[0]       = MOVE_NULL;
 
-    free(node);
+    return solution;
 }
 
 void destroy_solve_list(solve_list_t *solves) {
-    const solve_stats_t *prev_stats = NULL;
-
-    while (solves != NULL) {
-        solve_list_t *next = solves->next;
-
-        if (solves->stats != NULL && solves->stats != prev_stats) {
-            prev_stats = solves->stats;
-            free(solves->stats);
-            solves->stats = NULL;
-        }
-
-        destroy_solve_list_node(solves);
-        solves = next;
-    }
+    if (solves != NULL)
+        destroy_solve_arena(solves->arena);
 }
 
 solve_list_t *solve_facelets_single(char facelets[N_FACELETS]) {
@@ -112,48 +87,61 @@ solve_list_t *solve_single(const coord_cube_t *original_cube) {
 }
 
 static solve_list_t *make_trivial_solution() {
-    solve_list_t *solves       = new_solve_list_node();
-    solves->solution           = malloc(sizeof(move_t));
-    solves->solution[0]        = MOVE_NULL;
-    solves->phase1_solution    = malloc(sizeof(move_t));
-    solves->phase1_solution[0] = MOVE_NULL;
-    solves->phase2_solution    = malloc(sizeof(move_t));
-    solves->phase2_solution[0] = MOVE_NULL;
-
-    solve_stats_t *stats     = get_solve_stats();
-    stats->phase1_depth      = 0;
-    stats->phase2_depth      = 0;
-    stats->solution_length   = 0;
-    stats->phase1_solve_time = 0.0f;
-    stats->total_phase2_time = 0.0f;
-    stats->wall_time         = 0.0f;
-    stats->phase1_move_count = 0;
-    stats->phase2_move_count = 0;
-    stats->total_moves       = 0;
-    solves->stats            = stats;
+    solve_arena_t *arena = make_solve_arena();
+
+    solve_list_t *solves    = new_solve_list_node(arena);
+    solves->solution        = new_solution(arena);
+    solves->phase1_solution = new_solution(arena);
+    solves->phase2_solution = new_solution(arena);
+    solves->stats           = new_solve_stats(arena);
 
     return solves;
 }
 
 #define MAX_SOLUTION_LENGTHS 1024
 
+// Room for the phase1 solutions waiting for a phase2 worker, the phase1 workers run phase2 themselves when full
+#define PHASE2_QUEUE_CAPACITY 1024
+
+_Static_assert(MAX_MOVES <= PHASE2_QUEUE_MAX_MOVES, "phase2 candidates cannot hold phase1 solutions this long");
+
+_Static_assert(MAX_MOVES <= MAX_REQUEST_SOLUTION_LENGTH, "solve requests cannot count solutions this long");
+
+_Static_assert(MAX_MOVES < SOLUTION_CAPACITY, "solutions cannot hold this many moves");
+
+// Keeps the first copy of every solution. The others stay in the arena until the list is destroyed.
+static void remove_duplicate_solutions(solve_list_t *solves) {
+    for (solve_list_t *node = solves; node != NULL; node = node->next) {
+        solve_list_t *prev = node;
+
+        while (prev->next != NULL) {
+            solve_list_t *other = prev->next;
+
+            if (are_solutions_equal(node->solution, other->solution)) {
+                prev->next = other->next;
+            } else {
+                prev = other;
+            }
+        }
+    }
+}
+
 static solve_list_t *collect_results(thread_context_t *thread_contexts, int thread_count,
-                                     solve_stats_t **all_thread_stats, int *is_winner, int *all_lengths,
-                                     int *n_lengths) {
+                                     solve_stats_t **all_thread_stats, int *all_lengths, int *n_lengths) {
     solve_list_t *solves  = NULL;
     solve_list_t *current = NULL;
 
     for (int i = 0; i < thread_count; i++) {
         all_thread_stats[i] = thread_contexts[i].stats;
-        is_winner[i]        = 0;
     }
 
     for (int i = 0; i < thread_count; i++) {
         solve_list_t *thread_solves = thread_contexts[i].solves;
         if (thread_solves->solution != NULL) {
-            is_winner[i]       = 1;
             solve_list_t *node = thread_solves;
             while (node != NULL && node->solution != NULL) {
+                node->stats = thread_contexts[i].stats;
+
                 int len = 0;
                 while (node->solution[len] != MOVE_NULL)
                     len++;
@@ -171,16 +159,45 @@ static solve_list_t *collect_results(thread_context_t *thread_contexts, int thre
                 }
                 node = next;
             }
-            if (node != NULL) {
-                destroy_solve_list_node(node);
-            }
+        }
+    }
+
+    return sort_solutions_by_length(solves);
+}
+
+// Stable merge sort, so solutions of the same length keep the order in which the threads found them
+solve_list_t *sort_solutions_by_length(solve_list_t *solves) {
+    if (solves == NULL || solves->next == NULL)
+        return solves;
+
+    solve_list_t *middle = solves;
+    for (solve_list_t *fast = solves->next; fast != NULL && fast->next != NULL; fast = fast->next->next)
+        middle = middle->next;
+
+    solve_list_t *left  = solves;
+    solve_list_t *right = middle->next;
+    middle->next        = NULL;
+
+    left  = sort_solutions_by_length(left);
+    right = sort_solutions_by_length(right);
+
+    solve_list_t  head;
+    solve_list_t *tail = &head;
+
+    while (left != NULL && right != NULL) {
+        if (get_solution_length(right->solution) < get_solution_length(left->solution)) {
+            tail->next = right;
+            right      = right->next;
         } else {
-            thread_solves->stats = NULL;
-            destroy_solve_list(thread_solves);
+            tail->next = left;
+            left       = left->next;
         }
+        tail = tail->next;
     }
 
-    return solves;
+    tail->next = left != NULL ? left : right;
+
+    return head.next;
 }
 
 void truncate_solutions(solve_list_t *solves, int n_solutions) {
@@ -189,80 +206,315 @@ void truncate_solutions(solve_list_t *solves, int n_solutions) {
     while (cur != NULL && cur->solution != NULL) {
         n++;
         if (n == n_solutions) {
-            solve_list_t *tail = cur->next;
-            cur->next          = NULL;
-            while (tail != NULL) {
-                solve_list_t *next = tail->next;
-                tail->stats        = NULL;
-                destroy_solve_list_node(tail);
-                tail = next;
-            }
+            cur->next = NULL;
             break;
         }
         cur = cur->next;
     }
 }
 
-solve_list_t *solve(const coord_cube_t *original_cube, const config_t *config) {
-    if (is_coord_solved(original_cube)) {
-        return make_trivial_solution();
+// Phase1 is split into tasks that each search the phase1 solutions of one length under one prefix of
+// PHASE1_PREFIX_LENGTH moves. Tasks are ordered by length, so the shorter phase1 solutions are still tried first
+// no matter how many workers there are, and are handed out in order through a shared counter. Lengths up to
+// the prefix length are searched by a single task each without a prefix. With more than one view of the cube,
+// the tasks of every view are interleaved at each length.
+#define MAX_PHASE1_PREFIXES (N_MOVES * N_MOVES)
+
+typedef struct {
+    move_t       moves[PHASE1_PREFIX_LENGTH];
+    coord_cube_t cubes[PHASE1_PREFIX_LENGTH];
+    int          pruning;
+} phase1_prefix_t;
+
+struct phase1_scheduler_s {
+    solve_view_t    views[MAX_SOLVE_VIEWS];
+    phase1_prefix_t prefixes[MAX_SOLVE_VIEWS][MAX_PHASE1_PREFIXES];
+    int             n_views;
+    int             n_prefixes;
+    int             n_short_tasks;
+    int             n_tasks;
+    atomic_int      next_task;
+};
+
+// Every view has the same prefixes, since they only depend on the move black list
+static void add_phase1_prefixes(phase1_scheduler_t *scheduler, int view, phase1_prefix_t *prefix,
+                                const coord_cube_t *cube, int length) {
+    const config_t *config = get_config();
+
+    if (length == PHASE1_PREFIX_LENGTH) {
+        prefix->pruning = get_phase1_pruning(&prefix->cubes[length - 1]);
+        scheduler->prefixes[view][scheduler->n_prefixes++] = *prefix;
+        return;
     }
 
-    get_config()->die = false;
-    atomic_store(&get_config()->solutions_found, 0);
+    for (move_t move = 0; move < N_MOVES; move++) {
+        if (config->move_black_list[move] != MOVE_NULL)
+            continue;
 
-    const int        thread_count = config->thread_count;
-    thread_context_t thread_contexts[thread_count];
-    move_t           move_list[thread_count];
+        if (length > 0 && is_duplicated_or_undoes_move(move, prefix->moves[length - 1]))
+            continue;
 
-    for (int i = 0; i < thread_count; i++) {
-        move_list[i] = MOVE_NULL;
+        prefix->moves[length] = move;
+        copy_coord_cube(&prefix->cubes[length], cube);
+        coord_apply_move_phase1(&prefix->cubes[length], move);
+
+        add_phase1_prefixes(scheduler, view, prefix, &prefix->cubes[length], length + 1);
     }
+}
 
-    for (int i = 0; i < thread_count; i++) {
-        thread_contexts[i].solve_context = make_solve_context(original_cube);
-        thread_contexts[i].solves        = new_solve_list_node();
-        thread_contexts[i].stats         = get_solve_stats();
-        move_list[0]                     = i;
-        prep_phase1(thread_contexts[i].solve_context, 1, move_list);
+// Symmetries 16 and 32 rotate the cube around the URF-DBL diagonal, so that the RL and FB axes become the UD one
+static const int view_symmetries[] = {0, 16, 32};
+
+// Six way search needs the moves of every view to be the same, so it is off with a move black list. Phase1 only
+// solves are not mapped back either, since a phase1 solution of another view does not bring the cube into G1.
+static int count_solve_views(const solve_request_t *request) {
+    const config_t *config = get_config();
+
+    if (!request->six_way || request->n_solutions == 0)
+        return 1;
+
+    for (int i = 0; i < N_MOVES; i++) {
+        if (config->move_black_list[i] != MOVE_NULL)
+            return 1;
     }
 
-    pthread_t threads[thread_count];
+    return MAX_SOLVE_VIEWS;
+}
+
+static void init_solve_views(phase1_scheduler_t *scheduler, const coord_cube_t *cube, int n_views) {
+    scheduler->n_views = n_views;
+
+    copy_coord_cube(&scheduler->views[0].cube, cube);
+    scheduler->views[0].index      = 0;
+    scheduler->views[0].symmetry   = 0;
+    scheduler->views[0].is_inverse = false;
+
+    if (n_views == 1)
+        return;
+
+    cube_cubie_t cubie;
+    coord_to_cubie_cube(cube, &cubie);
+
+    for (int i = 0; i < n_views; i++) {
+        int          symmetry = view_symmetries[i / 2];
+        cube_cubie_t view     = cubie;
+
+        if (symmetry != 0) {
+            cube_cubie_t symmetry_cube, inverse_symmetry_cube;
+            get_symmetry_cube(&symmetry_cube, symmetry);
+            get_symmetry_cube(&inverse_symmetry_cube, get_inverse_symmetry(symmetry));
+            conjugate_cubie_cube(&view, &symmetry_cube, &inverse_symmetry_cube);
+        }
+
+        if (i % 2 == 1) {
+            cube_cubie_t conjugate = view;
+            invert_cubie_cube(&conjugate, &view);
+        }
+
+        coord_cube_t *view_cube = make_coord_cube(&view);
+        copy_coord_cube(&scheduler->views[i].cube, view_cube);
+        free(view_cube);
+
+        scheduler->views[i].index      = i;
+        scheduler->views[i].symmetry   = symmetry;
+        scheduler->views[i].is_inverse = i % 2 == 1;
+    }
+}
+
+static void init_phase1_scheduler(phase1_scheduler_t *scheduler, const coord_cube_t *cube, int max_depth,
+                                  int n_views) {
+    phase1_prefix_t prefix;
+
+    init_solve_views(scheduler, cube, n_views);
+
+    for (int view = 0; view < n_views; view++) {
+        scheduler->n_prefixes = 0;
+        add_phase1_prefixes(scheduler, view, &prefix, &scheduler->views[view].cube, 0);
+    }
+
+    scheduler->n_short_tasks = (MIN(PHASE1_PREFIX_LENGTH, max_depth) + 1) * n_views;
+    scheduler->n_tasks       = scheduler->n_short_tasks;
+
+    if (max_depth > PHASE1_PREFIX_LENGTH)
+        scheduler->n_tasks += scheduler->n_prefixes * n_views * (max_depth - PHASE1_PREFIX_LENGTH);
+
+    atomic_store(&scheduler->next_task, 0);
+}
+
+// Returns the prefix of the task, or NULL for the short tasks that have none
+static const phase1_prefix_t *get_phase1_task(const phase1_scheduler_t *scheduler, int task, int *depth,
+                                              int *view) {
+    if (task < scheduler->n_short_tasks) {
+        *depth = task / scheduler->n_views;
+        *view  = task % scheduler->n_views;
+        return NULL;
+    }
+
+    task -= scheduler->n_short_tasks;
+
+    int tasks_per_depth = scheduler->n_prefixes * scheduler->n_views;
+    *depth              = PHASE1_PREFIX_LENGTH + 1 + task / tasks_per_depth;
+    *view               = task % tasks_per_depth / scheduler->n_prefixes;
+
+    return &scheduler->prefixes[*view][task % scheduler->n_prefixes];
+}
+
+// Where a phase1 search of one task is, so that it can be stopped at any node and resumed later
+typedef struct {
+    solve_list_t  *solves;
+    solve_list_t  *solves_head;
+    solve_stats_t *stats;
+    const uint8_t *solution;
+    int            prefix_length;
+    int            allowed_depth;
+    int            pivot;
+    uint64_t       move_count;
+    uint64_t       iterations;
+
+    // The search stopped right before it went down to cube_stack[pivot]
+    bool expand_pending;
+    bool done;
+} phase1_search_t;
+
+// Where the phase2 IDA* of one cube is, so that it can be stopped at any node and resumed later
+typedef struct {
+    solve_stats_t *stats;
+    const uint8_t *solution;
+    int            allowed_depth;
+    int            max_depth;
+    int            pivot;
+    uint64_t       move_count;
+    uint64_t       iterations;
+    bool           done;
+
+    // The phase2 cache already had the answer
+    bool is_cached;
+} phase2_search_t;
+
+// The workers and their solve contexts are kept across solves, so a solve only has to reset them
+static thread_pool_t      *solve_pool           = NULL;
+static solve_context_t   **solve_pool_contexts  = NULL;
+static phase1_scheduler_t *solve_pool_scheduler = NULL;
+static phase2_queue_t     *solve_pool_queue     = NULL;
+static int                 solve_pool_size      = 0;
+static pthread_mutex_t     solve_pool_lock      = PTHREAD_MUTEX_INITIALIZER;
+
+static solve_context_t *alloc_solve_context();
+
+// Both expect solve_pool_lock to be held
+static void free_solve_pool() {
+    if (solve_pool == NULL)
+        return;
+
+    thread_pool_destroy(solve_pool);
+
+    for (int i = 0; i < solve_pool_size; i++) {
+        destroy_solve_context(solve_pool_contexts[i]);
+    }
+
+    free(solve_pool_contexts);
+    free(solve_pool_scheduler);
+    destroy_phase2_queue(solve_pool_queue);
+
+    solve_pool           = NULL;
+    solve_pool_contexts  = NULL;
+    solve_pool_scheduler = NULL;
+    solve_pool_queue     = NULL;
+    solve_pool_size      = 0;
+}
+
+static void resize_solve_pool(int thread_count) {
+    if (solve_pool != NULL && solve_pool_size == thread_count)
+        return;
+
+    free_solve_pool();
+
+    solve_pool           = thread_pool_create(thread_count);
+    solve_pool_contexts  = (solve_context_t **)malloc(sizeof(solve_context_t *) * thread_count);
+    solve_pool_scheduler = (phase1_scheduler_t *)malloc(sizeof(phase1_scheduler_t));
+    solve_pool_queue     = make_phase2_queue(PHASE2_QUEUE_CAPACITY);
+    solve_pool_size      = thread_count;
+
     for (int i = 0; i < thread_count; i++) {
-        pthread_create(&threads[i], NULL, (void *(*)(void *))solve_thread, (void *)&thread_contexts[i]);
+        solve_pool_contexts[i] = alloc_solve_context();
+    }
+}
+
+void init_solve_pool(int thread_count) {
+    pthread_mutex_lock(&solve_pool_lock);
+    resize_solve_pool(thread_count);
+    pthread_mutex_unlock(&solve_pool_lock);
+}
+
+void destroy_solve_pool() {
+    pthread_mutex_lock(&solve_pool_lock);
+    free_solve_pool();
+    pthread_mutex_unlock(&solve_pool_lock);
+}
+
+static void solve_phase2_thread(thread_context_t *thread_context);
+
+static void solve_task(void *arg) {
+    thread_context_t *thread_context = (thread_context_t *)arg;
+
+    if (thread_context->runs_phase2) {
+        solve_phase2_thread(thread_context);
+    } else {
+        solve_thread(thread_context);
     }
+}
 
+// Points the contexts at the cube and request of a new solve, each with its own list and stats in the arena
+static void begin_solve(const coord_cube_t *original_cube, solve_request_t *request, solve_context_t **contexts,
+                        int thread_count, phase1_scheduler_t *scheduler, phase2_queue_t *queue, int n_phase2_threads,
+                        solve_arena_t *arena, thread_context_t *thread_contexts) {
     for (int i = 0; i < thread_count; i++) {
-        pthread_join(threads[i], NULL);
+        reset_solve_context(contexts[i], original_cube);
+        contexts[i]->view                    = &scheduler->views[0];
+        contexts[i]->request                 = request;
+        contexts[i]->phase2_context->request = request;
+        contexts[i]->phase2_queue            = n_phase2_threads > 0 ? queue : NULL;
+        contexts[i]->phase2_batch_size       = MIN(get_config()->phase2_batch_size, MAX_PHASE2_BATCH);
+        contexts[i]->views                   = scheduler->views;
+        contexts[i]->steps_phase2            = false;
+
+        thread_contexts[i].solve_context = contexts[i];
+        thread_contexts[i].scheduler     = scheduler;
+        thread_contexts[i].solves        = new_solve_list_node(arena);
+        thread_contexts[i].stats         = new_solve_stats(arena);
+        thread_contexts[i].runs_phase2   = i >= thread_count - n_phase2_threads;
     }
+}
 
+// Merges the solutions of the threads into the list that is returned, which owns the arena from then on
+static solve_list_t *end_solve(solve_request_t *request, phase1_scheduler_t *scheduler,
+                               thread_context_t *thread_contexts, int thread_count, solve_arena_t *arena) {
     int all_lengths[MAX_SOLUTION_LENGTHS];
     int n_lengths = 0;
 
     solve_stats_t *all_thread_stats[thread_count];
-    int            is_winner[thread_count];
 
-    solve_list_t *solves =
-        collect_results(thread_contexts, thread_count, all_thread_stats, is_winner, all_lengths, &n_lengths);
+    solve_list_t *solves = collect_results(thread_contexts, thread_count, all_thread_stats, all_lengths, &n_lengths);
 
-    if (config->n_solutions > 0) {
-        truncate_solutions(solves, config->n_solutions);
+    // Different views can find the same solution
+    if (scheduler->n_views > 1) {
+        remove_duplicate_solutions(solves);
     }
 
-    aggregate_stats_t *aggregate = compute_aggregate_stats(all_thread_stats, thread_count, all_lengths, n_lengths);
-    if (solves != NULL) {
-        solves->aggregate = aggregate;
-    } else {
-        free(aggregate);
+    if (request->n_solutions > 0) {
+        truncate_solutions(solves, request->n_solutions);
     }
 
-    for (int i = 0; i < thread_count; i++) {
-        if (!is_winner[i]) {
-            free(thread_contexts[i].stats);
-        }
+    // Everything of the solve lives in the arena, which is owned by the list from here
+    if (solves == NULL) {
+        destroy_solve_arena(arena);
+        return NULL;
     }
 
-    if (config->n_solutions > 0 && solves != NULL && solves->solution != NULL) {
+    solves->aggregate = solve_arena_alloc(arena, sizeof(aggregate_stats_t));
+    compute_aggregate_stats(solves->aggregate, all_thread_stats, thread_count, all_lengths, n_lengths);
+
+    if (request->n_solutions > 0 && solves != NULL && solves->solution != NULL) {
         for (solve_list_t *outer = solves; outer != NULL && outer->solution != NULL; outer = outer->next) {
             for (solve_list_t *inner = outer->next; inner != NULL && inner->solution != NULL; inner = inner->next) {
                 assert(!are_solutions_equal(outer->solution, inner->solution));
@@ -270,163 +522,474 @@ solve_list_t *solve(const coord_cube_t *original_cube, const config_t *config) {
         }
     }
 
-    for (int i = 0; i < thread_count; i++) {
-        destroy_solve_context(thread_contexts[i].solve_context);
-    }
-
     return solves;
 }
 
-solve_list_t *solve_thread(void *arg) {
-    thread_context_t *thread_context = (thread_context_t *)arg;
-    solve_context_t  *solve_context  = thread_context->solve_context;
-    solve_list_t     *solves         = thread_context->solves;
+// Runs a solve with one context per thread, on the pool if there is one, or on the calling thread otherwise.
+// The last n_phase2_threads threads run the phase2 searches that the others queue.
+static solve_list_t *run_solve(const coord_cube_t *original_cube, solve_request_t *request, thread_pool_t *pool,
+                               solve_context_t **contexts, int thread_count, phase1_scheduler_t *scheduler,
+                               phase2_queue_t *queue, int n_phase2_threads) {
+    if (is_coord_solved(original_cube)) {
+        return make_trivial_solution();
+    }
 
-    solve_phase1(solve_context, solves, thread_context->stats);
+    solve_arena_t *arena = make_solve_arena();
 
-    if (solves->solution != NULL) {
-        for (solve_list_t *cur = solves; cur != NULL && cur->solution != NULL; cur = cur->next) {
-            patch_solution(solve_context, cur);
-        }
+    init_phase1_scheduler(scheduler, original_cube, request->max_depth, count_solve_views(request));
 
-        coord_cube_t *cube = get_coord_cube();
-        copy_coord_cube(cube, solve_context->original_cube);
+    // The phase2 workers wait on the others, so they need a pool to run at the same time as them
+    if (pool == NULL || request->n_solutions == 0) {
+        n_phase2_threads = 0;
+    }
+    n_phase2_threads = MIN(n_phase2_threads, thread_count - 1);
 
-        for (int i = 0; solves->solution[i] != MOVE_NULL; i++) {
-            coord_apply_move(cube, solves->solution[i]);
-        }
+    if (n_phase2_threads > 0) {
+        reset_phase2_queue(queue, thread_count - n_phase2_threads);
+    }
 
-        assert(is_phase1_solved(cube));
+    thread_context_t thread_contexts[thread_count];
+    void            *thread_args[thread_count];
 
-        if (solves->phase2_solution != NULL) {
-            assert(is_phase2_solved(cube));
+    begin_solve(original_cube, request, contexts, thread_count, scheduler, queue, n_phase2_threads, arena,
+                thread_contexts);
+
+    for (int i = 0; i < thread_count; i++)
+        thread_args[i] = &thread_contexts[i];
+
+    if (pool != NULL) {
+        thread_pool_run(pool, solve_task, thread_args, thread_count);
+    } else {
+        for (int i = 0; i < thread_count; i++) {
+            solve_task(thread_args[i]);
         }
+    }
 
-        free(cube);
+    return end_solve(request, scheduler, thread_contexts, thread_count, arena);
+}
+
+solve_list_t *solve(const coord_cube_t *original_cube, const config_t *config) {
+    solve_request_t request;
+    init_solve_request(&request, config);
+
+    return solve_with_request(original_cube, config, &request);
+}
+
+struct solve_worker_s {
+    solve_context_t    *solve_context;
+    phase1_scheduler_t *scheduler;
+
+    // The solve started with start_solve_on_worker, which runs a node expansion at a time
+    solve_request_t *request;
+    solve_arena_t   *arena;
+    thread_context_t thread_context;
+    phase1_search_t  search;
+    phase2_search_t  phase2_search;
+    uint64_t         start_time;
+    bool             is_searching;
+    bool             is_searching_phase2;
+    bool             is_trivial;
+};
+
+solve_worker_t *make_solve_worker() {
+    solve_worker_t *worker = (solve_worker_t *)malloc(sizeof(solve_worker_t));
+
+    worker->solve_context = alloc_solve_context();
+    worker->scheduler     = (phase1_scheduler_t *)malloc(sizeof(phase1_scheduler_t));
+
+    return worker;
+}
+
+void destroy_solve_worker(solve_worker_t *worker) {
+    destroy_solve_context(worker->solve_context);
+    free(worker->scheduler);
+    free(worker);
+}
+
+solve_list_t *solve_on_worker(solve_worker_t *worker, const coord_cube_t *original_cube, solve_request_t *request) {
+    return run_solve(original_cube, request, NULL, &worker->solve_context, 1, worker->scheduler, NULL, 0);
+}
+
+static int  load_next_phase1_task(solve_context_t *solve_context, phase1_scheduler_t *scheduler, int *prefix_length);
+static void finish_solve_thread(thread_context_t *thread_context, uint64_t start_time);
+static void start_phase1_search(phase1_search_t *search, solve_context_t *solve_context, solve_list_t *solves,
+                                solve_stats_t *stats, int prefix_length, int allowed_depth);
+static bool run_phase1_search(phase1_search_t *search, solve_context_t *solve_context, bool yield);
+static const uint8_t *finish_phase1_search(phase1_search_t *search, solve_context_t *solve_context);
+static bool           start_phase2_search(phase2_search_t *search, solve_context_t *solve_context, int max_depth,
+                                          solve_stats_t *stats);
+static bool run_phase2_search(phase2_search_t *search, solve_context_t *solve_context, const config_t *config,
+                              bool yield);
+static const uint8_t *finish_phase2_search(phase2_search_t *search, solve_context_t *solve_context);
+static int            store_phase2_result(solve_context_t *solve_context, solve_list_t **solves,
+                                          solve_list_t *solves_head, solve_stats_t *stats, int pivot,
+                                          const uint8_t **solution, const uint8_t *phase2_solution);
+
+void start_solve_on_worker(solve_worker_t *worker, const coord_cube_t *original_cube, solve_request_t *request) {
+    worker->request             = request;
+    worker->is_searching        = false;
+    worker->is_searching_phase2 = false;
+    worker->is_trivial          = is_coord_solved(original_cube);
+
+    if (worker->is_trivial)
+        return;
+
+    worker->arena = make_solve_arena();
+
+    init_phase1_scheduler(worker->scheduler, original_cube, request->max_depth, count_solve_views(request));
+    begin_solve(original_cube, request, &worker->solve_context, 1, worker->scheduler, NULL, 0, worker->arena,
+                &worker->thread_context);
+
+    // Every leaf gets its own phase2 search in steps, instead of being put aside for a batch
+    worker->solve_context->steps_phase2      = true;
+    worker->solve_context->phase2_batch_size = 0;
+
+    worker->start_time                 = get_microseconds();
+    worker->solve_context->phase2_time = 0;
+}
+
+// Takes one step of the phase2 search of the leaf the phase1 search stopped at, starting it if needed. Once it is
+// over the full solution is stored, and the phase1 search is ended if that was enough.
+static void step_phase2_leaf(solve_worker_t *worker) {
+    solve_context_t *solve_context  = worker->solve_context;
+    solve_context_t *phase2_context = solve_context->phase2_context;
+    phase2_search_t *phase2_search  = &worker->phase2_search;
+    phase1_search_t *search         = &worker->search;
+
+    if (!worker->is_searching_phase2) {
+        worker->is_searching_phase2 = true;
+        search->stats->phase2_attempts++;
+
+        if (start_phase2_search(phase2_search, phase2_context, solve_context->phase2_leaf_depth, search->stats))
+            return;
+    } else if (run_phase2_search(phase2_search, phase2_context, get_config(), true)) {
+        return;
     }
 
-    return solves;
+    const uint8_t *phase2_solution = finish_phase2_search(phase2_search, phase2_context);
+
+    worker->is_searching_phase2    = false;
+    solve_context->has_phase2_leaf = false;
+
+    if (store_phase2_result(solve_context, &search->solves, search->solves_head, search->stats,
+                            solve_context->phase2_leaf_pivot, &search->solution, phase2_solution)) {
+        search->done = true;
+    }
 }
 
-void prep_phase1(solve_context_t *solve_context, uint16_t move_count, const move_t *move_list) {
-    for (int i = 0; i < MAX_MOVES; i++) {
-        solve_context->prep_moves[i] = MOVE_NULL;
+bool step_solve_on_worker(solve_worker_t *worker) {
+    solve_context_t *solve_context = worker->solve_context;
+
+    if (worker->is_trivial)
+        return false;
+
+    if (solve_context->has_phase2_leaf) {
+        step_phase2_leaf(worker);
+        return true;
+    }
+
+    if (worker->is_searching) {
+        if (run_phase1_search(&worker->search, solve_context, true))
+            return true;
+
+        finish_phase1_search(&worker->search, solve_context);
+        worker->is_searching = false;
+    }
+
+    int prefix_length;
+    int depth = load_next_phase1_task(solve_context, worker->scheduler, &prefix_length);
+
+    if (depth < 0)
+        return false;
+
+    start_phase1_search(&worker->search, solve_context, worker->thread_context.solves, worker->thread_context.stats,
+                        prefix_length, depth);
+    worker->is_searching = true;
+
+    return true;
+}
+
+solve_list_t *finish_solve_on_worker(solve_worker_t *worker) {
+    if (worker->is_trivial)
+        return make_trivial_solution();
+
+    // A phase2 search that was stopped halfway found nothing, and cannot be cached as a miss either
+    if (worker->is_searching_phase2) {
+        worker->phase2_search.stats->phase2_move_count += worker->phase2_search.move_count;
+        worker->is_searching_phase2 = false;
     }
+    worker->solve_context->has_phase2_leaf = false;
 
-    for (int i = 0; i < move_count; i++) {
-        solve_context->prep_moves[i] = move_list[i];
+    // Stopped before the search was over, the leaves it put aside still go through phase2
+    if (worker->is_searching) {
+        finish_phase1_search(&worker->search, worker->solve_context);
+        worker->is_searching = false;
     }
 
-    for (int i = 0; i < move_count; i++) {
-        coord_apply_move(solve_context->cube, solve_context->prep_moves[i]);
+    finish_solve_thread(&worker->thread_context, worker->start_time);
+
+    return end_solve(worker->request, worker->scheduler, &worker->thread_context, 1, worker->arena);
+}
+
+solve_list_t *solve_with_request(const coord_cube_t *original_cube, const config_t *config, solve_request_t *request) {
+    if (pthread_mutex_trylock(&solve_pool_lock) != 0) {
+        solve_worker_t *worker = make_solve_worker();
+        solve_list_t   *solves = solve_on_worker(worker, original_cube, request);
+        destroy_solve_worker(worker);
+
+        return solves;
     }
 
-    solve_context->prep_move_count = move_count;
+    resize_solve_pool(config->thread_count);
+
+    solve_list_t *solves = run_solve(original_cube, request, solve_pool, solve_pool_contexts, solve_pool_size,
+                                     solve_pool_scheduler, solve_pool_queue, config->phase2_threads);
+
+    pthread_mutex_unlock(&solve_pool_lock);
+
+    return solves;
 }
 
-move_t *patch_solution(solve_context_t *solve_context, solve_list_t *solution) {
-    uint16_t solution_length = 0;
+// Only swaps the cube that is searched, the solutions are still checked against the original one
+static void load_solve_view(solve_context_t *solve_context, const solve_view_t *view) {
+    copy_coord_cube(solve_context->cube, &view->cube);
+    coord_get_edge_permutations(solve_context->cube, solve_context->edge_permutations);
+
+    solve_context->view = view;
+}
+
+// Makes sure that the first solution of a thread solves the original cube
+static void check_thread_solution(const solve_context_t *solve_context, const solve_list_t *solves) {
+    if (solves->solution == NULL)
+        return;
+
+    coord_cube_t *cube = get_coord_cube();
+    copy_coord_cube(cube, solve_context->original_cube);
 
-    for (int i = 0; solution->solution[i] != MOVE_NULL; i++) {
-        solution_length++;
+    for (int i = 0; solves->solution[i] != MOVE_NULL; i++) {
+        coord_apply_move(cube, solves->solution[i]);
     }
 
-    move_t  *partial_solution = solution->solution;
-    uint16_t total_length     = solution_length + solve_context->prep_move_count;
-    solution->solution        = malloc(sizeof(move_t) * (total_length + 1));
+    assert(is_phase1_solved(cube));
 
-    for (int i = 0; i < total_length; i++) {
-        solution->solution[i] = MOVE_NULL;
+    if (solves->phase2_solution != NULL) {
+        assert(is_phase2_solved(cube));
     }
 
-    for (int i = 0; i < solve_context->prep_move_count; i++) {
-        solution->solution[i] = solve_context->prep_moves[i];
+    free(cube);
+}
+
+// Deepest phase1 search still worth running. A phase1 solution needs at least one phase2 move after it to make a
+// full solution, unless only phase1 solutions are wanted.
+static int get_phase1_depth_bound(const solve_request_t *request) {
+    int bound = get_solve_request_bound(request);
+
+    return request->n_solutions != 0 ? bound - 1 : bound;
+}
+
+// Takes the next phase1 task that can still have solutions, and puts its view and prefix into the context. Returns
+// the depth of the task, or -1 once there is none left.
+static int load_next_phase1_task(solve_context_t *solve_context, phase1_scheduler_t *scheduler, int *prefix_length) {
+    while (!check_solve_request_deadline(solve_context->request)) {
+        int task = atomic_fetch_add(&scheduler->next_task, 1);
+
+        if (task >= scheduler->n_tasks)
+            break;
+
+        int                    depth, view;
+        const phase1_prefix_t *prefix = get_phase1_task(scheduler, task, &depth, &view);
+        *prefix_length                = 0;
+
+        // Tasks come in depth order, so none of the tasks left can beat the solutions found anymore
+        if (depth > get_phase1_depth_bound(solve_context->request))
+            break;
+
+        if (prefix != NULL) {
+            // No solution of this length can start with this prefix
+            if (prefix->pruning + PHASE1_PREFIX_LENGTH > depth)
+                continue;
+        }
+
+        if (solve_context->view != &scheduler->views[view]) {
+            load_solve_view(solve_context, &scheduler->views[view]);
+        }
+
+        if (prefix != NULL) {
+            for (int i = 0; i < PHASE1_PREFIX_LENGTH; i++) {
+                solve_context->move_stack[i] = prefix->moves[i];
+                solve_context->cube_stack[i] = prefix->cubes[i];
+            }
+
+            *prefix_length = PHASE1_PREFIX_LENGTH;
+        }
+
+        return depth;
     }
 
-    for (int i = 0; partial_solution[i] != MOVE_NULL; i++) {
-        solution->solution[i + solve_context->prep_move_count] = partial_solution[i];
+    return -1;
+}
+
+static void finish_solve_thread(thread_context_t *thread_context, uint64_t start_time) {
+    solve_context_t *solve_context = thread_context->solve_context;
+    solve_stats_t   *stats         = thread_context->stats;
+
+    // The phase2 workers stop once every phase1 worker is done and the queue is empty
+    if (solve_context->phase2_queue != NULL) {
+        close_phase2_producer(solve_context->phase2_queue);
     }
 
-    solution->solution[solve_context->prep_move_count + solution_length] = MOVE_NULL;
+    uint64_t end_time = get_microseconds();
+    finalize_solve_stats(stats, start_time, end_time, solve_context->phase2_time,
+                         atomic_load(&solve_context->request->die) && stats->solutions_found == 0);
+
+    check_thread_solution(solve_context, thread_context->solves);
+}
+
+solve_list_t *solve_thread(void *arg) {
+    thread_context_t   *thread_context = (thread_context_t *)arg;
+    solve_context_t    *solve_context  = thread_context->solve_context;
+    phase1_scheduler_t *scheduler      = thread_context->scheduler;
+    solve_list_t       *solves         = thread_context->solves;
+    solve_stats_t      *stats          = thread_context->stats;
 
-    free(partial_solution);
+    uint64_t start_time        = get_microseconds();
+    solve_context->phase2_time = 0;
 
-    move_t *phase1_solution   = solution->phase1_solution;
-    solution->phase1_solution = malloc(sizeof(move_t) * (solution_length + solve_context->prep_move_count + 1));
+    int prefix_length;
+    int depth;
 
-    for (int i = 0; i < solution_length + solve_context->prep_move_count; i++) {
-        solution->phase1_solution[i] = solution->solution[i];
+    while ((depth = load_next_phase1_task(solve_context, scheduler, &prefix_length)) >= 0) {
+        solve_phase1(solve_context, solves, stats, prefix_length, depth);
     }
 
-    solution->phase1_solution[solution_length + solve_context->prep_move_count] = MOVE_NULL;
+    finish_solve_thread(thread_context, start_time);
 
-    free(phase1_solution);
+    return solves;
+}
+
+static int solve_phase1_leaf_batch(solve_context_t *solve_context, solve_list_t **solves, solve_list_t *solves_head,
+                                   solve_stats_t *stats, phase2_candidate_t *batch, int n_batch);
+
+// Runs the phase2 search of the phase1 solutions that the other workers queue, taking up to a batch at a time
+static void solve_phase2_thread(thread_context_t *thread_context) {
+    solve_context_t *solve_context = thread_context->solve_context;
+    phase2_queue_t  *queue         = solve_context->phase2_queue;
+    solve_request_t *request       = solve_context->request;
+    solve_list_t    *solves        = thread_context->solves;
+    solve_stats_t   *stats         = thread_context->stats;
+
+    uint64_t start_time        = get_microseconds();
+    solve_context->phase2_time = 0;
+
+    phase2_candidate_t *batch      = solve_context->phase2_batch;
+    int                 batch_size = MAX(1, solve_context->phase2_batch_size);
+
+    while (!check_solve_request_deadline(request)) {
+        // Read before looking at the queue, so that nothing can be pushed after the queue is seen empty
+        bool has_producers = has_phase2_producers(queue);
+        int  n_batch       = 0;
+
+        while (n_batch < batch_size && pop_phase2_candidate(queue, &batch[n_batch]))
+            n_batch++;
+
+        if (n_batch == 0) {
+            if (!has_producers)
+                break;
+
+            sched_yield();
+            continue;
+        }
+
+        if (solve_phase1_leaf_batch(solve_context, &solves, thread_context->solves, stats, batch, n_batch))
+            break;
+    }
 
-    return solution->solution;
+    uint64_t end_time = get_microseconds();
+    finalize_solve_stats(stats, start_time, end_time, solve_context->phase2_time,
+                         atomic_load(&request->die) && stats->solutions_found == 0);
+
+    check_thread_solution(solve_context, thread_context->solves);
 }
 
-static void build_phase1_solution(const move_t *move_stack, int pivot, move_t **solution, move_t **phase1_solution) {
+// Puts the phase1 solution in move_stack[0..pivot] into the solution buffers of the context
+static void build_phase1_solution(solve_context_t *solve_context, const move_t *move_stack, int pivot) {
     assert(pivot < MAX_MOVES);
 
-    *solution        = malloc(sizeof(move_t) * (MAX_MOVES + 1));
-    *phase1_solution = malloc(sizeof(move_t) * (pivot + 2));
-
     for (int i = 0; i <= pivot; i++) {
-        (*solution)[i]        = move_stack[i];
-        (*phase1_solution)[i] = move_stack[i];
+        solve_context->solution[i]        = (uint8_t)move_stack[i];
+        solve_context->phase1_solution[i] = (uint8_t)move_stack[i];
     }
-    (*solution)[pivot + 1]        = MOVE_NULL;
-    (*phase1_solution)[pivot + 1] = MOVE_NULL;
+    solve_context->solution[pivot + 1]        = MOVE_NULL;
+    solve_context->phase1_solution[pivot + 1] = MOVE_NULL;
 }
 
-static int assemble_full_solution(move_t *solution, int pivot, const move_t *phase2_solution,
+static int assemble_full_solution(uint8_t *solution, int pivot, const uint8_t *phase2_solution,
                                   coord_cube_t *phase2_cube) {
     int phase2_move_count = 0;
     for (int i = 0; phase2_solution[i] != MOVE_NULL; i++)
         phase2_move_count++;
 
-    for (int i = 0; phase2_solution[i] != MOVE_NULL; i++) {
-        coord_apply_move(phase2_cube, phase2_solution[i]);
+    for (int i = 0; phase2_solution[i] != MOVE_NULL; i++)
         solution[pivot + i + 1] = phase2_solution[i];
-    }
     solution[pivot + phase2_move_count + 1] = MOVE_NULL;
 
+    // The phase2 cube is only followed for the asserts that the solution solves it
+#ifndef NDEBUG
+    for (int i = 0; phase2_solution[i] != MOVE_NULL; i++)
+        coord_apply_move(phase2_cube, phase2_solution[i]);
+#else
+    (void)phase2_cube;
+#endif
+
     return phase2_move_count;
 }
 
-static void record_solution_stats(solve_stats_t *stats, int pivot, int phase2_move_count, uint64_t move_count,
-                                  uint8_t prep_move_count) {
-    if (stats->solutions_found == 0) {
+// Keeps the shortest solution of the thread, which is the one it contributes to the sorted results
+static void record_solution_stats(solve_stats_t *stats, int pivot, int phase2_move_count) {
+    if (stats->solutions_found == 0 || pivot + phase2_move_count + 1 < stats->solution_length) {
         stats->phase1_depth    = pivot + 1;
         stats->phase2_depth    = phase2_move_count;
-        stats->solution_length = pivot + phase2_move_count + 1 + prep_move_count;
+        stats->solution_length = pivot + phase2_move_count + 1;
     }
-    stats->phase1_move_count = move_count;
 }
 
-static void store_solution_in_list(solve_list_t **solves_ptr, move_t *phase1_solution, move_t *phase2_solution,
-                                   move_t *solution) {
+static uint8_t *copy_solution(solve_arena_t *arena, const uint8_t *source) {
+    uint8_t *solution = new_solution(arena);
+    memcpy(solution, source, get_solution_length(source) + 1);
+
+    return solution;
+}
+
+// Copies the solution into the arena of the list, and returns the copy or NULL when there is no list to keep it
+static const uint8_t *store_solution_in_list(solve_list_t **solves_ptr, const uint8_t *phase1_solution,
+                                             const uint8_t *phase2_solution, const uint8_t *solution) {
     solve_list_t *solves = *solves_ptr;
 
-    if (solves != NULL) {
-        if (solves->solution != NULL) {
-            solves->next = new_solve_list_node();
-            solves       = solves->next;
-        }
+    if (solves == NULL)
+        return NULL;
 
-        solves->phase1_solution = phase1_solution;
-        solves->phase2_solution = phase2_solution;
-        solves->solution        = solution;
-    } else {
-        free(phase1_solution);
-        free(phase2_solution);
-        free(solution);
+    if (solves->solution != NULL) {
+        solves->next = new_solve_list_node(solves->arena);
+        solves       = solves->next;
     }
 
+    solves->phase1_solution = copy_solution(solves->arena, phase1_solution);
+    solves->phase2_solution = copy_solution(solves->arena, phase2_solution);
+    solves->solution        = copy_solution(solves->arena, solution);
+
     *solves_ptr = solves;
+
+    return solves->solution;
+}
+
+int get_solution_length(const uint8_t *solution) {
+    int length = 0;
+    while (solution[length] != MOVE_NULL)
+        length++;
+    return length;
 }
 
-int are_solutions_equal(const move_t *a, const move_t *b) {
+int are_solutions_equal(const uint8_t *a, const uint8_t *b) {
     int i = 0;
     while (a[i] != MOVE_NULL && b[i] != MOVE_NULL) {
         if (a[i] != b[i])
@@ -436,7 +999,7 @@ int are_solutions_equal(const move_t *a, const move_t *b) {
     return a[i] == b[i];
 }
 
-int is_duplicate_solution(solve_list_t *solves_head, const move_t *solution) {
+int is_duplicate_solution(solve_list_t *solves_head, const uint8_t *solution) {
     for (solve_list_t *n = solves_head; n != NULL && n->solution != NULL; n = n->next) {
         if (are_solutions_equal(solution, n->solution))
             return 1;
@@ -444,193 +1007,458 @@ int is_duplicate_solution(solve_list_t *solves_head, const move_t *solution) {
     return 0;
 }
 
-move_t *solve_phase1(solve_context_t *solve_context, solve_list_t *solves, solve_stats_t *stats) {
-    move_t *solution = NULL;
+// A solution n1..nk of S * C * S^-1 solves C as (S^-1 n1 S)..(S^-1 nk S). A solution of the inverse of C solves C
+// once reversed with every move undone, which also swaps the phase1 and phase2 parts.
+static void map_moves_from_view(const solve_view_t *view, uint8_t *moves) {
+    int length           = get_solution_length(moves);
+    int inverse_symmetry = get_inverse_symmetry(view->symmetry);
+
+    for (int i = 0; i < length; i++)
+        moves[i] = get_conjugate_move(moves[i], inverse_symmetry);
+
+    if (!view->is_inverse)
+        return;
+
+    for (int i = 0; i < length / 2; i++) {
+        uint8_t move          = moves[i];
+        moves[i]              = moves[length - i - 1];
+        moves[length - i - 1] = move;
+    }
+
+    for (int i = 0; i < length; i++)
+        moves[i] = get_reverse_move(moves[i]);
+}
+
+static void map_solution_from_view(const solve_view_t *view, uint8_t *solution, uint8_t **phase1_solution,
+                                   uint8_t **phase2_solution) {
+    map_moves_from_view(view, solution);
+    map_moves_from_view(view, *phase1_solution);
+    map_moves_from_view(view, *phase2_solution);
+
+    if (view->is_inverse) {
+        uint8_t *moves   = *phase1_solution;
+        *phase1_solution = *phase2_solution;
+        *phase2_solution = moves;
+    }
+}
+
+// Whether the move keeps a cube in G1. A phase1 solution ending with one of them is only a longer copy of the
+// solution without its last move, which was already tried one depth earlier.
+static int is_phase2_move(move_t move) {
+    return (move >= MOVE_U1 && move <= MOVE_U3) || (move >= MOVE_D1 && move <= MOVE_D3) || move == MOVE_R2 ||
+           move == MOVE_F2 || move == MOVE_L2 || move == MOVE_B2;
+}
+
+// Stores the full solution made of the phase1 solution of pivot + 1 moves of the current view, already in the
+// solution buffers of the context, and the phase2 solution of the cube of the phase2 context. Only the solutions
+// that are kept are copied out of the buffers, into *solution. Returns 1 once the search should stop.
+static int store_phase1_leaf_solution(solve_context_t *solve_context, solve_list_t **solves,
+                                      solve_list_t *solves_head, solve_stats_t *stats, int pivot,
+                                      const uint8_t **solution, const uint8_t *phase2_result) {
+    solve_request_t *request         = solve_context->request;
+    coord_cube_t    *phase2_cube     = solve_context->phase2_context->cube;
+    uint8_t         *phase1_solution = solve_context->phase1_solution;
+    uint8_t         *phase2_solution = solve_context->phase2_solution;
+
+    // The result belongs to the phase2 context and its cache, and the view might still have to change it
+    memcpy(phase2_solution, phase2_result, get_solution_length(phase2_result) + 1);
+
+    int phase2_move_count = assemble_full_solution(solve_context->solution, pivot, phase2_solution, phase2_cube);
+
+    if (solve_context->view != NULL && (solve_context->view->symmetry != 0 || solve_context->view->is_inverse)) {
+        map_solution_from_view(solve_context->view, solve_context->solution, &phase1_solution, &phase2_solution);
+    }
+    int is_duplicate = (request->n_solutions > 0) && is_duplicate_solution(solves_head, solve_context->solution);
+
+    if (is_duplicate)
+        return 0;
+
+    stats->phase2_successes++;
+
+    // Some other threads might have found enough shorter ones in the meantime
+    if (!add_solve_request_solution(request, pivot + phase2_move_count + 1))
+        return 0;
+
+    if (is_solve_request_anytime(request)) {
+        atomic_fetch_add(&request->solutions_found, 1);
+        record_solution_stats(stats, pivot, phase2_move_count);
+        *solution = store_solution_in_list(solves, phase1_solution, phase2_solution, solve_context->solution);
+        stats->solutions_found++;
+
+        assert(is_coord_solved(phase2_cube));
+
+        // Keeps going until the target length is reached, the deadline passes or no shorter solution is left
+        return is_solve_request_done(request);
+    }
 
+    int global_count = atomic_fetch_add(&request->solutions_found, 1) + 1;
+
+    if (request->n_solutions != -1 && global_count > request->n_solutions) {
+        atomic_store(&request->die, true);
+        return 1;
+    }
+
+    record_solution_stats(stats, pivot, phase2_move_count);
+    *solution = store_solution_in_list(solves, phase1_solution, phase2_solution, solve_context->solution);
+    stats->solutions_found++;
+
+    assert(is_coord_solved(phase2_cube));
+
+    if (request->n_solutions != -1 && global_count >= request->n_solutions) {
+        atomic_store(&request->die, true);
+        return 1;
+    }
+
+    return 0;
+}
+
+// Stores the full solution of the phase1 solution in move_stack[0..pivot] and the phase2 solution, if there is one.
+// Returns 1 once the search should stop.
+static int store_phase2_result(solve_context_t *solve_context, solve_list_t **solves, solve_list_t *solves_head,
+                               solve_stats_t *stats, int pivot, const uint8_t **solution,
+                               const uint8_t *phase2_solution) {
+    if (phase2_solution == NULL)
+        return 0;
+
+    build_phase1_solution(solve_context, solve_context->move_stack, pivot);
+
+    return store_phase1_leaf_solution(solve_context, solves, solves_head, stats, pivot, solution, phase2_solution);
+}
+
+// Runs phase2 on the cube of the phase2 context, for the phase1 solution in move_stack[0..pivot] of the current
+// view, and stores the full solution if one is found. Returns 1 once the search should stop.
+static int finish_phase1_leaf(solve_context_t *solve_context, solve_list_t **solves, solve_list_t *solves_head,
+                              solve_stats_t *stats, int pivot, int phase2_depth, const uint8_t **solution) {
     const config_t *config = get_config();
 
-    const coord_cube_t *cube          = solve_context->cube;
-    move_t             *move_stack    = solve_context->move_stack;
-    coord_cube_t      **cube_stack    = solve_context->cube_stack;
-    int                *pruning_stack = solve_context->pruning_stack;
+    uint64_t       phase2_start    = get_microseconds();
+    const uint8_t *phase2_solution = solve_phase2(solve_context->phase2_context, config, phase2_depth, stats);
+    uint64_t       phase2_end      = get_microseconds();
+    solve_context->phase2_time += phase2_end - phase2_start;
+    stats->phase2_attempts++;
 
-    uint64_t move_count = 0;
+    return store_phase2_result(solve_context, solves, solves_head, stats, pivot, solution, phase2_solution);
+}
 
-    uint64_t phase2_time = 0;
-    uint64_t start_time  = get_microseconds();
-    uint64_t end_time    = 0;
-    /*int move_estimate = get_phase1_pruning(cube);*/
-    /*printf("estimated number of moves: %d\n", move_estimate);*/
+// Makes the candidate the current leaf: its view, and its cube in the phase2 context. The phase1 moves go into
+// moves rather than the move stack, which the phase1 search might still be using. Returns the pivot of the leaf.
+static int load_phase2_candidate(solve_context_t *solve_context, const phase2_candidate_t *candidate,
+                                 move_t *moves) {
+    for (int i = 0; i < candidate->phase1_length; i++)
+        moves[i] = (move_t)candidate->moves[i];
 
-    // printf("solving phase1 with prep moves: ");
-    // print_move_sequence(solve_context->prep_moves);
+    copy_coord_cube(solve_context->phase2_context->cube, &candidate->cube);
+    solve_context->view = &solve_context->views[candidate->view];
 
-    solve_list_t *solves_head = solves;
+    return candidate->phase1_length - 1;
+}
 
-    for (int allowed_depth = 1; allowed_depth <= config->max_depth - solve_context->prep_move_count; allowed_depth++) {
-        int pivot = 0;
-        /*printf("searching with max depth: %d\n", allowed_depth);*/
+// Runs phase2 for a batch of leaves together, shortest full solutions first, and stores every solution found.
+// Returns 1 once the search should stop.
+static int solve_phase1_leaf_batch(solve_context_t *solve_context, solve_list_t **solves, solve_list_t *solves_head,
+                                   solve_stats_t *stats, phase2_candidate_t *batch, int n_batch) {
+    const config_t *config = get_config();
 
-        copy_coord_cube(cube_stack[0], cube);
+    stats->phase2_attempts += n_batch;
 
-        do {
-            if (get_config()->die) {
-                uint64_t die_end = get_microseconds();
-                finalize_solve_stats(stats, start_time, die_end, phase2_time, 1);
-                return NULL;
-            }
+    while (n_batch > 0) {
+        const uint8_t *phase2_solution;
+        uint64_t       phase2_start = get_microseconds();
+        int solved = solve_phase2_batch(solve_context->phase2_context, config, batch, n_batch, &phase2_solution, stats);
+        solve_context->phase2_time += get_microseconds() - phase2_start;
 
-            do {
-                move_stack[pivot]++;
-            } while (move_stack[pivot] < N_MOVES && config->move_black_list[move_stack[pivot]] != MOVE_NULL);
+        if (solved < 0)
+            return is_solve_request_done(solve_context->request);
 
-            if (move_stack[pivot] >= N_MOVES) {
-                pruning_stack[pivot] = -1; // ?
-                move_stack[pivot]    = -1;
-                /*printf("\n");*/
-                pivot--;
+        move_t moves[MAX_MOVES];
+        int    pivot = load_phase2_candidate(solve_context, &batch[solved], moves);
 
-                if (pivot < 0) {
-                    break;
-                } else if (pivot == 0) {
-                    copy_coord_cube(cube_stack[0], cube);
-                } else {
-                    copy_coord_cube(cube_stack[pivot], cube_stack[pivot - 1]);
-                }
+        const uint8_t *solution;
+        build_phase1_solution(solve_context, moves, pivot);
+        stats->phase1_depth = pivot + 1;
 
-                continue;
-            }
+        if (store_phase1_leaf_solution(solve_context, solves, solves_head, stats, pivot, &solution, phase2_solution))
+            return 1;
 
-            if (pivot > 0 && is_duplicated_or_undoes_move(move_stack[pivot], move_stack[pivot - 1]))
-                continue;
+        // The rest of the batch can still have solutions, as long as this one or longer
+        memmove(&batch[solved], &batch[solved + 1], sizeof(phase2_candidate_t) * (n_batch - solved - 1));
+        n_batch--;
+    }
 
-            assert(move_stack[pivot] <= N_MOVES);
+    return 0;
+}
 
-            coord_apply_move_phase1(cube_stack[pivot], move_stack[pivot]);
-            pruning_stack[pivot] = get_phase1_pruning(cube_stack[pivot]);
-            move_count++;
+// Runs phase2 for the leaves that were put aside by the phase1 search. Returns 1 once the search should stop.
+static int flush_phase1_leaves(solve_context_t *solve_context, solve_list_t **solves, solve_list_t *solves_head,
+                               solve_stats_t *stats) {
+    int n_batch                   = solve_context->n_phase2_batch;
+    solve_context->n_phase2_batch = 0;
 
-            if (is_phase1_solved(cube_stack[pivot])) {
-                end_time = get_microseconds();
+    if (n_batch == 0)
+        return 0;
 
-                stats->phase1_depth      = pivot + 1;
-                stats->phase1_move_count = move_count;
-                stats->phase1_solve_time = (float)(end_time - phase2_time - start_time) / 1000000.0;
+    return solve_phase1_leaf_batch(solve_context, solves, solves_head, stats, solve_context->phase2_batch, n_batch);
+}
 
-                if (solves != NULL) {
-                    solves->stats = stats;
-                }
+// The phase1 solution in move_stack[0..pivot], with the cube of the phase2 context
+static void make_phase2_candidate(const solve_context_t *solve_context, int pivot, int phase2_depth,
+                                  phase2_candidate_t *candidate) {
+    copy_coord_cube(&candidate->cube, solve_context->phase2_context->cube);
+    candidate->view          = (int8_t)solve_context->view->index;
+    candidate->phase1_length = (int8_t)(pivot + 1);
+    candidate->phase2_depth  = (int8_t)phase2_depth;
 
-                move_t *phase1_solution;
-                build_phase1_solution(move_stack, pivot, &solution, &phase1_solution);
+    for (int i = 0; i <= pivot; i++)
+        candidate->moves[i] = (uint8_t)solve_context->move_stack[i];
+}
 
-                if (config->n_solutions == 0) {
-                    if (solves != NULL) {
-                        solves->solution        = solution;
-                        solves->phase1_solution = phase1_solution;
-                    }
-                    get_config()->die = true;
-                    goto solution_found;
-                }
+// Hands the phase1 solution in move_stack[0..pivot] to the phase2 workers. Returns false if the queue is full.
+static bool push_phase1_leaf(solve_context_t *solve_context, int pivot, int phase2_depth) {
+    phase2_candidate_t candidate;
+    make_phase2_candidate(solve_context, pivot, phase2_depth, &candidate);
 
-                // Replay phase1 moves through full coord_apply_move to reconstruct
-                // phase2 coordinates (phase1-only DFS skipped them for performance).
-                // solve_context->cube has prep_moves applied via full coord_apply_move
-                // and is never modified by the DFS — safe to replay from here.
-                coord_cube_t *temp_cube = get_coord_cube();
-                copy_coord_cube(temp_cube, solve_context->cube);
-                for (int i = 0; i <= pivot; i++) {
-                    coord_apply_move(temp_cube, move_stack[i]);
-                }
-                copy_coord_cube(solve_context->phase2_context->cube, temp_cube);
-                free(temp_cube);
+    return push_phase2_candidate(solve_context->phase2_queue, &candidate);
+}
 
-                coord_cube_t *phase2_cube = solve_context->phase2_context->cube;
+// Runs phase2 for the phase1 solution in move_stack[0..pivot], and stores the full solution if one is found.
+// A pivot of -1 stands for an empty phase1 solution. Returns 1 once the search should stop.
+static int solve_phase1_leaf(solve_context_t *solve_context, solve_list_t **solves, solve_list_t *solves_head,
+                             solve_stats_t *stats, int pivot, const uint8_t **solution) {
+    solve_request_t *request    = solve_context->request;
+    move_t          *move_stack = solve_context->move_stack;
 
-                uint64_t phase2_start = get_microseconds();
-                move_t  *phase2_solution =
-                    solve_phase2(solve_context->phase2_context, config,
-                                 config->max_depth - solve_context->prep_move_count - pivot - 1, stats);
-                uint64_t phase2_end = get_microseconds();
-                phase2_time += phase2_end - phase2_start;
-                stats->phase2_attempts++;
+    stats->phase1_depth = pivot + 1;
 
-                if (phase2_solution == NULL) {
-                    free(solution);
-                    solution = NULL;
+    if (*solves != NULL) {
+        (*solves)->stats = stats;
+    }
 
-                    free(phase1_solution);
-                    phase1_solution = NULL;
-                } else {
-                    int phase2_move_count = assemble_full_solution(solution, pivot, phase2_solution, phase2_cube);
-
-                    int is_duplicate = (config->n_solutions > 0) && is_duplicate_solution(solves_head, solution);
-
-                    if (is_duplicate) {
-                        free(solution);
-                        solution = NULL;
-
-                        free(phase1_solution);
-                        phase1_solution = NULL;
-
-                        free(phase2_solution);
-                        phase2_solution = NULL;
-                    } else {
-                        stats->phase2_successes++;
-                        int global_count = atomic_fetch_add(&get_config()->solutions_found, 1) + 1;
-
-                        if (config->n_solutions != -1 && global_count > config->n_solutions) {
-                            free(solution);
-                            free(phase1_solution);
-                            free(phase2_solution);
-                            get_config()->die = true;
-                            goto solution_found;
-                        }
-
-                        record_solution_stats(stats, pivot, phase2_move_count, move_count,
-                                              solve_context->prep_move_count);
-                        store_solution_in_list(&solves, phase1_solution, phase2_solution, solution);
-                        stats->solutions_found++;
-
-                        assert(is_coord_solved(phase2_cube));
-
-                        if (config->n_solutions != -1 && global_count >= config->n_solutions) {
-                            get_config()->die = true;
-                            goto solution_found;
-                        }
-                    }
-                }
+    // Phase2 has to finish within the max depth, or beat the best solution so far in anytime mode
+    int phase2_depth = get_solve_request_bound(request) - pivot - 1;
+
+    if (request->n_solutions != 0 && phase2_depth < 1)
+        return 0;
+
+    if (request->n_solutions == 0) {
+        build_phase1_solution(solve_context, move_stack, pivot);
+
+        if (*solves != NULL) {
+            (*solves)->solution        = copy_solution((*solves)->arena, solve_context->solution);
+            (*solves)->phase1_solution = copy_solution((*solves)->arena, solve_context->phase1_solution);
+            *solution                  = (*solves)->solution;
+        }
+        atomic_store(&request->die, true);
+        return 1;
+    }
+
+    // The phase1 search only tracks the phase1 coords, so the phase2 ones are derived here from the edge
+    // permutation of the cube and the phase1 moves. The phase1 coords are all zero at this point.
+    coord_cube_t *phase2_cube = solve_context->phase2_context->cube;
+    reset_coord_cube(phase2_cube);
+    coord_set_phase2_coords(phase2_cube, solve_context->cube, solve_context->edge_permutations, move_stack,
+                            pivot + 1);
+
+    // With dedicated phase2 workers the search goes on right away, unless they are falling behind
+    if (solve_context->phase2_queue != NULL && push_phase1_leaf(solve_context, pivot, phase2_depth))
+        return 0;
+
+    // Otherwise the leaves can be put aside to be solved together, once there are enough or the task ends
+    if (solve_context->phase2_batch_size > 1) {
+        make_phase2_candidate(solve_context, pivot, phase2_depth,
+                              &solve_context->phase2_batch[solve_context->n_phase2_batch++]);
+
+        if (solve_context->n_phase2_batch < solve_context->phase2_batch_size)
+            return 0;
+
+        return flush_phase1_leaves(solve_context, solves, solves_head, stats);
+    }
+
+    if (solve_context->steps_phase2) {
+        solve_context->has_phase2_leaf   = true;
+        solve_context->phase2_leaf_pivot = pivot;
+        solve_context->phase2_leaf_depth = phase2_depth;
+        return 0;
+    }
+
+    return finish_phase1_leaf(solve_context, solves, solves_head, stats, pivot, phase2_depth, solution);
+}
+
+// Sets up the search of the phase1 solutions of exactly allowed_depth moves that start with the prefix_length moves
+// already in move_stack, whose states are in cube_stack, and expands its root. A depth of 0 only checks if the cube
+// itself is in G1, which is done right away.
+static void start_phase1_search(phase1_search_t *search, solve_context_t *solve_context, solve_list_t *solves,
+                                solve_stats_t *stats, int prefix_length, int allowed_depth) {
+    move_t *move_stack    = solve_context->move_stack;
+    int    *pruning_stack = solve_context->pruning_stack;
+
+    // The root of this subtree, which is never modified by the search
+    const coord_cube_t *cube =
+        prefix_length == 0 ? solve_context->cube : &solve_context->cube_stack[prefix_length - 1];
+
+    search->solves_head = solves;
+    while (solves != NULL && solves->next != NULL)
+        solves = solves->next;
+
+    search->solves         = solves;
+    search->stats          = stats;
+    search->solution       = NULL;
+    search->prefix_length  = prefix_length;
+    search->allowed_depth  = allowed_depth;
+    search->pivot          = prefix_length;
+    search->move_count     = 0;
+    search->iterations     = 0;
+    search->expand_pending = false;
+    search->done           = allowed_depth == 0;
+
+    if (allowed_depth == 0) {
+        if (is_phase1_solved(cube))
+            solve_phase1_leaf(solve_context, &search->solves, search->solves_head, stats, -1, &search->solution);
+
+        return;
+    }
+
+    for (int i = prefix_length; i < MAX_MOVES; i++) {
+        move_stack[i]    = -1;
+        pruning_stack[i] = -1;
+    }
+
+    get_phase1_children(cube, &solve_context->phase1_children[prefix_length]);
+}
+
+// Runs the search until it is over, and returns false. With yield, it stops instead every time it is about to go
+// down to a node, and returns true. The pruning entries of the children of that node are only prefetched then, and
+// it is expanded once the search is run again, by which time they should be in the cache.
+static bool run_phase1_search(phase1_search_t *search, solve_context_t *solve_context, bool yield) {
+    if (search->done)
+        return false;
+
+    const config_t *config = get_config();
+
+    move_t            *move_stack    = solve_context->move_stack;
+    coord_cube_t      *cube_stack    = solve_context->cube_stack;
+    int               *pruning_stack = solve_context->pruning_stack;
+    phase1_children_t *children      = solve_context->phase1_children;
+    solve_request_t   *request       = solve_context->request;
+
+    solve_list_t  *solves_head   = search->solves_head;
+    solve_stats_t *stats         = search->stats;
+    solve_list_t  *solves        = search->solves;
+    int            prefix_length = search->prefix_length;
+    int            allowed_depth = search->allowed_depth;
+    int            pivot         = search->pivot;
+    uint64_t       move_count    = search->move_count;
+    uint64_t       iterations    = search->iterations;
+
+    if (search->expand_pending) {
+        get_phase1_children(&cube_stack[pivot], &children[pivot + 1]);
+        pivot++;
+        search->expand_pending = false;
+    }
+
+    do {
+        if (is_solve_request_done(request) || (++iterations % DEADLINE_CHECK_INTERVAL == 0 &&
+                                               check_solve_request_deadline(request))) {
+            break;
+        }
+
+        // Other threads found solutions short enough that this whole task is pointless now
+        if (allowed_depth > get_phase1_depth_bound(request)) {
+            break;
+        }
+
+        do {
+            move_stack[pivot]++;
+        } while (move_stack[pivot] < N_MOVES && config->move_black_list[move_stack[pivot]] != MOVE_NULL);
+
+        // The pruning value of a level is always written when its move is applied, before it is read, so only the
+        // move needs resetting when the search backs out of it
+        if (move_stack[pivot] >= N_MOVES) {
+            move_stack[pivot] = -1;
+            pivot--;
+
+            if (pivot < prefix_length)
+                break;
+
+            continue;
+        }
+
+        if (pivot > 0 && is_duplicated_or_undoes_move(move_stack[pivot], move_stack[pivot - 1]))
+            continue;
+
+        assert(move_stack[pivot] <= N_MOVES);
+
+        // Only the phase1 coords of the stack are kept up to date, which is all this search reads
+        const phase1_children_t *siblings = &children[pivot];
+        int                      move     = move_stack[pivot];
+
+        cube_stack[pivot].edge_orientations   = siblings->edge_orientations[move];
+        cube_stack[pivot].corner_orientations = siblings->corner_orientations[move];
+        cube_stack[pivot].E_slice             = siblings->E_slice[move];
+        pruning_stack[pivot]                  = siblings->pruning[move];
+        move_count++;
+
+        if (pivot + 1 == allowed_depth && is_phase1_solved(&cube_stack[pivot]) && !is_phase2_move(move_stack[pivot])) {
+            if (solve_phase1_leaf(solve_context, &solves, solves_head, stats, pivot, &search->solution))
+                break;
+
+            if (solve_context->has_phase2_leaf)
+                break;
+        }
+
+        if (pivot + 1 < allowed_depth && pruning_stack[pivot] + pivot < allowed_depth) {
+            if (yield) {
+                prefetch_phase1_children(siblings, move);
+                search->expand_pending = true;
+                break;
             }
 
-            if (pruning_stack[pivot] + pivot < allowed_depth) {
-                copy_coord_cube(cube_stack[pivot + 1], cube_stack[pivot]);
-                pivot++;
-            } else {
-                if (pivot > 0) {
-                    copy_coord_cube(cube_stack[pivot], cube_stack[pivot - 1]);
-                } else {
-                    copy_coord_cube(cube_stack[pivot], cube);
+            // The pruning entries of the next sibling that gets expanded start loading while this one is expanded
+            if (config->prefetch) {
+                for (int next = move + 1; next < N_MOVES; next++) {
+                    if (siblings->pruning[next] + pivot < allowed_depth) {
+                        prefetch_phase1_children(siblings, next);
+                        break;
+                    }
                 }
             }
-        } while (1);
-    }
 
-solution_found:
+            get_phase1_children(&cube_stack[pivot], &children[pivot + 1]);
+            pivot++;
+        }
+    } while (1);
 
-    // We allocate a new node eargely, but the last to be allocated will always
-    // have to be discarted, otherwise we would have an empty node at the end.
-    if (solves != NULL && solves->next != NULL) {
-        destroy_solve_list_node(solves->next);
-        solves->next = NULL;
-    }
+    search->solves     = solves;
+    search->pivot      = pivot;
+    search->move_count = move_count;
+    search->iterations = iterations;
+    search->done       = !search->expand_pending && !solve_context->has_phase2_leaf;
 
-    finalize_solve_stats(stats, start_time, end_time, phase2_time, 0);
+    return !search->done;
+}
 
-    return solution;
+// Runs phase2 on the leaves the search put aside, and returns the last solution it stored, if any
+static const uint8_t *finish_phase1_search(phase1_search_t *search, solve_context_t *solve_context) {
+    search->stats->phase1_move_count += search->move_count;
+
+    flush_phase1_leaves(solve_context, &search->solves, search->solves_head, search->stats);
+
+    return search->solution;
+}
+
+// Searches the phase1 solutions of exactly allowed_depth moves that start with the prefix_length moves already
+// in move_stack, whose states are in cube_stack. A depth of 0 checks if the cube itself is in G1.
+const uint8_t *solve_phase1(solve_context_t *solve_context, solve_list_t *solves, solve_stats_t *stats,
+                            int prefix_length, int allowed_depth) {
+    phase1_search_t search;
+
+    start_phase1_search(&search, solve_context, solves, stats, prefix_length, allowed_depth);
+    run_phase1_search(&search, solve_context, false);
+
+    return finish_phase1_search(&search, solve_context);
 }
 
 // Utility functions for testing
-int is_phase1_moves_solved(const move_t *solution, const coord_cube_t *original_cube) {
+int is_phase1_moves_solved(const uint8_t *solution, const coord_cube_t *original_cube) {
     coord_cube_t *cube = get_coord_cube();
     copy_coord_cube(cube, original_cube);
 
@@ -643,108 +1471,263 @@ int is_phase1_moves_solved(const move_t *solution, const coord_cube_t *original_
     return result;
 }
 
-static move_t *build_phase2_solution(const move_t *moves, const move_t *move_stack, int pivot) {
-    move_t *solution = malloc(sizeof(move_t) * (pivot + 2));
+static const uint8_t *build_phase2_solution(solve_context_t *solve_context, const move_t *moves, int pivot) {
+    uint8_t *solution = solve_context->phase2_solution;
     for (int i = 0; i <= pivot; i++)
-        solution[i] = moves[move_stack[i]];
+        solution[i] = (uint8_t)moves[solve_context->move_stack[i]];
     solution[pivot + 1] = MOVE_NULL;
     return solution;
 }
 
-move_t *solve_phase2(solve_context_t *solve_context, __attribute__((unused)) const config_t *config, int max_depth,
-                     solve_stats_t *stats) {
-    move_t *solution = NULL;
-    move_t  moves[]  = {MOVE_U1, MOVE_U2, MOVE_U3, MOVE_D1, MOVE_D2, MOVE_D3, MOVE_R2, MOVE_L2, MOVE_F2, MOVE_B2};
-    int     n_moves  = 10;
+// Computes the children of a phase2 node ahead of the search, only to prefetch their pruning entries and the move
+// table rows they need if the search goes down to them
+static void prefetch_phase2_children(const coord_cube_t *cube) {
+    coord_cube_t child = *cube;
+
+    for (int move = 0; move < N_PHASE2_MOVES; move++) {
+        coord_get_phase2_child(&child, cube, move);
+        prefetch_phase2_pruning(&child);
+        prefetch_phase2_move_rows(&child);
+    }
+}
+
+// Sets up the phase2 IDA* of the cube of the context for depths up to max_depth. The phase2 cache can answer
+// right away, or tell which depths were already searched. Returns false if there is nothing to search.
+static bool start_phase2_search(phase2_search_t *search, solve_context_t *solve_context, int max_depth,
+                                solve_stats_t *stats) {
+    phase2_cache_t *cache = solve_context->phase2_cache;
+
+    search->stats         = stats;
+    search->solution      = NULL;
+    search->allowed_depth = 1;
+    search->max_depth     = max_depth;
+    search->pivot         = 0;
+    search->move_count    = 0;
+    search->iterations    = 0;
+    search->done          = false;
+    search->is_cached     = false;
+
+    if (cache != NULL) {
+        const phase2_cache_entry_t *entry = get_phase2_cache_entry(cache, solve_context->cube);
+
+        if (entry != NULL && (entry->length >= 0 || max_depth <= entry->searched_depth)) {
+            stats->phase2_cache_hits++;
+
+            if (entry->length >= 0 && entry->length <= max_depth) {
+                get_phase2_cache_solution(entry, solve_context->phase2_solution);
+                search->solution = solve_context->phase2_solution;
+            }
+
+            search->done      = true;
+            search->is_cached = true;
+            return false;
+        }
 
+        // The depths that were already searched have no solution
+        if (entry != NULL)
+            search->allowed_depth = entry->searched_depth + 1;
+    }
+
+    // Only the phase2 coords of the stack are ever written, the phase1 ones stay solved from alloc_solve_context
     for (int i = 0; i < MAX_MOVES; i++) {
         solve_context->move_stack[i]    = -1;
         solve_context->pruning_stack[i] = -1;
-        reset_coord_cube(solve_context->cube_stack[i]);
     }
 
-    copy_coord_cube(solve_context->cube_stack[0], solve_context->cube);
+    return true;
+}
 
-    uint64_t move_count = 0;
+// Runs the search until it is over, and returns false. With yield, it also stops every time it goes down to a node,
+// after prefetching the table entries of its children, and returns true. The search picks up from there when it is
+// run again.
+static bool run_phase2_search(phase2_search_t *search, solve_context_t *solve_context, const config_t *config,
+                              bool yield) {
+    if (search->done)
+        return false;
+
+    const move_t *moves   = get_phase2_moves();
+    int           n_moves = N_PHASE2_MOVES;
+
+    solve_request_t *request = solve_context->request;
 
     const coord_cube_t *cube          = solve_context->cube;
     move_t             *move_stack    = solve_context->move_stack;
-    coord_cube_t      **cube_stack    = solve_context->cube_stack;
+    coord_cube_t       *cube_stack    = solve_context->cube_stack;
     int                *pruning_stack = solve_context->pruning_stack;
 
-    for (int allowed_depth = 1; allowed_depth <= max_depth; allowed_depth++) {
-        int pivot = 0;
-        copy_coord_cube(cube_stack[0], cube);
+    int      allowed_depth = search->allowed_depth;
+    int      pivot         = search->pivot;
+    uint64_t move_count    = search->move_count;
+    uint64_t iterations    = search->iterations;
 
-        /*printf("searching with max depth: %d\n", allowed_depth);*/
+    while (allowed_depth <= search->max_depth) {
+        if (is_solve_request_done(request) || (++iterations % DEADLINE_CHECK_INTERVAL == 0 &&
+                                               check_solve_request_deadline(request))) {
+            break;
+        }
+
+        const coord_cube_t *parent = pivot == 0 ? cube : &cube_stack[pivot - 1];
+
+        if (config->prefetch && (int)move_stack[pivot] == -1 && (!yield || pivot == 0))
+            prefetch_phase2_children(parent);
 
         do {
-            if (get_config()->die) {
-                return NULL;
+            move_stack[pivot]++;
+        } while ((int)move_stack[pivot] < n_moves &&
+                 config->move_black_list[moves[move_stack[pivot]]] != MOVE_NULL);
+
+        // Only the move is reset, pruning_stack[pivot] gets written again before it is read
+        if ((int)move_stack[pivot] >= n_moves) {
+            move_stack[pivot] = -1;
+            pivot--;
+
+            // Nothing left at this depth, the whole tree is searched again one move deeper
+            if (pivot < 0) {
+                pivot = 0;
+                allowed_depth++;
             }
 
-            do {
-                move_stack[pivot]++;
-            } while ((int)move_stack[pivot] < n_moves &&
-                     config->move_black_list[moves[move_stack[pivot]]] != MOVE_NULL);
-
-            if ((int)move_stack[pivot] >= n_moves) {
-                pruning_stack[pivot] = -1; // ?
-                move_stack[pivot]    = -1;
-                /*printf("\n");*/
-                pivot--;
-
-                if (pivot < 0) {
-                    break;
-                } else if (pivot == 0) {
-                    copy_coord_cube(cube_stack[0], cube);
-                } else {
-                    copy_coord_cube(cube_stack[pivot], cube_stack[pivot - 1]);
-                }
+            continue;
+        }
 
-                continue;
-            }
+        if (pivot > 0 && is_duplicated_or_undoes_move(moves[move_stack[pivot]], moves[move_stack[pivot - 1]]))
+            continue;
 
-            if (pivot > 0 && is_duplicated_or_undoes_move(moves[move_stack[pivot]], moves[move_stack[pivot - 1]]))
-                continue;
+        coord_get_phase2_child(&cube_stack[pivot], parent, move_stack[pivot]);
+        move_count++;
 
-            coord_apply_move(cube_stack[pivot], moves[move_stack[pivot]]);
-            pruning_stack[pivot] = get_phase2_pruning(cube_stack[pivot]);
-            move_count++;
+        pruning_stack[pivot] = get_phase2_pruning(&cube_stack[pivot]);
 
-            if (is_phase2_solved(cube_stack[pivot])) {
-                solution = build_phase2_solution(moves, move_stack, pivot);
-                stats->phase2_move_count += move_count;
-                goto solution_found;
-            }
+        if (is_phase2_solved(&cube_stack[pivot])) {
+            search->solution = build_phase2_solution(solve_context, moves, pivot);
+            break;
+        }
 
-            if (pruning_stack[pivot] + pivot < allowed_depth) {
-                copy_coord_cube(cube_stack[pivot + 1], cube_stack[pivot]);
-                pivot++;
-            } else {
-                if (pivot > 0) {
-                    copy_coord_cube(cube_stack[pivot], cube_stack[pivot - 1]);
-                } else {
-                    copy_coord_cube(cube_stack[pivot], cube);
-                }
+        if (pruning_stack[pivot] + pivot < allowed_depth) {
+            pivot++;
+
+            if (yield) {
+                prefetch_phase2_children(&cube_stack[pivot - 1]);
+                goto paused;
             }
-        } while (1);
+        }
     }
 
-    stats->phase2_move_count += move_count;
+    search->done = true;
 
-solution_found:
+paused:
+    search->allowed_depth = allowed_depth;
+    search->pivot         = pivot;
+    search->move_count    = move_count;
+    search->iterations    = iterations;
 
-    return solution;
+    return !search->done;
 }
 
-solve_context_t *make_solve_context(const coord_cube_t *cube) {
+// Returns the phase2 solution found, or NULL, and tells the phase2 cache about it
+static const uint8_t *finish_phase2_search(phase2_search_t *search, solve_context_t *solve_context) {
+    phase2_cache_t *cache = solve_context->phase2_cache;
+
+    search->stats->phase2_move_count += search->move_count;
+
+    // A search that was cut short says nothing about the cube
+    if (cache != NULL && !search->is_cached && !is_solve_request_done(solve_context->request)) {
+        if (search->solution != NULL) {
+            store_phase2_cache_solution(cache, solve_context->cube, search->solution);
+        } else {
+            store_phase2_cache_miss(cache, solve_context->cube, search->max_depth);
+        }
+    }
+
+    return search->solution;
+}
+
+const uint8_t *solve_phase2(solve_context_t *solve_context, const config_t *config, int max_depth,
+                            solve_stats_t *stats) {
+    phase2_search_t search;
+
+    if (start_phase2_search(&search, solve_context, max_depth, stats))
+        run_phase2_search(&search, solve_context, config, false);
+
+    return finish_phase2_search(&search, solve_context);
+}
+
+// Sorts by the index into the phase2 corner pruning table, and then by the one into the edge table
+static int compare_phase2_candidates(const void *a, const void *b) {
+    const coord_cube_t *cube_a = &((const phase2_candidate_t *)a)->cube;
+    const coord_cube_t *cube_b = &((const phase2_candidate_t *)b)->cube;
+
+    int corner_a = cube_a->corner_permutations * N_SORTED_SLICES_PHASE2 + cube_a->E_sorted_slice;
+    int corner_b = cube_b->corner_permutations * N_SORTED_SLICES_PHASE2 + cube_b->E_sorted_slice;
+
+    if (corner_a != corner_b)
+        return corner_a < corner_b ? -1 : 1;
+
+    return (cube_a->UD6_edge_permutations > cube_b->UD6_edge_permutations) -
+           (cube_a->UD6_edge_permutations < cube_b->UD6_edge_permutations);
+}
+
+int solve_phase2_batch(solve_context_t *solve_context, const config_t *config, phase2_candidate_t *candidates,
+                       int n_candidates, const uint8_t **solution, solve_stats_t *stats) {
+    solve_request_t *request = solve_context->request;
+
+    *solution = NULL;
+
+    if (n_candidates == 1) {
+        int phase2_depth =
+            MIN(candidates[0].phase2_depth, get_solve_request_bound(request) - candidates[0].phase1_length);
+
+        if (phase2_depth < 1)
+            return -1;
+
+        copy_coord_cube(solve_context->cube, &candidates[0].cube);
+        *solution = solve_phase2(solve_context, config, phase2_depth, stats);
+
+        return *solution != NULL ? 0 : -1;
+    }
+
+    qsort(candidates, n_candidates, sizeof(phase2_candidate_t), compare_phase2_candidates);
+
+    int min_length = MAX_MOVES;
+    int max_length = 0;
+
+    for (int i = 0; i < n_candidates; i++) {
+        min_length = MIN(min_length, candidates[i].phase1_length + 1);
+        max_length = MAX(max_length, candidates[i].phase1_length + candidates[i].phase2_depth);
+    }
+
+    // The phase2 cache keeps the depth each candidate was searched to, so every pass only searches one more depth
+    for (int length = min_length; length <= MIN(max_length, get_solve_request_bound(request)); length++) {
+        for (int i = 0; i < n_candidates; i++) {
+            int phase2_depth = length - candidates[i].phase1_length;
+
+            if (phase2_depth < 1 || phase2_depth > candidates[i].phase2_depth)
+                continue;
+
+            if (is_solve_request_done(request))
+                return -1;
+
+            copy_coord_cube(solve_context->cube, &candidates[i].cube);
+            *solution = solve_phase2(solve_context, config, phase2_depth, stats);
+
+            if (*solution != NULL)
+                return i;
+        }
+    }
+
+    return -1;
+}
+
+// Contexts that are not part of a solve are never cancelled
+static solve_request_t idle_solve_request;
+
+static solve_context_t *alloc_solve_context() {
     solve_context_t *phase1_context = (solve_context_t *)malloc(sizeof(solve_context_t));
     solve_context_t *phase2_context = (solve_context_t *)malloc(sizeof(solve_context_t));
 
     for (int i = 0; i < MAX_MOVES; i++) {
-        phase1_context->cube_stack[i] = get_coord_cube();
-        phase2_context->cube_stack[i] = get_coord_cube();
+        reset_coord_cube(&phase1_context->cube_stack[i]);
+        reset_coord_cube(&phase2_context->cube_stack[i]);
     }
 
     clear_solve_context(phase1_context);
@@ -753,16 +1736,78 @@ solve_context_t *make_solve_context(const coord_cube_t *cube) {
     phase1_context->cube = get_coord_cube();
     phase2_context->cube = get_coord_cube();
 
-    copy_coord_cube(phase1_context->cube, cube);
-
     phase1_context->phase2_context = phase2_context;
     phase2_context->phase2_context = NULL;
 
-    phase1_context->original_cube = cube;
+    phase1_context->original_cube = NULL;
+    phase2_context->original_cube = NULL;
+
+    phase1_context->request = &idle_solve_request;
+    phase2_context->request = &idle_solve_request;
+
+    phase1_context->view = NULL;
+    phase2_context->view = NULL;
+
+    phase1_context->phase2_cache = NULL;
+    phase2_context->phase2_cache = NULL;
+
+    phase1_context->phase2_queue = NULL;
+    phase2_context->phase2_queue = NULL;
+
+    phase1_context->views = NULL;
+    phase2_context->views = NULL;
+
+    phase1_context->phase2_batch      = (phase2_candidate_t *)malloc(sizeof(phase2_candidate_t) * MAX_PHASE2_BATCH);
+    phase2_context->phase2_batch      = NULL;
+    phase1_context->phase2_batch_size = 0;
+    phase2_context->phase2_batch_size = 0;
+    phase1_context->n_phase2_batch    = 0;
+    phase2_context->n_phase2_batch    = 0;
+
+    phase1_context->steps_phase2    = false;
+    phase2_context->steps_phase2    = false;
+    phase1_context->has_phase2_leaf = false;
+    phase2_context->has_phase2_leaf = false;
 
     return phase1_context;
 }
 
+solve_context_t *make_solve_context(const coord_cube_t *cube) {
+    solve_context_t *solve_context = alloc_solve_context();
+
+    reset_solve_context(solve_context, cube);
+
+    return solve_context;
+}
+
+void reset_solve_context(solve_context_t *solve_context, const coord_cube_t *cube) {
+    clear_solve_context(solve_context);
+    clear_solve_context(solve_context->phase2_context);
+
+    // Only 3% of the phase2 searches hit the cache, which did not pay for its lookups in the benchmarks, so it is
+    // only kept with --phase2-cache
+    solve_context_t *phase2_context = solve_context->phase2_context;
+
+    if (get_config()->phase2_cache && phase2_context->phase2_cache == NULL) {
+        phase2_context->phase2_cache = make_phase2_cache();
+    } else if (!get_config()->phase2_cache && phase2_context->phase2_cache != NULL) {
+        destroy_phase2_cache(phase2_context->phase2_cache);
+        phase2_context->phase2_cache = NULL;
+    }
+
+    // The phase2 results depend on the move blacklist, which can change between solves
+    if (phase2_context->phase2_cache != NULL)
+        clear_phase2_cache(phase2_context->phase2_cache);
+
+    copy_coord_cube(solve_context->cube, cube);
+    coord_get_edge_permutations(solve_context->cube, solve_context->edge_permutations);
+
+    solve_context->original_cube   = cube;
+    solve_context->phase2_time     = 0;
+    solve_context->n_phase2_batch  = 0;
+    solve_context->has_phase2_leaf = false;
+}
+
 void clear_solve_context(solve_context_t *solve_context) {
     for (int i = 0; i < MAX_MOVES; i++) {
         solve_context->move_stack[i]    = -1;
@@ -776,9 +1821,10 @@ void destroy_solve_context(solve_context_t *context) {
     if (context->phase2_context != NULL)
         destroy_solve_context(context->phase2_context);
 
-    for (int i = 0; i < MAX_MOVES; i++) {
-        free(context->cube_stack[i]);
-    }
+    if (context->phase2_cache != NULL)
+        destroy_phase2_cache(context->phase2_cache);
+
+    free(context->phase2_batch);
 
     free(context->cube);
     free(context);
@@ -28,56 +28,142 @@
 
 #include "config.h"
 #include "coord_cube.h"
+#include "phase2_cache.h"
+#include "phase2_queue.h"
+#include "pruning.h"
 #include "solution.h"
+#include "solve_request.h"
 #include "stats.h"
 
 #define MAX_MOVES 30
 
-typedef struct solve_context_s solve_context_t;
+// Phase1 is split into one task per prefix of this many moves and per IDA* depth
+#define PHASE1_PREFIX_LENGTH 2
+
+// The cube is also searched along the other two axes and as its inverse, when six way search is on
+#define MAX_SOLVE_VIEWS 6
+
+// Most phase1 solutions that are put aside to run phase2 on them together
+#define MAX_PHASE2_BATCH 256
+
+typedef struct solve_context_s    solve_context_t;
+typedef struct phase1_scheduler_s phase1_scheduler_t;
+typedef struct solve_worker_s     solve_worker_t;
+
+// The cube seen along one of the three axes, S * C * S^-1, or the inverse of that. The solutions found for it are
+// mapped back to solutions of the original cube.
+typedef struct {
+    coord_cube_t cube;
+    int          index;
+    int          symmetry;
+    bool         is_inverse;
+} solve_view_t;
 
 typedef struct solve_context_s {
     const coord_cube_t *original_cube;
+    const solve_view_t *view;
 
     coord_cube_t *cube;
+    edge_t        edge_permutations[N_EDGES];
     move_t        move_stack[MAX_MOVES];
-    coord_cube_t *cube_stack[MAX_MOVES];
+    coord_cube_t  cube_stack[MAX_MOVES];
     int           pruning_stack[MAX_MOVES];
     int           move_count;
-    move_t        prep_moves[MAX_MOVES];
-    uint8_t       prep_move_count;
 
+    // The children of every node on the phase1 path, all expanded at once when the search goes down to it
+    phase1_children_t phase1_children[MAX_MOVES];
+    uint64_t          phase2_time;
+
+    // Where the solutions are put together before they are kept, so the ones that are not cost nothing
+    uint8_t solution[SOLUTION_CAPACITY];
+    uint8_t phase1_solution[SOLUTION_CAPACITY];
+    uint8_t phase2_solution[SOLUTION_CAPACITY];
+
+    solve_request_t *request;
     solve_context_t *phase2_context;
+
+    // Only the phase2 contexts have one, it is cleared on every solve
+    phase2_cache_t *phase2_cache;
+
+    // Where the phase1 solutions go when phase2 runs on dedicated workers, or NULL to run it inline
+    phase2_queue_t *phase2_queue;
+
+    // The views of the solve, which the queued phase1 solutions refer to
+    const solve_view_t *views;
+
+    // With a batch size above one, the phase1 solutions of a task are put aside and go through phase2 together
+    phase2_candidate_t *phase2_batch;
+    int                 phase2_batch_size;
+    int                 n_phase2_batch;
+
+    // Solves run in steps stop the phase1 search at each leaf, and search phase2 for it over the next steps
+    bool steps_phase2;
+    bool has_phase2_leaf;
+    int  phase2_leaf_pivot;
+    int  phase2_leaf_depth;
 } solve_context_t;
 
 typedef struct thread_context_s {
-    solve_context_t *solve_context;
-    solve_list_t    *solves;
-    solve_stats_t   *stats;
+    solve_context_t    *solve_context;
+    phase1_scheduler_t *scheduler;
+    solve_list_t       *solves;
+    solve_stats_t      *stats;
+    bool                runs_phase2;
 } thread_context_t;
 
-solve_list_t *solve_facelets_single(char facelets[N_FACELETS]);
-solve_list_t *solve_facelets(char facelets[N_FACELETS], const config_t *config);
-solve_list_t *solve(const coord_cube_t *original_cube, const config_t *config);
-solve_list_t *solve_single(const coord_cube_t *original_cube);
-move_t       *solve_phase1(solve_context_t *solve_context, solve_list_t *solves, solve_stats_t *stats);
-move_t *solve_phase2(solve_context_t *solve_context, const config_t *config, int current_depth, solve_stats_t *stats);
-void    prep_phase1(solve_context_t *solve_context, uint16_t move_count, const move_t *move_list);
-move_t *patch_solution(solve_context_t *solve_context, solve_list_t *solution);
+solve_list_t  *solve_facelets_single(char facelets[N_FACELETS]);
+solve_list_t  *solve_facelets(char facelets[N_FACELETS], const config_t *config);
+solve_list_t  *solve(const coord_cube_t *original_cube, const config_t *config);
+solve_list_t  *solve_with_request(const coord_cube_t *original_cube, const config_t *config, solve_request_t *request);
+solve_list_t  *solve_single(const coord_cube_t *original_cube);
+const uint8_t *solve_phase1(solve_context_t *solve_context, solve_list_t *solves, solve_stats_t *stats,
+                            int prefix_length, int allowed_depth);
 
-solve_list_t *solve_thread(void *arg);
+// Returns the phase2 solution of the cube of the context, or NULL. It is kept in the context, and only good until
+// the next phase2 search on it.
+const uint8_t *solve_phase2(solve_context_t *solve_context, const config_t *config, int current_depth,
+                            solve_stats_t *stats);
+
+// Runs phase2 on a batch of G1 states at once, sorted by their phase2 pruning table indexes so that searches close
+// to each other read the same part of the tables. All of them are searched one full solution length at a time,
+// so the first solution found is the shortest one of the batch. Returns the index of that candidate once sorted,
+// with its phase2 solution in *solution, or -1 if none has a solution within its phase2 depth.
+int solve_phase2_batch(solve_context_t *solve_context, const config_t *config, phase2_candidate_t *candidates,
+                       int n_candidates, const uint8_t **solution, solve_stats_t *stats);
 
-solve_list_t *new_solve_list_node();
-void          destroy_solve_list_node(solve_list_t *node);
-void          destroy_solve_list(solve_list_t *solves);
+solve_list_t *solve_thread(void *arg);
 
 solve_context_t *make_solve_context(const coord_cube_t *cube);
+void             reset_solve_context(solve_context_t *solve_context, const coord_cube_t *cube);
 void             clear_solve_context(solve_context_t *solve_context);
 void             destroy_solve_context(solve_context_t *context);
 
+// solve() runs on a persistent pool of config->thread_count workers with preallocated contexts. It is created
+// on the first solve, or earlier with init_solve_pool, and recreated if the thread count changes. The workers
+// pull phase1 tasks from a shared queue, so any number of them can be used. A solve that starts while the pool
+// is busy with another one runs on the calling thread instead.
+//
+// With config->phase2_threads set, that many of the workers only run the phase2 searches, which the others
+// push into a lock-free queue as they find phase1 solutions. Each kind of worker then keeps its own tables in
+// its cache. At least one worker is always left for phase1.
+void init_solve_pool(int thread_count);
+void destroy_solve_pool();
+
+// A worker solves a cube on the calling thread only, reusing its context across solves. Unlike solve(), any
+// number of workers can solve at the same time, which is faster when there are many cubes to solve.
+solve_worker_t *make_solve_worker();
+void            destroy_solve_worker(solve_worker_t *worker);
+solve_list_t   *solve_on_worker(solve_worker_t *worker, const coord_cube_t *original_cube, solve_request_t *request);
+
+// The same solve, run one search node per step, so that one thread can take turns between the solves of many
+// workers. A step that is about to go down to a node of phase1 or phase2 only prefetches the table entries of its
+// children and returns, and the node is searched on the next step, once the steps of the other workers gave them
+// time to load. The request has to outlive the solve. step_solve_on_worker returns false once the solve is over.
+void          start_solve_on_worker(solve_worker_t *worker, const coord_cube_t *original_cube, solve_request_t *request);
+bool          step_solve_on_worker(solve_worker_t *worker);
+solve_list_t *finish_solve_on_worker(solve_worker_t *worker);
+
 // Utility functions for testing
-int  is_phase1_moves_solved(const move_t *solution, const coord_cube_t *original_cube);
-int  are_solutions_equal(const move_t *a, const move_t *b);
-int  is_duplicate_solution(solve_list_t *solves_head, const move_t *solution);
-void truncate_solutions(solve_list_t *solves, int n_solutions);
+int is_phase1_moves_solved(const uint8_t *solution, const coord_cube_t *original_cube);
 
 #endif /* end of include guard */
@@ -0,0 +1,118 @@
+/*
+ * Copyright <2026> <Renan S Silva, aka h3nnn4n>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdalign.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "solve_arena.h"
+
+typedef struct solve_arena_block_s solve_arena_block_t;
+
+struct solve_arena_block_s {
+    solve_arena_block_t *next;
+    size_t               used;
+    size_t               size;
+
+    alignas(max_align_t) unsigned char data[];
+};
+
+struct solve_arena_s {
+    pthread_mutex_t      lock;
+    solve_arena_block_t *blocks;
+};
+
+static solve_arena_block_t *make_solve_arena_block(size_t size) {
+    solve_arena_block_t *block = (solve_arena_block_t *)malloc(sizeof(solve_arena_block_t) + size);
+    assert(block != NULL);
+
+    block->next = NULL;
+    block->used = 0;
+    block->size = size;
+
+    return block;
+}
+
+solve_arena_t *make_solve_arena() {
+    solve_arena_t *arena = (solve_arena_t *)malloc(sizeof(solve_arena_t));
+    assert(arena != NULL);
+
+    pthread_mutex_init(&arena->lock, NULL);
+    arena->blocks = make_solve_arena_block(SOLVE_ARENA_BLOCK_SIZE);
+
+    return arena;
+}
+
+void destroy_solve_arena(solve_arena_t *arena) {
+    if (arena == NULL)
+        return;
+
+    solve_arena_block_t *block = arena->blocks;
+    while (block != NULL) {
+        solve_arena_block_t *next = block->next;
+        free(block);
+        block = next;
+    }
+
+    pthread_mutex_destroy(&arena->lock);
+    free(arena);
+}
+
+void *solve_arena_alloc(solve_arena_t *arena, size_t size) {
+    assert(arena != NULL);
+
+    size = (size + alignof(max_align_t) - 1) & ~(alignof(max_align_t) - 1);
+
+    pthread_mutex_lock(&arena->lock);
+
+    solve_arena_block_t *block = arena->blocks;
+
+    if (block->used + size > block->size) {
+        // A big allocation gets a block of its own behind the current one, which still has room for small ones
+        if (size > SOLVE_ARENA_BLOCK_SIZE / 4) {
+            solve_arena_block_t *big = make_solve_arena_block(size);
+            big->used                = size;
+            big->next                = block->next;
+            block->next              = big;
+
+            pthread_mutex_unlock(&arena->lock);
+
+            memset(big->data, 0, size);
+            return big->data;
+        }
+
+        block         = make_solve_arena_block(SOLVE_ARENA_BLOCK_SIZE);
+        block->next   = arena->blocks;
+        arena->blocks = block;
+    }
+
+    void *memory = block->data + block->used;
+    block->used += size;
+
+    pthread_mutex_unlock(&arena->lock);
+
+    memset(memory, 0, size);
+    return memory;
+}
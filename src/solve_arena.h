@@ -0,0 +1,43 @@
+/*
+ * Copyright <2026> <Renan S Silva, aka h3nnn4n>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef _SOLVE_ARENA
+#define _SOLVE_ARENA
+
+#include <stddef.h>
+
+// Memory is taken from blocks of this size, or a block of its own for anything bigger
+#define SOLVE_ARENA_BLOCK_SIZE 8192
+
+// Everything a solve returns comes from one arena: the list nodes, their solutions and the stats. Nothing is
+// freed on its own, the whole arena goes at once when the list is destroyed. The solver threads can allocate
+// from the same arena at the same time.
+typedef struct solve_arena_s solve_arena_t;
+
+solve_arena_t *make_solve_arena();
+void           destroy_solve_arena(solve_arena_t *arena);
+
+// Returns size bytes of zeroed memory, aligned for any type
+void *solve_arena_alloc(solve_arena_t *arena, size_t size);
+
+#endif /* end of include guard */
@@ -0,0 +1,103 @@
+/*
+ * Copyright <2026> <Renan S Silva, aka h3nnn4n>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include <limits.h>
+
+#include "solve_request.h"
+#include "utils.h"
+
+void init_solve_request(solve_request_t *request, const config_t *config) {
+    atomic_init(&request->die, false);
+    atomic_init(&request->solutions_found, 0);
+    atomic_init(&request->length_bound, INT_MAX);
+
+    for (int i = 0; i <= MAX_REQUEST_SOLUTION_LENGTH; i++)
+        atomic_init(&request->length_counts[i], 0);
+
+    request->max_depth     = config->max_depth;
+    request->n_solutions   = config->n_solutions;
+    request->target_length = config->target_length;
+    request->six_way       = config->six_way;
+
+    set_solve_request_timeout(request, config->timeout);
+}
+
+void set_solve_request_timeout(solve_request_t *request, float timeout) {
+    request->deadline = timeout > 0 ? get_microseconds() + (uint64_t)(timeout * 1000000.0f) : 0;
+}
+
+void cancel_solve_request(solve_request_t *request) { atomic_store(&request->die, true); }
+
+bool is_solve_request_done(const solve_request_t *request) { return atomic_load(&request->die); }
+
+bool check_solve_request_deadline(solve_request_t *request) {
+    if (request->deadline != 0 && get_microseconds() >= request->deadline)
+        cancel_solve_request(request);
+
+    return is_solve_request_done(request);
+}
+
+bool is_solve_request_anytime(const solve_request_t *request) {
+    return (request->deadline != 0 || request->target_length > 0) && request->n_solutions > 0;
+}
+
+int get_solve_request_bound(const solve_request_t *request) {
+    int length_bound = atomic_load_explicit(&request->length_bound, memory_order_relaxed);
+
+    return length_bound < request->max_depth ? length_bound : request->max_depth;
+}
+
+static void lower_atomic_int(atomic_int *value, int bound) {
+    int current = atomic_load(value);
+
+    while (bound < current && !atomic_compare_exchange_weak(value, &current, bound))
+        ;
+}
+
+bool add_solve_request_solution(solve_request_t *request, int length) {
+    if (!is_solve_request_anytime(request))
+        return true;
+
+    if (length > get_solve_request_bound(request) || length > MAX_REQUEST_SOLUTION_LENGTH)
+        return false;
+
+    atomic_fetch_add(&request->length_counts[length], 1);
+
+    // Once n_solutions are known, only solutions shorter than the longest of them are worth finding. Two threads
+    // racing here can keep a few more solutions than needed, which are dropped when the results are sorted.
+    int found = 0;
+    for (int i = 0; i <= MAX_REQUEST_SOLUTION_LENGTH; i++) {
+        found += atomic_load(&request->length_counts[i]);
+
+        if (found >= request->n_solutions) {
+            lower_atomic_int(&request->length_bound, i - 1);
+
+            if (i <= request->target_length)
+                cancel_solve_request(request);
+
+            break;
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,84 @@
+/*
+ * Copyright <2026> <Renan S Silva, aka h3nnn4n>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef _SOLVE_REQUEST
+#define _SOLVE_REQUEST
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "config.h"
+
+// How many search steps go by between two looks at the clock when the solve has a deadline
+#define DEADLINE_CHECK_INTERVAL 1024
+
+// Longest solution a request keeps track of, no solver goes deeper than this
+#define MAX_REQUEST_SOLUTION_LENGTH 32
+
+// Everything that belongs to a single solve. The solvers only read the tables and the global config besides
+// it, so any number of solves with different requests can run at the same time.
+typedef struct {
+    // Set by the solver once it found enough solutions, or by anyone else to cancel the solve
+    atomic_bool die;
+    atomic_int  solutions_found;
+
+    int max_depth;
+    int n_solutions;
+
+    // Stops as soon as the n_solutions shortest solutions found are this long or shorter, or 0 to not stop early
+    int target_length;
+
+    // Searches the cube along all three axes and as its inverse at once
+    bool six_way;
+
+    // In microseconds, as given by get_microseconds, or 0 for no time limit
+    uint64_t deadline;
+
+    // In anytime mode, the longest solution that can still make it into the n_solutions shortest ones, which
+    // only goes down as solutions are found. length_counts counts the solutions found of each length.
+    atomic_int length_bound;
+    atomic_int length_counts[MAX_REQUEST_SOLUTION_LENGTH + 1];
+} solve_request_t;
+
+// Starts a request with the limits of the config. The timeout starts counting here.
+void init_solve_request(solve_request_t *request, const config_t *config);
+void set_solve_request_timeout(solve_request_t *request, float timeout);
+void cancel_solve_request(solve_request_t *request);
+bool is_solve_request_done(const solve_request_t *request);
+
+// Cancels the request if its deadline passed, and returns whether it is done
+bool check_solve_request_deadline(solve_request_t *request);
+
+// With a time limit or a target length and a fixed number of solutions wanted, the solvers keep looking for
+// shorter solutions until the time runs out or the target is reached, and return the shortest ones found
+bool is_solve_request_anytime(const solve_request_t *request);
+
+// The longest solution that is still worth finding
+int get_solve_request_bound(const solve_request_t *request);
+
+// Records a solution of the given length, and cancels the request once the target length is reached. Returns
+// false if it was beaten by the other threads in the meantime, and should be dropped.
+bool add_solve_request_solution(solve_request_t *request, int length);
+
+#endif /* end of include guard */
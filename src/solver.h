@@ -27,6 +27,7 @@
 #include "config.h"
 #include "puzzle.h"
 #include "solution.h"
+#include "solve_request.h"
 
 void init_registry(void);
 
@@ -37,7 +38,7 @@ struct solver_ops_s {
     const char *puzzle_name;
 
     void (*init)(void);
-    solve_list_t *(*solve)(const puzzle_t *puzzle, const config_t *cfg);
+    solve_list_t *(*solve)(const puzzle_t *puzzle, const config_t *cfg, solve_request_t *request);
     void (*cleanup)(void);
 };
 
@@ -47,5 +48,7 @@ const solver_ops_t *solver_lookup(const char *puzzle_name);
 int                 solver_count(void);
 const solver_ops_t *solver_by_index(int index);
 solve_list_t       *solve_puzzle(const char *puzzle_name, const char *state_str, const config_t *cfg);
+solve_list_t       *solve_puzzle_with_request(const char *puzzle_name, const char *state_str, const config_t *cfg,
+                                              solve_request_t *request);
 
 #endif
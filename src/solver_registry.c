@@ -21,6 +21,7 @@
  *
  */
 
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -109,21 +110,26 @@ const solver_ops_t *solver_by_index(int index) {
     return solver_registry[index];
 }
 
-static int initialized = 0;
-
-void init_registry(void) {
-    if (initialized)
-        return;
+static pthread_once_t registry_once = PTHREAD_ONCE_INIT;
 
+static void register_all(void) {
     puzzle_register(&puzzle_2x2_ops);
     puzzle_register(&puzzle_3x3_ops);
     solver_register(&solver_2x2_ida_ops);
     solver_register(&solver_3x3_kociemba_ops);
-
-    initialized = 1;
 }
 
+void init_registry(void) { pthread_once(&registry_once, register_all); }
+
 solve_list_t *solve_puzzle(const char *puzzle_name, const char *state_str, const config_t *cfg) {
+    solve_request_t request;
+    init_solve_request(&request, cfg);
+
+    return solve_puzzle_with_request(puzzle_name, state_str, cfg, &request);
+}
+
+solve_list_t *solve_puzzle_with_request(const char *puzzle_name, const char *state_str, const config_t *cfg,
+                                        solve_request_t *request) {
     init_registry();
 
     const solver_ops_t *solver = solver_lookup(puzzle_name);
@@ -144,7 +150,7 @@ solve_list_t *solve_puzzle(const char *puzzle_name, const char *state_str, const
 
     solver->init();
 
-    solve_list_t *solution = solver->solve(puzzle, cfg);
+    solve_list_t *solution = solver->solve(puzzle, cfg, request);
 
     puzzle_destroy(puzzle);
 
@@ -34,6 +34,7 @@
 #include "puzzle_2x2.h"
 #include "solver_2x2_ida.h"
 #include "stats.h"
+#include "thread_pool.h"
 #include "utils.h"
 
 #define N_CORNER_ORIENTATION 2187
@@ -236,6 +237,8 @@ typedef struct {
 
     coord_t initial;
     move_t  prep_move;
+
+    solve_request_t *request;
 } solver_ctx_t;
 
 typedef struct {
@@ -244,6 +247,24 @@ typedef struct {
     solve_stats_t *stats;
 } thread_ctx_t;
 
+// Persistent workers, reused by every solve. A solve that starts while they are busy with another one runs its
+// tasks on the calling thread instead.
+static thread_pool_t  *pool      = NULL;
+static pthread_mutex_t pool_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// Expects pool_lock to be held
+static void init_pool(const config_t *config) {
+    int n_workers = MAX_THREADS < config->thread_count ? MAX_THREADS : (int)config->thread_count;
+
+    if (pool != NULL && thread_pool_size(pool) == n_workers)
+        return;
+
+    if (pool != NULL)
+        thread_pool_destroy(pool);
+
+    pool = thread_pool_create(n_workers);
+}
+
 static int is_duplicated_or_undoes_move_2x2(int move_idx, int prev_idx) {
     move_t m  = moves[move_idx];
     move_t pm = moves[prev_idx];
@@ -262,19 +283,31 @@ static int is_duplicated_or_undoes_move_2x2(int move_idx, int prev_idx) {
 
 static int is_solved(const coord_t *state) { return state->corner_orientation == 0 && state->corner_permutation == 0; }
 
+// Looks the children of a node up ahead of the search, only to prefetch their pruning entries
+static void prefetch_children(const coord_t *cube) {
+    const int *orientation_row = corner_orientation_move_table[cube->corner_orientation];
+    const int *permutation_row = corner_permutation_move_table[cube->corner_permutation];
+
+    for (int move_idx = 0; move_idx < N_MOVES_2X2; move_idx++) {
+        __builtin_prefetch(&corner_orientation_pruning[orientation_row[move_idx]]);
+        __builtin_prefetch(&corner_permutation_pruning[permutation_row[move_idx]]);
+    }
+}
+
 static void search(solver_ctx_t *ctx, solve_list_t *solves, solve_stats_t *stats) {
     const config_t *config    = get_config();
-    int             max_depth = config->max_depth;
+    int             max_depth = ctx->request->max_depth;
 
     if (max_depth > MAX_DEPTH)
         max_depth = MAX_DEPTH;
 
     uint64_t start_time = get_microseconds();
+    uint64_t iterations = 0;
 
     if (is_solved(&ctx->initial)) {
-        move_t *solution = (move_t *)malloc(sizeof(move_t) * 2);
-        solution[0]      = ctx->prep_move;
-        solution[1]      = MOVE_NULL;
+        uint8_t *solution = new_solution(solves->arena);
+        solution[0]       = ctx->prep_move;
+        solution[1]       = MOVE_NULL;
 
         stats->solution_length = ctx->prep_move != MOVE_NULL ? 1 : 0;
         stats->phase1_depth    = 1;
@@ -282,7 +315,7 @@ static void search(solver_ctx_t *ctx, solve_list_t *solves, solve_stats_t *stats
         solves->solution = solution;
         solves->stats    = stats;
 
-        get_config()->die = true;
+        cancel_solve_request(ctx->request);
         return;
     }
 
@@ -292,11 +325,16 @@ static void search(solver_ctx_t *ctx, solve_list_t *solves, solve_stats_t *stats
         ctx->cube_stack[0] = ctx->initial;
 
         do {
-            if (get_config()->die) {
+            if (is_solve_request_done(ctx->request) ||
+                (++iterations % DEADLINE_CHECK_INTERVAL == 0 && check_solve_request_deadline(ctx->request))) {
                 finalize_solve_stats(stats, start_time, start_time, 0, 1);
                 return;
             }
 
+            // Nothing was applied to the cube at pivot yet, so it still holds the parent
+            if (config->prefetch && ctx->move_stack[pivot] == -1)
+                prefetch_children(&ctx->cube_stack[pivot]);
+
             do {
                 ctx->move_stack[pivot]++;
             } while (ctx->move_stack[pivot] < N_MOVES_2X2 &&
@@ -340,8 +378,8 @@ static void search(solver_ctx_t *ctx, solve_list_t *solves, solve_stats_t *stats
                 stats->phase1_depth    = found_len;
                 stats->solution_length = found_len + (ctx->prep_move != MOVE_NULL ? 1 : 0);
 
-                move_t *solution = (move_t *)malloc(sizeof(move_t) * (found_len + 2));
-                int     idx      = 0;
+                uint8_t *solution = new_solution(solves->arena);
+                int      idx      = 0;
 
                 if (ctx->prep_move != MOVE_NULL)
                     solution[idx++] = ctx->prep_move;
@@ -354,7 +392,7 @@ static void search(solver_ctx_t *ctx, solve_list_t *solves, solve_stats_t *stats
                 solves->solution = solution;
                 solves->stats    = stats;
 
-                get_config()->die = true;
+                cancel_solve_request(ctx->request);
                 return;
             }
 
@@ -374,7 +412,7 @@ static void search(solver_ctx_t *ctx, solve_list_t *solves, solve_stats_t *stats
     finalize_solve_stats(stats, start_time, start_time, 0, 0);
 }
 
-static void *solve_thread(void *arg) {
+static void solve_thread(void *arg) {
     thread_ctx_t *tc = (thread_ctx_t *)arg;
 
     if (tc->ctx->prep_move != MOVE_NULL) {
@@ -396,11 +434,9 @@ static void *solve_thread(void *arg) {
     }
 
     search(tc->ctx, tc->solves, tc->stats);
-
-    return tc->solves;
 }
 
-static solve_list_t *solve(const puzzle_t *puzzle, const config_t *config) {
+static solve_list_t *solve(const puzzle_t *puzzle, const config_t *config, solve_request_t *request) {
     const cube_2x2_t *cubie = (const cube_2x2_t *)puzzle->state;
     coord_t           initial;
 
@@ -408,33 +444,30 @@ static solve_list_t *solve(const puzzle_t *puzzle, const config_t *config) {
     initial.corner_permutation = encode_corner_permutation(cubie);
 
     if (initial.corner_orientation == 0 && initial.corner_permutation == 0) {
-        solve_list_t *trivial       = new_solve_list_node();
-        trivial->solution           = (move_t *)malloc(sizeof(move_t));
-        trivial->solution[0]        = MOVE_NULL;
-        trivial->phase1_solution    = (move_t *)malloc(sizeof(move_t));
-        trivial->phase1_solution[0] = MOVE_NULL;
-        trivial->phase2_solution    = (move_t *)malloc(sizeof(move_t));
-        trivial->phase2_solution[0] = MOVE_NULL;
-
-        solve_stats_t *stats   = get_solve_stats();
-        stats->solution_length = 0;
-        trivial->stats         = stats;
+        solve_arena_t *arena     = make_solve_arena();
+        solve_list_t  *trivial   = new_solve_list_node(arena);
+        trivial->solution        = new_solution(arena);
+        trivial->phase1_solution = new_solution(arena);
+        trivial->phase2_solution = new_solution(arena);
+        trivial->stats           = new_solve_stats(arena);
 
         return trivial;
     }
 
-    get_config()->die = false;
-    atomic_store(&get_config()->solutions_found, 0);
+    // Every thread allocates from the arena of the solve, which ends up owned by the winner's list
+    solve_arena_t *arena = make_solve_arena();
 
-    int            n_threads = N_MOVES_2X2 < config->thread_count ? N_MOVES_2X2 : config->thread_count;
+    // There is one task per first move, no matter how many workers run them
+    int            n_threads = N_MOVES_2X2;
     solver_ctx_t   contexts[MAX_THREADS];
     thread_ctx_t   thread_contexts[MAX_THREADS];
+    void          *thread_args[MAX_THREADS];
     solve_stats_t *all_stats[MAX_THREADS];
-    pthread_t      threads[MAX_THREADS];
 
     for (int i = 0; i < n_threads; i++) {
         contexts[i].initial   = initial;
         contexts[i].prep_move = moves[i];
+        contexts[i].request   = request;
 
         for (int j = 0; j < MAX_DEPTH; j++) {
             contexts[i].move_stack[j]    = -1;
@@ -442,21 +475,24 @@ static solve_list_t *solve(const puzzle_t *puzzle, const config_t *config) {
         }
 
         thread_contexts[i].ctx    = &contexts[i];
-        thread_contexts[i].solves = new_solve_list_node();
-        thread_contexts[i].stats  = get_solve_stats();
+        thread_contexts[i].solves = new_solve_list_node(arena);
+        thread_contexts[i].stats  = new_solve_stats(arena);
 
-        all_stats[i] = thread_contexts[i].stats;
+        all_stats[i]   = thread_contexts[i].stats;
+        thread_args[i] = &thread_contexts[i];
     }
 
-    for (int i = 0; i < n_threads; i++)
-        pthread_create(&threads[i], NULL, solve_thread, &thread_contexts[i]);
-
-    for (int i = 0; i < n_threads; i++)
-        pthread_join(threads[i], NULL);
+    if (pthread_mutex_trylock(&pool_lock) == 0) {
+        init_pool(config);
+        thread_pool_run(pool, solve_thread, thread_args, n_threads);
+        pthread_mutex_unlock(&pool_lock);
+    } else {
+        for (int i = 0; i < n_threads; i++)
+            solve_thread(thread_args[i]);
+    }
 
-    solve_list_t *solves       = NULL;
-    int           shortest_len = MAX_DEPTH + 1;
-    int           winner_idx   = -1;
+    int shortest_len = MAX_DEPTH + 1;
+    int winner_idx   = -1;
 
     for (int i = 0; i < n_threads; i++) {
         solve_list_t *ts = thread_contexts[i].solves;
@@ -473,42 +509,28 @@ static solve_list_t *solve(const puzzle_t *puzzle, const config_t *config) {
         }
     }
 
-    int is_winner[MAX_THREADS];
-
-    for (int i = 0; i < n_threads; i++) {
-        is_winner[i] = 0;
-
-        solve_list_t *ts = thread_contexts[i].solves;
-
-        if (i == winner_idx) {
-            is_winner[i] = 1;
-            solves       = ts;
-            solves->next = NULL;
-        } else {
-            ts->stats = NULL;
-            destroy_solve_list(ts);
-        }
+    if (winner_idx < 0) {
+        destroy_solve_arena(arena);
+        return NULL;
     }
 
-    if (solves != NULL) {
-        int all_lengths[MAX_DEPTH] = {0};
-        int n_lengths              = 0;
+    // The other threads' solutions stay in the arena until the list is destroyed
+    solve_list_t *solves = thread_contexts[winner_idx].solves;
+    solves->next         = NULL;
 
-        for (const solve_list_t *n = solves; n != NULL && n->solution != NULL; n = n->next) {
-            int len = 0;
-            while (n->solution[len] != MOVE_NULL)
-                len++;
-            if (n_lengths < MAX_DEPTH)
-                all_lengths[n_lengths++] = len;
-        }
+    int all_lengths[MAX_DEPTH] = {0};
+    int n_lengths              = 0;
 
-        solves->aggregate = compute_aggregate_stats(all_stats, n_threads, all_lengths, n_lengths);
+    for (const solve_list_t *n = solves; n != NULL && n->solution != NULL; n = n->next) {
+        int len = 0;
+        while (n->solution[len] != MOVE_NULL)
+            len++;
+        if (n_lengths < MAX_DEPTH)
+            all_lengths[n_lengths++] = len;
     }
 
-    for (int i = 0; i < n_threads; i++) {
-        if (!is_winner[i])
-            free(all_stats[i]);
-    }
+    solves->aggregate = solve_arena_alloc(arena, sizeof(aggregate_stats_t));
+    compute_aggregate_stats(solves->aggregate, all_stats, n_threads, all_lengths, n_lengths);
 
     return solves;
 }
@@ -521,34 +543,56 @@ static void init(void) {
     build_corner_orientation_move_table();
     build_corner_permutation_move_table();
 
-    int loaded_orientation = pruning_table_cache_load("pruning_tables", "2x2_corner_orientation",
-                                                      &corner_orientation_pruning, N_CORNER_ORIENTATION);
-    int loaded_permutation = pruning_table_cache_load("pruning_tables", "2x2_corner_permutation",
-                                                      &corner_permutation_pruning, N_CORNER_PERMUTATION);
+    cache_layout_t orientation_layout = {
+        .element_bits = 32,
+        .dims         = {N_CORNER_ORIENTATION, 0, 0},
+        .move_set     = cache_move_set(moves, N_MOVES_2X2),
+    };
+    cache_layout_t permutation_layout = {
+        .element_bits = 32,
+        .dims         = {N_CORNER_PERMUTATION, 0, 0},
+        .move_set     = cache_move_set(moves, N_MOVES_2X2),
+    };
+
+    int loaded_orientation = pruning_table_cache_load("pruning_tables", "2x2_corner_orientation", &orientation_layout,
+                                                      (void **)&corner_orientation_pruning);
+    int loaded_permutation = pruning_table_cache_load("pruning_tables", "2x2_corner_permutation", &permutation_layout,
+                                                      (void **)&corner_permutation_pruning);
 
     if (!loaded_orientation) {
         corner_orientation_pruning = build_pruning_table(N_CORNER_ORIENTATION, corner_orientation_move_table);
-        pruning_table_cache_store("pruning_tables", "2x2_corner_orientation", corner_orientation_pruning,
-                                  N_CORNER_ORIENTATION);
+        pruning_table_cache_store("pruning_tables", "2x2_corner_orientation", &orientation_layout,
+                                  corner_orientation_pruning);
     }
 
     if (!loaded_permutation) {
         corner_permutation_pruning = build_pruning_table(N_CORNER_PERMUTATION, corner_permutation_move_table);
-        pruning_table_cache_store("pruning_tables", "2x2_corner_permutation", corner_permutation_pruning,
-                                  N_CORNER_PERMUTATION);
+        pruning_table_cache_store("pruning_tables", "2x2_corner_permutation", &permutation_layout,
+                                  corner_permutation_pruning);
     }
 
+    pruning_table_cache_flush();
+
+    pthread_mutex_lock(&pool_lock);
+    init_pool(get_config());
+    pthread_mutex_unlock(&pool_lock);
+
     tables_built = 1;
 }
 
 static void cleanup(void) {
+    pthread_mutex_lock(&pool_lock);
+    thread_pool_destroy(pool);
+    pool = NULL;
+    pthread_mutex_unlock(&pool_lock);
+
     if (corner_orientation_pruning != NULL) {
-        free(corner_orientation_pruning);
+        pruning_table_cache_release(corner_orientation_pruning);
         corner_orientation_pruning = NULL;
     }
 
     if (corner_permutation_pruning != NULL) {
-        free(corner_permutation_pruning);
+        pruning_table_cache_release(corner_permutation_pruning);
         corner_permutation_pruning = NULL;
     }
 
@@ -27,24 +27,30 @@
 #include "cubie_move_table.h"
 #include "move_tables.h"
 #include "pruning.h"
+#include "pruning_cache.h"
 #include "solve.h"
 
 static void init(void) {
     build_move_tables();
     build_pruning_tables();
+    pruning_table_cache_flush();
+    init_solve_pool(get_config()->thread_count);
 }
 
-static solve_list_t *solver_3x3_solve(const puzzle_t *puzzle, const config_t *config) {
+static solve_list_t *solver_3x3_solve(const puzzle_t *puzzle, const config_t *config, solve_request_t *request) {
     cube_cubie_t *cubie    = (cube_cubie_t *)puzzle->state;
     coord_cube_t *coord    = make_coord_cube(cubie);
-    solve_list_t *solution = solve(coord, config);
+    solve_list_t *solution = solve_with_request(coord, config, request);
 
     free(coord);
 
     return solution;
 }
 
-static void cleanup(void) { purge_cubie_move_table(); }
+static void cleanup(void) {
+    destroy_solve_pool();
+    purge_cubie_move_table();
+}
 
 const solver_ops_t solver_3x3_kociemba_ops = {
     .name        = "kociemba",
@@ -53,11 +53,11 @@ static void extract_int(solve_stats_t **thread_stats, int n, int *out, size_t fi
     }
 }
 
-aggregate_stats_t *compute_aggregate_stats(solve_stats_t **thread_stats, int thread_count, const int *solution_lengths,
-                                           int n_solution_lengths) {
-    aggregate_stats_t *agg = calloc(1, sizeof(aggregate_stats_t));
+void compute_aggregate_stats(aggregate_stats_t *agg, solve_stats_t **thread_stats, int thread_count,
+                             const int *solution_lengths, int n_solution_lengths) {
     assert(agg != NULL);
 
+    memset(agg, 0, sizeof(aggregate_stats_t));
     agg->thread_count = thread_count;
 
     if (thread_count == 0) {
@@ -65,7 +65,7 @@ aggregate_stats_t *compute_aggregate_stats(solve_stats_t **thread_stats, int thr
         agg->solution_lengths_max   = 0;
         agg->solution_lengths_avg   = 0.0f;
         agg->solution_lengths_count = 0;
-        return agg;
+        return;
     }
 
     float buf_f[thread_count];
@@ -105,7 +105,7 @@ aggregate_stats_t *compute_aggregate_stats(solve_stats_t **thread_stats, int thr
                           &agg->solutions_found.p95, &agg->solutions_found.p99);
 
     int64_t total_m   = 0;
-    int     total_p2a = 0, total_p2s = 0;
+    int     total_p2a = 0, total_p2s = 0, total_p2h = 0;
     int     died     = 0;
     float   max_wall = 0.0f;
     for (int i = 0; i < thread_count; i++) {
@@ -113,6 +113,7 @@ aggregate_stats_t *compute_aggregate_stats(solve_stats_t **thread_stats, int thr
         total_m += s->total_moves;
         total_p2a += s->phase2_attempts;
         total_p2s += s->phase2_successes;
+        total_p2h += s->phase2_cache_hits;
         died += s->die_aborted;
         if (s->wall_time > max_wall)
             max_wall = s->wall_time;
@@ -123,6 +124,7 @@ aggregate_stats_t *compute_aggregate_stats(solve_stats_t **thread_stats, int thr
     agg->overall_moves_per_second = max_wall > 0.0f ? (float)total_m / max_wall : 0.0f;
     agg->total_phase2_attempts    = total_p2a;
     agg->total_phase2_successes   = total_p2s;
+    agg->total_phase2_cache_hits  = total_p2h;
     agg->phase2_success_rate      = total_p2a > 0 ? (float)total_p2s / (float)total_p2a * 100.0f : 0.0f;
     agg->threads_die_aborted      = died;
     agg->threads_completed        = thread_count - died;
@@ -153,8 +155,6 @@ aggregate_stats_t *compute_aggregate_stats(solve_stats_t **thread_stats, int thr
         agg->solution_lengths_avg   = 0.0f;
         agg->solution_lengths_count = 0;
     }
-
-    return agg;
 }
 
 static void print_float_aggregate(const char *label, const float_aggregate_t *a) {
@@ -218,6 +218,7 @@ void print_aggregate_stats(const aggregate_stats_t *agg, const solve_stats_t *fi
             printf("  Phase 2 attempts:     %d\n", agg->total_phase2_attempts);
             printf("  Phase 2 successes:    %d\n", agg->total_phase2_successes);
             printf("  Phase 2 success rate: %.2f%%\n", agg->phase2_success_rate);
+            printf("  Phase 2 cache hits:   %d\n", agg->total_phase2_cache_hits);
             printf("\n");
         }
 
@@ -250,3 +251,7 @@ solve_stats_t *get_solve_stats() {
     memset(stats, 0, sizeof(solve_stats_t));
     return stats;
 }
+
+solve_stats_t *new_solve_stats(solve_arena_t *arena) {
+    return (solve_stats_t *)solve_arena_alloc(arena, sizeof(solve_stats_t));
+}
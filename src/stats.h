@@ -26,6 +26,8 @@
 
 #include <stdint.h>
 
+#include "solve_arena.h"
+
 typedef struct {
     int phase1_depth;
     int phase2_depth;
@@ -35,6 +37,7 @@ typedef struct {
     int phase2_move_count;
     int phase2_attempts;
     int phase2_successes;
+    int phase2_cache_hits;
     int solutions_found;
     int die_aborted;
 
@@ -70,6 +73,7 @@ typedef struct {
 
     int   total_phase2_attempts;
     int   total_phase2_successes;
+    int   total_phase2_cache_hits;
     float phase2_success_rate;
 
     int threads_die_aborted;
@@ -84,12 +88,15 @@ typedef struct {
 void finalize_solve_stats(solve_stats_t *stats, uint64_t start_us, uint64_t end_us, uint64_t total_phase2_time_us,
                           int die_aborted);
 
-aggregate_stats_t *compute_aggregate_stats(solve_stats_t **thread_stats, int thread_count, const int *solution_lengths,
-                                           int n_solution_lengths);
+void compute_aggregate_stats(aggregate_stats_t *agg, solve_stats_t **thread_stats, int thread_count,
+                             const int *solution_lengths, int n_solution_lengths);
 
 void print_aggregate_stats(const aggregate_stats_t *agg, const solve_stats_t *first_solution);
 
 void           print_solve_stats(const solve_stats_t *stats);
 solve_stats_t *get_solve_stats();
 
+// All zero like get_solve_stats, but from the arena of a solve
+solve_stats_t *new_solve_stats(solve_arena_t *arena);
+
 #endif
@@ -0,0 +1,298 @@
+/*
+ * Copyright <2026> <Renan S Silva, aka h3nnn4n>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "cubie_cube.h"
+#include "cubie_move_table.h"
+#include "definitions.h"
+#include "symmetry.h"
+#include "utils.h"
+
+// 120° clockwise rotation around the long diagonal URF-DBL
+static const corner_t corner_permutation_ROT_URF3[] = {URF, DFR, DLF, UFL, UBR, DRB, DBL, ULB};
+static const int      corner_orientation_ROT_URF3[] = {1, 2, 1, 2, 2, 1, 2, 1};
+static const edge_t   edge_permutation_ROT_URF3[]   = {UF, FR, DF, FL, UB, BR, DB, BL, UR, DR, DL, UL};
+static const int      edge_orientation_ROT_URF3[]   = {1, 0, 1, 0, 1, 0, 1, 0, 1, 1, 1, 1};
+
+// 180° rotation around the axis through the F and B centers
+static const corner_t corner_permutation_ROT_F2[] = {DLF, DFR, DRB, DBL, UFL, URF, UBR, ULB};
+static const int      corner_orientation_ROT_F2[] = {0, 0, 0, 0, 0, 0, 0, 0};
+static const edge_t   edge_permutation_ROT_F2[]   = {DL, DF, DR, DB, UL, UF, UR, UB, FL, FR, BR, BL};
+static const int      edge_orientation_ROT_F2[]   = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+
+// 90° clockwise rotation around the axis through the U and D centers
+static const corner_t corner_permutation_ROT_U4[] = {UBR, URF, UFL, ULB, DRB, DFR, DLF, DBL};
+static const int      corner_orientation_ROT_U4[] = {0, 0, 0, 0, 0, 0, 0, 0};
+static const edge_t   edge_permutation_ROT_U4[]   = {UB, UR, UF, UL, DB, DR, DF, DL, BR, FR, FL, BL};
+static const int      edge_orientation_ROT_U4[]   = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1};
+
+// Reflection at the plane through the U, D, F and B centers. Mirrored corners use orientations 3..5
+static const corner_t corner_permutation_MIRR_LR2[] = {UFL, URF, UBR, ULB, DLF, DFR, DRB, DBL};
+static const int      corner_orientation_MIRR_LR2[] = {3, 3, 3, 3, 3, 3, 3, 3};
+static const edge_t   edge_permutation_MIRR_LR2[]   = {UL, UF, UR, UB, DL, DF, DR, DB, FL, FR, BR, BL};
+static const int      edge_orientation_MIRR_LR2[]   = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+
+static cube_cubie_t   symmetry_cubes[N_SYMMETRIES];
+static int            inverse_symmetry[N_SYMMETRIES];
+static move_t         conjugate_move[N_SYMMETRIES * N_MOVES];
+static pthread_once_t symmetry_cubes_once = PTHREAD_ONCE_INIT;
+
+static uint16_t *flipslice_classidx        = NULL;
+static uint8_t  *flipslice_sym             = NULL;
+static uint32_t *flipslice_rep             = NULL;
+static uint16_t *flipslice_self_symmetries = NULL;
+static uint16_t *twist_conj                = NULL;
+
+const uint16_t *get_flipslice_classidx_table() { return flipslice_classidx; }
+const uint8_t  *get_flipslice_sym_table() { return flipslice_sym; }
+const uint32_t *get_flipslice_rep_table() { return flipslice_rep; }
+const uint16_t *get_flipslice_self_symmetries_table() { return flipslice_self_symmetries; }
+const uint16_t *get_twist_conj_table() { return twist_conj; }
+
+static void load_basic_symmetry(cube_cubie_t *cube, const corner_t *cp, const int *co, const edge_t *ep,
+                                const int *eo) {
+    for (int i = 0; i < N_CORNERS; i++) {
+        cube->corner_permutations[i] = cp[i];
+        cube->corner_orientations[i] = co[i];
+    }
+
+    for (int i = 0; i < N_EDGES; i++) {
+        cube->edge_permutations[i] = ep[i];
+        cube->edge_orientations[i] = eo[i];
+    }
+}
+
+// Mirrored cubes do not pass is_valid, so this skips the checks done by multiply_cube_cubie
+static void multiply_symmetry(cube_cubie_t *cube1, cube_cubie_t *cube2) {
+    multiply_cube_cubie_edges(cube1, cube2);
+    multiply_cube_cubie_corners(cube1, cube2);
+}
+
+static int is_identity(const cube_cubie_t *cube) {
+    for (int i = 0; i < N_CORNERS; i++) {
+        if (cube->corner_permutations[i] != (corner_t)i || cube->corner_orientations[i] != 0)
+            return 0;
+    }
+
+    for (int i = 0; i < N_EDGES; i++) {
+        if (cube->edge_permutations[i] != (edge_t)i || cube->edge_orientations[i] != 0)
+            return 0;
+    }
+
+    return 1;
+}
+
+static void build_symmetry_cubes_once() {
+    cube_cubie_t rot_urf3, rot_f2, rot_u4, mirr_lr2;
+    load_basic_symmetry(&rot_urf3, corner_permutation_ROT_URF3, corner_orientation_ROT_URF3,
+                        edge_permutation_ROT_URF3, edge_orientation_ROT_URF3);
+    load_basic_symmetry(&rot_f2, corner_permutation_ROT_F2, corner_orientation_ROT_F2, edge_permutation_ROT_F2,
+                        edge_orientation_ROT_F2);
+    load_basic_symmetry(&rot_u4, corner_permutation_ROT_U4, corner_orientation_ROT_U4, edge_permutation_ROT_U4,
+                        edge_orientation_ROT_U4);
+    load_basic_symmetry(&mirr_lr2, corner_permutation_MIRR_LR2, corner_orientation_MIRR_LR2,
+                        edge_permutation_MIRR_LR2, edge_orientation_MIRR_LR2);
+
+    cube_cubie_t *cube = init_cubie_cube();
+    int           idx  = 0;
+
+    for (int urf3 = 0; urf3 < 3; urf3++) {
+        for (int f2 = 0; f2 < 2; f2++) {
+            for (int u4 = 0; u4 < 4; u4++) {
+                for (int lr2 = 0; lr2 < 2; lr2++) {
+                    symmetry_cubes[idx++] = *cube;
+                    multiply_symmetry(cube, &mirr_lr2);
+                }
+                multiply_symmetry(cube, &rot_u4);
+            }
+            multiply_symmetry(cube, &rot_f2);
+        }
+        multiply_symmetry(cube, &rot_urf3);
+    }
+
+    free(cube);
+
+    for (int j = 0; j < N_SYMMETRIES; j++) {
+        inverse_symmetry[j] = -1;
+
+        for (int i = 0; i < N_SYMMETRIES; i++) {
+            cube_cubie_t product = symmetry_cubes[j];
+            multiply_symmetry(&product, &symmetry_cubes[i]);
+
+            if (is_identity(&product)) {
+                inverse_symmetry[j] = i;
+                break;
+            }
+        }
+
+        assert(inverse_symmetry[j] != -1);
+    }
+
+    cubie_build_move_table();
+
+    for (int s = 0; s < N_SYMMETRIES; s++) {
+        for (int move = 0; move < N_MOVES; move++) {
+            cube_cubie_t conjugate = symmetry_cubes[s];
+            cube_cubie_t *basic    = init_cubie_cube();
+            cubie_apply_move(basic, move);
+            multiply_symmetry(&conjugate, basic);
+            multiply_symmetry(&conjugate, &symmetry_cubes[inverse_symmetry[s]]);
+
+            conjugate_move[s * N_MOVES + move] = MOVE_NULL;
+
+            for (int candidate = 0; candidate < N_MOVES; candidate++) {
+                cube_cubie_t *target = init_cubie_cube();
+                cubie_apply_move(target, candidate);
+
+                if (are_cubie_equal(&conjugate, target))
+                    conjugate_move[s * N_MOVES + move] = candidate;
+
+                free(target);
+            }
+
+            assert(conjugate_move[s * N_MOVES + move] != MOVE_NULL);
+            free(basic);
+        }
+    }
+}
+
+// The solvers look up conjugate moves from many threads, so the first use must not race
+static void build_symmetry_cubes() { pthread_once(&symmetry_cubes_once, build_symmetry_cubes_once); }
+
+void get_symmetry_cube(cube_cubie_t *cube, int symmetry) {
+    assert(symmetry >= 0 && symmetry < N_SYMMETRIES);
+    build_symmetry_cubes();
+    *cube = symmetry_cubes[symmetry];
+}
+
+int get_inverse_symmetry(int symmetry) {
+    assert(symmetry >= 0 && symmetry < N_SYMMETRIES);
+    build_symmetry_cubes();
+    return inverse_symmetry[symmetry];
+}
+
+move_t get_conjugate_move(move_t move, int symmetry) {
+    assert(symmetry >= 0 && symmetry < N_SYMMETRIES);
+    assert(move >= 0 && move < N_MOVES);
+    build_symmetry_cubes();
+    return conjugate_move[symmetry * N_MOVES + move];
+}
+
+static void build_twist_conj_table() {
+    if (twist_conj != NULL)
+        return;
+
+    twist_conj = (uint16_t *)malloc(sizeof(uint16_t) * N_CORNER_ORIENTATIONS * N_SYMMETRIES_D4H);
+
+    cube_cubie_t *cube = init_cubie_cube();
+
+    for (int twist = 0; twist < N_CORNER_ORIENTATIONS; twist++) {
+        set_corner_orientations(cube, twist);
+
+        for (int s = 0; s < N_SYMMETRIES_D4H; s++) {
+            cube_cubie_t conjugate = symmetry_cubes[s];
+            multiply_cube_cubie_corners(&conjugate, cube);
+            multiply_cube_cubie_corners(&conjugate, &symmetry_cubes[inverse_symmetry[s]]);
+
+            twist_conj[twist * N_SYMMETRIES_D4H + s] = (uint16_t)get_corner_orientations(&conjugate);
+        }
+    }
+
+    free(cube);
+}
+
+static void build_flipslice_tables() {
+    if (flipslice_classidx != NULL)
+        return;
+
+    printf("bulding flipslice symmetry classes\n");
+
+    uint64_t start_time = get_microseconds();
+
+    flipslice_classidx        = (uint16_t *)malloc(sizeof(uint16_t) * N_FLIPSLICE);
+    flipslice_sym             = (uint8_t *)malloc(sizeof(uint8_t) * N_FLIPSLICE);
+    flipslice_rep             = (uint32_t *)malloc(sizeof(uint32_t) * N_FLIPSLICE_CLASSES);
+    flipslice_self_symmetries = (uint16_t *)malloc(sizeof(uint16_t) * N_FLIPSLICE_CLASSES);
+
+    for (int i = 0; i < N_FLIPSLICE; i++)
+        flipslice_classidx[i] = UINT16_MAX;
+
+    cube_cubie_t *cube     = init_cubie_cube();
+    int           classidx = 0;
+
+    for (int slice = 0; slice < N_SLICES; slice++) {
+        set_E_slice(cube, slice);
+
+        for (int flip = 0; flip < N_EDGE_ORIENTATIONS; flip++) {
+            int flipslice = slice * N_EDGE_ORIENTATIONS + flip;
+
+            if (flipslice_classidx[flipslice] != UINT16_MAX)
+                continue;
+
+            assert(classidx < N_FLIPSLICE_CLASSES);
+
+            set_edge_orientations(cube, flip);
+
+            flipslice_classidx[flipslice]       = classidx;
+            flipslice_sym[flipslice]            = 0;
+            flipslice_rep[classidx]             = flipslice;
+            flipslice_self_symmetries[classidx] = 0;
+
+            for (int s = 0; s < N_SYMMETRIES_D4H; s++) {
+                // S^-1 * R * S
+                cube_cubie_t conjugate = symmetry_cubes[inverse_symmetry[s]];
+                multiply_cube_cubie_edges(&conjugate, cube);
+                multiply_cube_cubie_edges(&conjugate, &symmetry_cubes[s]);
+
+                int new_flipslice = get_E_slice(&conjugate) * N_EDGE_ORIENTATIONS + get_edge_orientations(&conjugate);
+
+                if (new_flipslice == flipslice)
+                    flipslice_self_symmetries[classidx] |= 1 << inverse_symmetry[s];
+
+                if (flipslice_classidx[new_flipslice] == UINT16_MAX) {
+                    flipslice_classidx[new_flipslice] = classidx;
+                    flipslice_sym[new_flipslice]      = s;
+                }
+            }
+
+            classidx++;
+        }
+    }
+
+    free(cube);
+
+    assert(classidx == N_FLIPSLICE_CLASSES);
+
+    uint64_t end_time = get_microseconds();
+    printf("found %d classes in %f seconds\n\n", classidx, (float)(end_time - start_time) / 1000000.0);
+}
+
+void build_symmetry_tables() {
+    build_symmetry_cubes();
+    build_twist_conj_table();
+    build_flipslice_tables();
+}
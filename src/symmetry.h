@@ -0,0 +1,54 @@
+/*
+ * Copyright <2026> <Renan S Silva, aka h3nnn4n>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef _SYMMETRY
+#define _SYMMETRY
+
+#include <stdint.h>
+
+#include "cubie_cube.h"
+#include "definitions.h"
+
+// All 48 symmetries of the cube, and the 16 of them that keep the UD axis in place (D4h).
+// The symmetry index is 16 * urf3 + 8 * f2 + 2 * u4 + lr2, so the D4h ones are 0..15.
+#define N_SYMMETRIES        48
+#define N_SYMMETRIES_D4H    16
+#define N_FLIPSLICE         (N_EDGE_ORIENTATIONS * N_SLICES)
+#define N_FLIPSLICE_CLASSES 64430
+
+void   build_symmetry_tables();
+void   get_symmetry_cube(cube_cubie_t *cube, int symmetry);
+int    get_inverse_symmetry(int symmetry);
+move_t get_conjugate_move(move_t move, int symmetry);
+
+// flipslice = E_slice * N_EDGE_ORIENTATIONS + edge_orientations
+// A cube C with a given flipslice is S^-1 * R * S, where R is the class representant and S the stored symmetry.
+const uint16_t *get_flipslice_classidx_table();
+const uint8_t  *get_flipslice_sym_table();
+const uint32_t *get_flipslice_rep_table();
+// Bitmask of the D4h symmetries that leave each class representant unchanged
+const uint16_t *get_flipslice_self_symmetries_table();
+// twist_conj[twist * N_SYMMETRIES_D4H + s] is the twist of S * C * S^-1
+const uint16_t *get_twist_conj_table();
+
+#endif
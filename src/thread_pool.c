@@ -0,0 +1,144 @@
+/*
+ * Copyright <2026> <Renan S Silva, aka h3nnn4n>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "thread_pool.h"
+
+struct thread_pool_s {
+    pthread_t *threads;
+    int        n_workers;
+
+    pthread_mutex_t lock;
+    pthread_cond_t  work_ready;
+    pthread_cond_t  work_done;
+
+    // Bumped for every batch, so sleeping workers can tell a new batch from a spurious wakeup
+    uint64_t generation;
+    int      shutdown;
+
+    thread_pool_task_t task;
+    void             **args;
+    int                n_tasks;
+    int                next_task;
+    int                n_done;
+};
+
+static void *thread_pool_worker(void *arg) {
+    thread_pool_t *pool            = (thread_pool_t *)arg;
+    uint64_t       seen_generation = 0;
+
+    pthread_mutex_lock(&pool->lock);
+
+    while (1) {
+        while (!pool->shutdown && pool->generation == seen_generation)
+            pthread_cond_wait(&pool->work_ready, &pool->lock);
+
+        if (pool->shutdown)
+            break;
+
+        seen_generation = pool->generation;
+
+        while (pool->next_task < pool->n_tasks) {
+            int index = pool->next_task++;
+
+            pthread_mutex_unlock(&pool->lock);
+            pool->task(pool->args[index]);
+            pthread_mutex_lock(&pool->lock);
+
+            pool->n_done++;
+            if (pool->n_done == pool->n_tasks)
+                pthread_cond_signal(&pool->work_done);
+        }
+    }
+
+    pthread_mutex_unlock(&pool->lock);
+
+    return NULL;
+}
+
+thread_pool_t *thread_pool_create(int n_workers) {
+    assert(n_workers > 0);
+
+    thread_pool_t *pool = (thread_pool_t *)calloc(1, sizeof(thread_pool_t));
+
+    pool->threads   = (pthread_t *)malloc(sizeof(pthread_t) * n_workers);
+    pool->n_workers = n_workers;
+
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->work_ready, NULL);
+    pthread_cond_init(&pool->work_done, NULL);
+
+    for (int i = 0; i < n_workers; i++)
+        pthread_create(&pool->threads[i], NULL, thread_pool_worker, pool);
+
+    return pool;
+}
+
+void thread_pool_destroy(thread_pool_t *pool) {
+    if (pool == NULL)
+        return;
+
+    pthread_mutex_lock(&pool->lock);
+    pool->shutdown = 1;
+    pthread_cond_broadcast(&pool->work_ready);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (int i = 0; i < pool->n_workers; i++)
+        pthread_join(pool->threads[i], NULL);
+
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->work_ready);
+    pthread_cond_destroy(&pool->work_done);
+
+    free(pool->threads);
+    free(pool);
+}
+
+int thread_pool_size(const thread_pool_t *pool) { return pool->n_workers; }
+
+void thread_pool_run(thread_pool_t *pool, thread_pool_task_t task, void **args, int n_tasks) {
+    assert(pool != NULL);
+
+    if (n_tasks <= 0)
+        return;
+
+    pthread_mutex_lock(&pool->lock);
+
+    pool->task      = task;
+    pool->args      = args;
+    pool->n_tasks   = n_tasks;
+    pool->next_task = 0;
+    pool->n_done    = 0;
+    pool->generation++;
+
+    pthread_cond_broadcast(&pool->work_ready);
+
+    while (pool->n_done < pool->n_tasks)
+        pthread_cond_wait(&pool->work_done, &pool->lock);
+
+    pthread_mutex_unlock(&pool->lock);
+}
@@ -0,0 +1,41 @@
+/*
+ * Copyright <2026> <Renan S Silva, aka h3nnn4n>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef _THREAD_POOL
+#define _THREAD_POOL
+
+typedef struct thread_pool_s thread_pool_t;
+
+typedef void (*thread_pool_task_t)(void *arg);
+
+// A fixed set of worker threads that live across solves. Spawning and joining threads for every cube is a
+// large part of the solve time for easy cubes, so solvers create a pool once and hand it batches of tasks.
+thread_pool_t *thread_pool_create(int n_workers);
+void           thread_pool_destroy(thread_pool_t *pool);
+int            thread_pool_size(const thread_pool_t *pool);
+
+// Runs task(args[i]) for every i in [0, n_tasks) on the workers, and returns once all of them finished.
+// Tasks are handed out in order, so with at least as many workers as tasks they all run concurrently.
+void thread_pool_run(thread_pool_t *pool, thread_pool_task_t task, void **args, int n_tasks);
+
+#endif /* end of include guard */
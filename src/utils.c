@@ -271,7 +271,7 @@ move_t str_to_move(const char *move_str) {
     return MOVE_NULL;
 }
 
-void print_move_sequence(const move_t *moves) {
+void print_move_sequence(const uint8_t *moves) {
     for (int i = 0; moves[i] != MOVE_NULL; i++) {
         printf("%s ", move_to_str(moves[i]));
     }
@@ -293,7 +293,10 @@ void print_help(void) {
     printf("Usage: cubotron [options]\n\n");
     printf("Solve modes:\n");
     printf("  --solve <facelets>        Solve a cube from a facelet string\n");
-    printf("  --solve-scramble <moves>  Solve a cube from a scramble move sequence\n\n");
+    printf("  --solve-scramble <moves>  Solve a cube from a scramble move sequence\n");
+    printf("  --serve                   Load the tables once and solve one request per stdin line\n");
+    printf("  --batch <file>            Solve the 3x3 facelets on each line, one cube per thread at a time\n");
+    printf("  --batch-interleave <n>    Search n cubes at once on each --batch thread (default: 1, off)\n\n");
     printf("Puzzle options:\n");
     printf("  --puzzle <type>            Puzzle type (default: 3x3, choices: 3x3, 2x2)\n");
     printf("  --list-puzzles            List available puzzle types\n");
@@ -301,14 +304,31 @@ void print_help(void) {
     printf("Solver options:\n");
     printf("  --max-depth <n>            Maximum solution length (default: 22, max: 29)\n");
     printf("  --n-solutions <n>          Number of solutions to find (default: 1, -1 = all)\n");
-    printf("  --move-blacklist <moves>   Exclude moves from search (e.g. \"U R2 F'\")\n\n");
+    printf("  --threads <n>              Number of solver threads (default: number of cores)\n");
+    printf("  --phase2-threads <n>       How many of the threads only run phase2 searches (default: 0, off)\n");
+    printf("  --phase2-batch <n>         Run phase2 on up to n phase1 solutions together (default: 0, off)\n");
+    printf("  --phase2-cache             Remember the phase2 results of a solve (default: off)\n");
+    printf("  --timeout <seconds>        Keep looking for shorter solutions until then (default: 0, off)\n");
+    printf("  --target-length <n>        Keep looking for shorter solutions until one has n moves or less\n");
+    printf("                             (default: 0, off)\n");
+    printf("  --six-way                  Also search the cube along the other two axes and as its inverse\n");
+    printf("  --move-blacklist <moves>   Exclude moves from search (e.g. \"U R2 F'\")\n");
+    printf("  --phase1-pruning <table>   Phase1 pruning table (default: projections, choices: projections,\n");
+    printf("                             flipslice-twist)\n");
+    printf("  --no-simd                  Expand the phase1 nodes without AVX2, even when the CPU has it\n");
+    printf("  --no-prefetch              Do not prefetch the table entries of the nodes the search visits next\n");
+    printf("  --cache-line-move-tables   Pad every row of the move tables to a cache line of its own\n\n");
     printf("Benchmark modes:\n");
     printf("  --benchmark-fast           Run fast benchmark (500ms warmup, 5s measurement)\n");
     printf("  --benchmark-slow           Run slow benchmark (1s warmup, 30s measurement)\n");
+    printf("  --benchmark-batch          Compare solving cubes one at a time against --batch\n");
+    printf("  --benchmark-interleave     Solves per second of one --batch thread for each --batch-interleave\n");
     printf("  --compare-against <file>   Compare results against a specific baseline file\n");
     printf("  --compare-benchmarks <a,b> Compare two benchmark result files directly\n\n");
     printf("Other:\n");
     printf("  --rebuild-tables           Rebuild move and pruning tables from scratch\n");
+    printf("  --no-mmap-tables           Read cached tables into private memory instead of mapping them\n");
+    printf("  --verify-tables            Check mapped tables against their checksums when loading them\n");
     printf("  --help                     Show this help message\n\n");
     printf("Facelet format:\n");
     printf("  54 characters for 3x3 (U1-U9, R1-R9, F1-F9, D1-D9, L1-L9, B1-B9)\n");
@@ -0,0 +1,154 @@
+#include <pcg_variants.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unity.h>
+
+#include <batch.h>
+#include <config.h>
+#include <coord_cube.h>
+#include <move_tables.h>
+#include <pruning.h>
+#include <pruning_cache.h>
+#include <solve.h>
+#include <utils.h>
+
+#define N_CUBES 12
+
+static int is_solution_valid(const coord_cube_t *cube, const uint8_t *solution) {
+    coord_cube_t *solved = get_coord_cube();
+    copy_coord_cube(solved, cube);
+
+    for (int i = 0; solution[i] != MOVE_NULL; i++)
+        coord_apply_move(solved, solution[i]);
+
+    int is_solved = is_coord_solved(solved);
+    free(solved);
+
+    return is_solved;
+}
+
+void test_batch_solves_every_cube() {
+    const coord_cube_t *cubes[N_CUBES];
+    solve_list_t       *solves[N_CUBES];
+
+    for (int i = 0; i < N_CUBES; i++) {
+        coord_cube_t *cube = get_coord_cube();
+        // Leaves one cube solved
+        if (i > 0)
+            scramble_cube(cube, 30);
+        cubes[i] = cube;
+    }
+
+    batch_t *batch = batch_create(3);
+    batch_solve(batch, cubes, solves, N_CUBES, get_config());
+    batch_destroy(batch);
+
+    for (int i = 0; i < N_CUBES; i++) {
+        TEST_ASSERT_NOT_NULL(solves[i]);
+        TEST_ASSERT_NOT_NULL(solves[i]->solution);
+        TEST_ASSERT_TRUE(is_solution_valid(cubes[i], solves[i]->solution));
+
+        destroy_solve_list(solves[i]);
+        free((coord_cube_t *)cubes[i]);
+    }
+}
+
+void test_workers_solve_like_a_single_thread_solve() {
+    coord_cube_t *cube = get_coord_cube();
+    scramble_cube(cube, 30);
+
+    get_config()->thread_count = 1;
+
+    solve_request_t request;
+    init_solve_request(&request, get_config());
+
+    solve_worker_t *worker   = make_solve_worker();
+    solve_list_t   *expected = solve(cube, get_config());
+    solve_list_t   *actual   = solve_on_worker(worker, cube, &request);
+
+    TEST_ASSERT_TRUE(are_solutions_equal(expected->solution, actual->solution));
+
+    destroy_solve_list(expected);
+    destroy_solve_list(actual);
+    destroy_solve_worker(worker);
+    free(cube);
+}
+
+void test_interleaved_batch_solves_like_a_plain_batch() {
+    const coord_cube_t *cubes[N_CUBES];
+    solve_list_t       *expected[N_CUBES];
+    solve_list_t       *actual[N_CUBES];
+
+    for (int i = 0; i < N_CUBES; i++) {
+        coord_cube_t *cube = get_coord_cube();
+        if (i > 0)
+            scramble_cube(cube, 30);
+        cubes[i] = cube;
+    }
+
+    batch_t *batch = batch_create(1);
+    batch_solve(batch, cubes, expected, N_CUBES, get_config());
+    batch_destroy(batch);
+
+    // Fewer cubes than workers in the last round
+    batch = batch_create_interleaved(1, 5);
+    batch_solve(batch, cubes, actual, N_CUBES, get_config());
+    batch_destroy(batch);
+
+    for (int i = 0; i < N_CUBES; i++) {
+        TEST_ASSERT_TRUE(are_solutions_equal(expected[i]->solution, actual[i]->solution));
+        TEST_ASSERT_TRUE(is_solution_valid(cubes[i], actual[i]->solution));
+
+        destroy_solve_list(expected[i]);
+        destroy_solve_list(actual[i]);
+        free((coord_cube_t *)cubes[i]);
+    }
+}
+
+void test_run_batch_answers_invalid_lines() {
+    const char *filename = "cache/test_batch_input.txt";
+    FILE       *in       = fopen(filename, "w");
+
+    // A flipped UF edge and the UF and UB edges swapped, between two solved cubes
+    fputs("UUUUUUUUURRRRRRRRRFFFFFFFFFDDDDDDDDDLLLLLLLLLBBBBBBBBB\n"
+          "UUUUUUUFURRRRRRRRRFUFFFFFFFDDDDDDDDDLLLLLLLLLBBBBBBBBB\n"
+          "UUUUUUUUURRRRRRRRRFBFFFFFFFDDDDDDDDDLLLLLLLLLBFBBBBBBB\n"
+          "UUUUUUUUURRRRRRRRRFFFFFFFFFDDDDDDDDDLLLLLLLLLBBBBBBBBB\n",
+          in);
+    fclose(in);
+
+    char  output[1024] = {0};
+    FILE *out          = fmemopen(output, sizeof(output), "w");
+
+    TEST_ASSERT_EQUAL_INT(0, run_batch(filename, out, 2));
+    fclose(out);
+    remove(filename);
+
+    TEST_ASSERT_EQUAL_STRING("ok 0\nerror invalid facelets\nerror invalid facelets\nok 0\n", output);
+}
+
+void setUp() {
+    init_config();
+    get_config()->max_depth = 22;
+}
+
+void tearDown() {}
+
+int main() {
+    init_config();
+    build_move_tables();
+    build_pruning_tables();
+    pruning_table_cache_flush();
+
+    pcg32_srandom(42u, 54u);
+
+    UNITY_BEGIN();
+
+    RUN_TEST(test_batch_solves_every_cube);
+    RUN_TEST(test_workers_solve_like_a_single_thread_solve);
+    RUN_TEST(test_interleaved_batch_solves_like_a_plain_batch);
+    RUN_TEST(test_run_batch_answers_invalid_lines);
+
+    return UNITY_END();
+}
@@ -72,7 +72,7 @@ void test_is_phase2_solved() {
 void test_is_move_sequence_a_solution_for_cube() {
     coord_cube_t *cube = get_coord_cube();
 
-    move_t solution[] = {MOVE_NULL};
+    uint8_t solution[] = {MOVE_NULL};
     TEST_ASSERT_TRUE(is_move_sequence_a_solution_for_cube(cube, solution));
 
     coord_apply_move(cube, MOVE_F1);
@@ -80,10 +80,10 @@ void test_is_move_sequence_a_solution_for_cube() {
     coord_apply_move(cube, MOVE_B1);
     coord_apply_move(cube, MOVE_R1);
 
-    move_t reverse_solution[] = {MOVE_R3, MOVE_B3, MOVE_R3, MOVE_F3, MOVE_NULL};
+    uint8_t reverse_solution[] = {MOVE_R3, MOVE_B3, MOVE_R3, MOVE_F3, MOVE_NULL};
     TEST_ASSERT_TRUE(is_move_sequence_a_solution_for_cube(cube, reverse_solution));
 
-    move_t wrong_solution[] = {MOVE_U1, MOVE_NULL};
+    uint8_t wrong_solution[] = {MOVE_U1, MOVE_NULL};
     TEST_ASSERT_FALSE(is_move_sequence_a_solution_for_cube(cube, wrong_solution));
 
     free(cube);
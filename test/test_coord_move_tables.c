@@ -214,6 +214,88 @@ void test_all_moves_preserve_cube_validity() {
     free(cube);
 }
 
+void test_phase2_moves_match_full_moves() {
+    coord_cube_t *cube      = get_coord_cube();
+    coord_cube_t *reference = get_coord_cube();
+    const move_t *moves     = get_phase2_moves();
+
+    for (int i = 0; i < 100000; i++) {
+        int move_index = pcg32_boundedrand_r(&rng, N_PHASE2_MOVES);
+
+        coord_apply_move_phase2(cube, move_index);
+        coord_apply_move(reference, moves[move_index]);
+
+        TEST_ASSERT_EQUAL_INT(reference->E_sorted_slice, cube->E_sorted_slice);
+        TEST_ASSERT_EQUAL_INT(reference->parity, cube->parity);
+        TEST_ASSERT_EQUAL_INT(reference->UD6_edge_permutations, cube->UD6_edge_permutations);
+        TEST_ASSERT_EQUAL_INT(reference->UD7_edge_permutations, cube->UD7_edge_permutations);
+        TEST_ASSERT_EQUAL_INT(reference->corner_permutations, cube->corner_permutations);
+    }
+
+    free(cube);
+    free(reference);
+}
+
+void test_phase2_child_leaves_parent_alone() {
+    coord_cube_t  parent;
+    coord_cube_t  before;
+    coord_cube_t  child;
+    coord_cube_t *reference = get_coord_cube();
+
+    for (int i = 0; i < 10000; i++) {
+        int move_index = pcg32_boundedrand_r(&rng, N_PHASE2_MOVES);
+
+        copy_coord_cube(&parent, reference);
+        copy_coord_cube(&before, reference);
+        reset_coord_cube(&child);
+        child.edge_orientations = N_EDGE_ORIENTATIONS;
+
+        coord_get_phase2_child(&child, &parent, move_index);
+        coord_apply_move_phase2(reference, move_index);
+
+        TEST_ASSERT_TRUE(are_all_coord_equal(&parent, &before));
+        TEST_ASSERT_EQUAL_INT(N_EDGE_ORIENTATIONS, child.edge_orientations);
+        TEST_ASSERT_EQUAL_INT(reference->E_sorted_slice, child.E_sorted_slice);
+        TEST_ASSERT_EQUAL_INT(reference->parity, child.parity);
+        TEST_ASSERT_EQUAL_INT(reference->UD6_edge_permutations, child.UD6_edge_permutations);
+        TEST_ASSERT_EQUAL_INT(reference->UD7_edge_permutations, child.UD7_edge_permutations);
+        TEST_ASSERT_EQUAL_INT(reference->corner_permutations, child.corner_permutations);
+    }
+
+    free(reference);
+}
+
+void test_phase2_coords_match_full_replay() {
+    edge_t edges[N_EDGES];
+    move_t moves[20];
+
+    for (int iter = 0; iter < 1000; iter++) {
+        coord_cube_t *start     = random_coord_cube();
+        coord_cube_t *cube      = get_coord_cube();
+        coord_cube_t *reference = get_coord_cube();
+        int           n_moves   = pcg32_boundedrand_r(&rng, 20);
+
+        for (int i = 0; i < n_moves; i++)
+            moves[i] = pcg32_boundedrand_r(&rng, N_MOVES);
+
+        copy_coord_cube(reference, start);
+        coord_apply_moves(reference, moves, n_moves);
+
+        coord_get_edge_permutations(start, edges);
+        coord_set_phase2_coords(cube, start, edges, moves, n_moves);
+
+        TEST_ASSERT_EQUAL_INT(reference->E_sorted_slice, cube->E_sorted_slice);
+        TEST_ASSERT_EQUAL_INT(reference->parity, cube->parity);
+        TEST_ASSERT_EQUAL_INT(reference->UD6_edge_permutations, cube->UD6_edge_permutations);
+        TEST_ASSERT_EQUAL_INT(reference->UD7_edge_permutations, cube->UD7_edge_permutations);
+        TEST_ASSERT_EQUAL_INT(reference->corner_permutations, cube->corner_permutations);
+
+        free(start);
+        free(cube);
+        free(reference);
+    }
+}
+
 void setUp(void) { build_move_tables(); }
 
 void tearDown(void) {}
@@ -236,5 +318,9 @@ int main() {
     RUN_TEST(test_quarter_turns_four_times_identity);
     RUN_TEST(test_all_moves_preserve_cube_validity);
 
+    RUN_TEST(test_phase2_moves_match_full_moves);
+    RUN_TEST(test_phase2_child_leaves_parent_alone);
+    RUN_TEST(test_phase2_coords_match_full_replay);
+
     return UNITY_END();
 }
@@ -483,6 +483,25 @@ void test_orientation_changes() {
     free(cube);
 }
 
+void test_cube_times_inverse_is_identity() {
+    cube_cubie_t *identity = init_cubie_cube();
+
+    for (int i = 0; i < 100; i++) {
+        cube_cubie_t *cube = random_cubie_cube();
+        cube_cubie_t  inverse;
+
+        invert_cubie_cube(cube, &inverse);
+        TEST_ASSERT_TRUE(is_valid(&inverse));
+
+        multiply_cube_cubie(cube, &inverse);
+        TEST_ASSERT_TRUE(are_cubie_equal(cube, identity));
+
+        free(cube);
+    }
+
+    free(identity);
+}
+
 void setUp(void) { cubie_build_move_table(); }
 
 void tearDown(void) {}
@@ -492,6 +511,7 @@ int main() {
 
     UNITY_BEGIN();
 
+    RUN_TEST(test_cube_times_inverse_is_identity);
     RUN_TEST(test_init_cubie_corner_permutations);
     RUN_TEST(test_init_cubie_edge_permutations);
     RUN_TEST(test_init_cubie_corner_orientations);
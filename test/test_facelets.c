@@ -71,6 +71,16 @@ void test_build_cube_from_facelet_string() {
     }
 }
 
+void test_facelets_solvable() {
+    for (int i = 0; i < N_FACELETS_SAMPLES; i++)
+        TEST_ASSERT_TRUE(are_facelets_solvable(sample_facelets[i]));
+
+    // A flipped UF edge, a twisted URF corner, and the UF and UB edges swapped
+    TEST_ASSERT_FALSE(are_facelets_solvable("UUUUUUUFURRRRRRRRRFUFFFFFFFDDDDDDDDDLLLLLLLLLBBBBBBBBB"));
+    TEST_ASSERT_FALSE(are_facelets_solvable("UUUUUUUUFURRRRRRRRFFRFFFFFFDDDDDDDDDLLLLLLLLLBBBBBBBBB"));
+    TEST_ASSERT_FALSE(are_facelets_solvable("UUUUUUUUURRRRRRRRRFBFFFFFFFDDDDDDDDDLLLLLLLLLBFBBBBBBB"));
+}
+
 void setUp(void) {}
 
 void tearDown(void) {}
@@ -82,6 +92,7 @@ int main() {
     RUN_TEST(test_build_cube_from_facelet_string_solved);
     RUN_TEST(test_build_cube_from_facelet_string_scrambled);
     RUN_TEST(test_build_cube_from_facelet_string);
+    RUN_TEST(test_facelets_solvable);
 
     return UNITY_END();
 }
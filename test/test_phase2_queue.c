@@ -0,0 +1,151 @@
+#include <pthread.h>
+#include <stdatomic.h>
+#include <unity.h>
+
+#include <phase2_queue.h>
+
+#define N_PRODUCERS           3
+#define N_CONSUMERS           2
+#define CANDIDATES_PER_THREAD 20000
+
+static phase2_candidate_t make_candidate(int value) {
+    phase2_candidate_t candidate = {0};
+
+    candidate.cube.corner_permutations = value;
+    candidate.phase1_length            = (int8_t)(value % PHASE2_QUEUE_MAX_MOVES);
+
+    return candidate;
+}
+
+void test_queue_is_fifo() {
+    phase2_queue_t    *queue = make_phase2_queue(8);
+    phase2_candidate_t candidate;
+
+    for (int i = 0; i < 5; i++) {
+        phase2_candidate_t pushed = make_candidate(i);
+        TEST_ASSERT_TRUE(push_phase2_candidate(queue, &pushed));
+    }
+
+    for (int i = 0; i < 5; i++) {
+        TEST_ASSERT_TRUE(pop_phase2_candidate(queue, &candidate));
+        TEST_ASSERT_EQUAL_INT(i, candidate.cube.corner_permutations);
+    }
+
+    TEST_ASSERT_FALSE(pop_phase2_candidate(queue, &candidate));
+
+    destroy_phase2_queue(queue);
+}
+
+void test_queue_rejects_pushes_when_full() {
+    // Rounded up to 8
+    phase2_queue_t    *queue     = make_phase2_queue(5);
+    phase2_candidate_t candidate = make_candidate(1);
+
+    for (int i = 0; i < 8; i++)
+        TEST_ASSERT_TRUE(push_phase2_candidate(queue, &candidate));
+
+    TEST_ASSERT_FALSE(push_phase2_candidate(queue, &candidate));
+
+    TEST_ASSERT_TRUE(pop_phase2_candidate(queue, &candidate));
+    TEST_ASSERT_TRUE(push_phase2_candidate(queue, &candidate));
+
+    // A reset drops everything
+    reset_phase2_queue(queue, 1);
+    TEST_ASSERT_FALSE(pop_phase2_candidate(queue, &candidate));
+    TEST_ASSERT_TRUE(has_phase2_producers(queue));
+
+    close_phase2_producer(queue);
+    TEST_ASSERT_FALSE(has_phase2_producers(queue));
+
+    destroy_phase2_queue(queue);
+}
+
+static phase2_queue_t *shared_queue;
+static atomic_llong    popped_sum;
+static atomic_int      popped_count;
+static atomic_int      corrupted_count;
+
+static void *produce(void *arg) {
+    int first = *(int *)arg;
+
+    for (int i = 0; i < CANDIDATES_PER_THREAD; i++) {
+        phase2_candidate_t candidate = make_candidate(first + i);
+
+        while (!push_phase2_candidate(shared_queue, &candidate))
+            ;
+    }
+
+    close_phase2_producer(shared_queue);
+    return NULL;
+}
+
+static void *consume(void *arg) {
+    (void)arg;
+    phase2_candidate_t candidate;
+
+    while (1) {
+        int has_producers = has_phase2_producers(shared_queue);
+
+        if (pop_phase2_candidate(shared_queue, &candidate)) {
+            // Unity cannot assert from other threads
+            if (candidate.cube.corner_permutations % PHASE2_QUEUE_MAX_MOVES != candidate.phase1_length)
+                atomic_fetch_add(&corrupted_count, 1);
+
+            atomic_fetch_add(&popped_sum, candidate.cube.corner_permutations);
+            atomic_fetch_add(&popped_count, 1);
+        } else if (!has_producers) {
+            break;
+        }
+    }
+
+    return NULL;
+}
+
+void test_queue_hands_every_candidate_to_one_consumer() {
+    pthread_t producers[N_PRODUCERS], consumers[N_CONSUMERS];
+    int       firsts[N_PRODUCERS];
+    long long expected = 0;
+
+    shared_queue = make_phase2_queue(64);
+    reset_phase2_queue(shared_queue, N_PRODUCERS);
+    atomic_store(&popped_sum, 0);
+    atomic_store(&popped_count, 0);
+    atomic_store(&corrupted_count, 0);
+
+    for (int i = 0; i < N_CONSUMERS; i++)
+        pthread_create(&consumers[i], NULL, consume, NULL);
+
+    for (int i = 0; i < N_PRODUCERS; i++) {
+        firsts[i] = i * CANDIDATES_PER_THREAD;
+        pthread_create(&producers[i], NULL, produce, &firsts[i]);
+    }
+
+    for (int i = 0; i < N_PRODUCERS; i++)
+        pthread_join(producers[i], NULL);
+
+    for (int i = 0; i < N_CONSUMERS; i++)
+        pthread_join(consumers[i], NULL);
+
+    for (int i = 0; i < N_PRODUCERS * CANDIDATES_PER_THREAD; i++)
+        expected += i;
+
+    TEST_ASSERT_EQUAL_INT(N_PRODUCERS * CANDIDATES_PER_THREAD, atomic_load(&popped_count));
+    TEST_ASSERT_EQUAL_INT(0, atomic_load(&corrupted_count));
+    TEST_ASSERT_TRUE(expected == atomic_load(&popped_sum));
+
+    destroy_phase2_queue(shared_queue);
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+int main() {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_queue_is_fifo);
+    RUN_TEST(test_queue_rejects_pushes_when_full);
+    RUN_TEST(test_queue_hands_every_candidate_to_one_consumer);
+
+    return UNITY_END();
+}
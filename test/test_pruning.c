@@ -5,6 +5,7 @@
 #include <coord_cube.h>
 #include <move_tables.h>
 #include <pruning.h>
+#include <pruning_cache.h>
 #include <solve.h>
 
 void test_pruning_solved_state() {
@@ -62,6 +63,76 @@ void test_combined_pruning_geq_individual() {
     free(cube);
 }
 
+void test_pruning_neighbours_differ_by_at_most_one() {
+    coord_cube_t *cube  = get_coord_cube();
+    coord_cube_t *child = get_coord_cube();
+
+    move_t phase2_moves[] = {MOVE_U1, MOVE_U2, MOVE_U3, MOVE_D1, MOVE_D2, MOVE_D3, MOVE_R2, MOVE_L2, MOVE_F2, MOVE_B2};
+
+    for (int i = 0; i < 100; i++) {
+        reset_coord_cube(cube);
+        scramble_cube(cube, 20);
+
+        int value = get_phase1_pruning(cube);
+
+        for (int move = 0; move < N_MOVES; move++) {
+            copy_coord_cube(child, cube);
+            coord_apply_move(child, move);
+
+            int child_value = get_phase1_pruning(child);
+            TEST_ASSERT_TRUE(child_value >= value - 1 && child_value <= value + 1);
+        }
+
+        reset_coord_cube(cube);
+        for (int j = 0; j < 20; j++)
+            coord_apply_move(cube, phase2_moves[pcg32_boundedrand(10)]);
+
+        value = get_phase2_pruning(cube);
+
+        for (int move = 0; move < 10; move++) {
+            copy_coord_cube(child, cube);
+            coord_apply_move(child, phase2_moves[move]);
+
+            int child_value = get_phase2_pruning(child);
+            TEST_ASSERT_TRUE(child_value >= value - 1 && child_value <= value + 1);
+        }
+    }
+
+    free(cube);
+    free(child);
+}
+
+void test_phase1_children_match_single_moves() {
+    coord_cube_t *cube  = get_coord_cube();
+    coord_cube_t *child = get_coord_cube();
+
+    phase1_children_t children;
+
+    for (int i = 0; i < 200; i++) {
+        reset_coord_cube(cube);
+        scramble_cube(cube, 20);
+
+        // With and without AVX2, when the CPU has it
+        for (int simd = 0; simd <= 1; simd++) {
+            get_config()->simd = simd;
+            get_phase1_children(cube, &children);
+
+            for (int move = 0; move < N_MOVES; move++) {
+                copy_coord_cube(child, cube);
+                coord_apply_move_phase1(child, move);
+
+                TEST_ASSERT_EQUAL_INT(child->edge_orientations, children.edge_orientations[move]);
+                TEST_ASSERT_EQUAL_INT(child->corner_orientations, children.corner_orientations[move]);
+                TEST_ASSERT_EQUAL_INT(child->E_slice, children.E_slice[move]);
+                TEST_ASSERT_EQUAL_INT(get_phase1_pruning(child), children.pruning[move]);
+            }
+        }
+    }
+
+    free(cube);
+    free(child);
+}
+
 void test_pruning_never_overestimates_sample() {
     coord_cube_t *cube = get_coord_cube();
     config_t *config = get_config();
@@ -90,12 +161,71 @@ void test_pruning_never_overestimates_sample() {
     free(cube);
 }
 
+void test_flipslice_twist_pruning_solved_state() {
+    coord_cube_t *cube = get_coord_cube();
+    reset_coord_cube(cube);
+
+    get_config()->phase1_pruning = PHASE1_PRUNING_FLIPSLICE_TWIST;
+    TEST_ASSERT_EQUAL(0, get_phase1_pruning(cube));
+
+    free(cube);
+}
+
+void test_flipslice_twist_pruning_neighbours_differ_by_at_most_one() {
+    coord_cube_t *cube  = get_coord_cube();
+    coord_cube_t *child = get_coord_cube();
+
+    get_config()->phase1_pruning = PHASE1_PRUNING_FLIPSLICE_TWIST;
+
+    for (int i = 0; i < 100; i++) {
+        reset_coord_cube(cube);
+        scramble_cube(cube, 20);
+
+        int value = get_phase1_pruning(cube);
+
+        for (int move = 0; move < N_MOVES; move++) {
+            copy_coord_cube(child, cube);
+            coord_apply_move(child, move);
+
+            int child_value = get_phase1_pruning(child);
+            TEST_ASSERT_TRUE(child_value >= value - 1 && child_value <= value + 1);
+        }
+    }
+
+    free(cube);
+    free(child);
+}
+
+void test_flipslice_twist_pruning_geq_projections() {
+    coord_cube_t *cube   = get_coord_cube();
+    config_t     *config = get_config();
+
+    for (int i = 0; i < 200; i++) {
+        reset_coord_cube(cube);
+        scramble_cube(cube, 20);
+
+        // The projections are each a lower bound of the same distance, so the exact one is at least their max
+        config->phase1_pruning = PHASE1_PRUNING_PROJECTIONS;
+        int projections        = get_phase1_pruning(cube);
+
+        config->phase1_pruning = PHASE1_PRUNING_FLIPSLICE_TWIST;
+        int flipslice_twist    = get_phase1_pruning(cube);
+
+        TEST_ASSERT_TRUE(flipslice_twist >= projections);
+    }
+
+    free(cube);
+}
+
 void setUp() { init_config(); }
 void tearDown() {}
 
 int main() {
+    init_config();
     build_move_tables();
     build_pruning_tables();
+    build_phase1_flipslice_twist_table();
+    pruning_table_cache_flush();
 
     pcg32_srandom(43u, 55u);
 
@@ -105,7 +235,12 @@ int main() {
     RUN_TEST(test_pruning_single_moves);
     RUN_TEST(test_combined_pruning_solved_state);
     RUN_TEST(test_combined_pruning_geq_individual);
+    RUN_TEST(test_pruning_neighbours_differ_by_at_most_one);
+    RUN_TEST(test_phase1_children_match_single_moves);
     RUN_TEST(test_pruning_never_overestimates_sample);
+    RUN_TEST(test_flipslice_twist_pruning_solved_state);
+    RUN_TEST(test_flipslice_twist_pruning_neighbours_differ_by_at_most_one);
+    RUN_TEST(test_flipslice_twist_pruning_geq_projections);
 
     return UNITY_END();
 }
@@ -0,0 +1,218 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unity.h>
+
+#include <config.h>
+#include <pruning_cache.h>
+
+#define TABLE_SIZE 4099
+
+static const cache_layout_t layout = {.element_bits = 32, .dims = {TABLE_SIZE, 0, 0}, .move_set = CACHE_MOVE_SET_ALL};
+
+static int *make_table(int seed) {
+    int *table = (int *)malloc(sizeof(int) * TABLE_SIZE);
+
+    for (int i = 0; i < TABLE_SIZE; i++)
+        table[i] = (i * 7919 + seed) % 104729;
+
+    return table;
+}
+
+static void assert_roundtrip(int mmap_tables) {
+    int *table  = make_table(0);
+    int *loaded = NULL;
+
+    get_config()->mmap_tables = mmap_tables;
+    pruning_table_cache_store("test_tables", "roundtrip", &layout, table);
+    pruning_table_cache_flush();
+
+    TEST_ASSERT_TRUE(pruning_table_cache_load("test_tables", "roundtrip", &layout, (void **)&loaded));
+    TEST_ASSERT_EQUAL_INT_ARRAY(table, loaded, TABLE_SIZE);
+
+    pruning_table_cache_release(loaded);
+    free(table);
+}
+
+void test_cache_roundtrip_with_mmap() { assert_roundtrip(1); }
+
+void test_cache_roundtrip_without_mmap() { assert_roundtrip(0); }
+
+void test_cache_load_aligns_tables_to_a_cache_line() {
+    int *table  = make_table(0);
+    int *loaded = NULL;
+
+    for (int mmap_tables = 0; mmap_tables <= 1; mmap_tables++) {
+        get_config()->mmap_tables = mmap_tables;
+        pruning_table_cache_store("test_tables", "aligned", &layout, table);
+        pruning_table_cache_flush();
+
+        TEST_ASSERT_TRUE(pruning_table_cache_load("test_tables", "aligned", &layout, (void **)&loaded));
+        TEST_ASSERT_EQUAL_INT(0, (uintptr_t)loaded % 64);
+
+        pruning_table_cache_release(loaded);
+    }
+
+    free(table);
+}
+
+void test_cache_pads_tables_that_fill_their_pages() {
+    cache_layout_t page_layout = {.element_bits = 32, .dims = {1024, 0, 0}, .move_set = CACHE_MOVE_SET_ALL};
+    int           *table       = make_table(0);
+
+    pruning_table_cache_store("test_tables", "page", &page_layout, table);
+    pruning_table_cache_flush();
+
+    // The table ends exactly on a page boundary, the 32 bit reads past its last entry must still be in the file
+    FILE *f = fopen(get_config()->cache_file, "rb");
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fclose(f);
+
+    TEST_ASSERT_TRUE(size >= 4096 + 4096 + 3);
+
+    free(table);
+}
+
+void test_cache_keeps_other_tables_when_storing() {
+    int *table1 = make_table(1);
+    int *table2 = make_table(2);
+    int *loaded = NULL;
+
+    pruning_table_cache_store("test_tables", "first", &layout, table1);
+    pruning_table_cache_store("test_tables", "second", &layout, table2);
+    pruning_table_cache_flush();
+
+    // Replacing a table must not duplicate it or drop the others
+    pruning_table_cache_store("test_tables", "first", &layout, table2);
+    pruning_table_cache_flush();
+
+    TEST_ASSERT_TRUE(pruning_table_cache_load("test_tables", "first", &layout, (void **)&loaded));
+    TEST_ASSERT_EQUAL_INT_ARRAY(table2, loaded, TABLE_SIZE);
+    pruning_table_cache_release(loaded);
+
+    TEST_ASSERT_TRUE(pruning_table_cache_load("test_tables", "second", &layout, (void **)&loaded));
+    TEST_ASSERT_EQUAL_INT_ARRAY(table2, loaded, TABLE_SIZE);
+    pruning_table_cache_release(loaded);
+
+    free(table1);
+    free(table2);
+}
+
+void test_cache_writes_stored_tables_on_flush() {
+    int *table1 = make_table(1);
+    int *table2 = make_table(2);
+    int *loaded = NULL;
+
+    pruning_table_cache_store("test_tables", "first", &layout, table1);
+    pruning_table_cache_store("test_tables", "second", &layout, table2);
+
+    TEST_ASSERT_FALSE(pruning_table_cache_load("test_tables", "first", &layout, (void **)&loaded));
+
+    pruning_table_cache_flush();
+
+    TEST_ASSERT_TRUE(pruning_table_cache_load("test_tables", "first", &layout, (void **)&loaded));
+    TEST_ASSERT_EQUAL_INT_ARRAY(table1, loaded, TABLE_SIZE);
+    pruning_table_cache_release(loaded);
+
+    TEST_ASSERT_TRUE(pruning_table_cache_load("test_tables", "second", &layout, (void **)&loaded));
+    TEST_ASSERT_EQUAL_INT_ARRAY(table2, loaded, TABLE_SIZE);
+    pruning_table_cache_release(loaded);
+
+    free(table1);
+    free(table2);
+}
+
+void test_cache_load_ignores_different_layout() {
+    int *table  = make_table(0);
+    int *loaded = NULL;
+
+    cache_layout_t other_dims  = layout;
+    cache_layout_t other_moves = layout;
+    cache_layout_t other_bits  = layout;
+    other_dims.dims[0]         = TABLE_SIZE - 1;
+    other_moves.move_set       = 1;
+    other_bits.element_bits    = 16;
+
+    pruning_table_cache_store("test_tables", "layout", &layout, table);
+    pruning_table_cache_flush();
+
+    TEST_ASSERT_FALSE(pruning_table_cache_load("test_tables", "layout", &other_dims, (void **)&loaded));
+    TEST_ASSERT_FALSE(pruning_table_cache_load("test_tables", "layout", &other_moves, (void **)&loaded));
+    TEST_ASSERT_FALSE(pruning_table_cache_load("test_tables", "layout", &other_bits, (void **)&loaded));
+
+    free(table);
+}
+
+void test_cache_load_ignores_corrupt_data() {
+    int *table  = make_table(0);
+    int *loaded = NULL;
+
+    // Mapped tables are only checked with verify_tables
+    for (int mmap_tables = 0; mmap_tables <= 1; mmap_tables++) {
+        get_config()->mmap_tables   = mmap_tables;
+        get_config()->verify_tables = mmap_tables;
+        pruning_table_cache_clear();
+        pruning_table_cache_store("test_tables", "corrupt", &layout, table);
+        pruning_table_cache_flush();
+
+        // Flip a byte of the table, which starts right after the 4096 bytes header page
+        FILE *f = fopen(get_config()->cache_file, "r+b");
+        fseek(f, 4096 + 100, SEEK_SET);
+        int byte = fgetc(f);
+        fseek(f, 4096 + 100, SEEK_SET);
+        fputc(byte ^ 0xFF, f);
+        fclose(f);
+
+        TEST_ASSERT_FALSE(pruning_table_cache_load("test_tables", "corrupt", &layout, (void **)&loaded));
+    }
+
+    free(table);
+}
+
+void test_cache_load_ignores_truncated_bundle() {
+    int *table  = make_table(0);
+    int *loaded = NULL;
+
+    pruning_table_cache_store("test_tables", "truncated", &layout, table);
+    pruning_table_cache_flush();
+    pruning_table_cache_clear();
+
+    FILE *f = fopen(get_config()->cache_file, "wb");
+    fputs("CUBOTRON", f);
+    fclose(f);
+
+    TEST_ASSERT_FALSE(pruning_table_cache_load("test_tables", "truncated", &layout, (void **)&loaded));
+
+    free(table);
+}
+
+void test_cache_load_missing_table() {
+    int *loaded = NULL;
+
+    TEST_ASSERT_FALSE(pruning_table_cache_load("test_tables", "does_not_exist", &layout, (void **)&loaded));
+}
+
+void setUp() {
+    init_config();
+    get_config()->cache_file = "cache/test_tables.bundle";
+}
+
+void tearDown() { pruning_table_cache_clear(); }
+
+int main() {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_cache_roundtrip_with_mmap);
+    RUN_TEST(test_cache_roundtrip_without_mmap);
+    RUN_TEST(test_cache_load_aligns_tables_to_a_cache_line);
+    RUN_TEST(test_cache_pads_tables_that_fill_their_pages);
+    RUN_TEST(test_cache_keeps_other_tables_when_storing);
+    RUN_TEST(test_cache_writes_stored_tables_on_flush);
+    RUN_TEST(test_cache_load_ignores_different_layout);
+    RUN_TEST(test_cache_load_ignores_corrupt_data);
+    RUN_TEST(test_cache_load_ignores_truncated_bundle);
+    RUN_TEST(test_cache_load_missing_table);
+
+    return UNITY_END();
+}
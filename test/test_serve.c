@@ -0,0 +1,115 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unity.h>
+
+#include <config.h>
+#include <definitions.h>
+#include <serve.h>
+
+void test_parse_facelets_with_defaults() {
+    char            line[] = "UUUURRRRFFFFDDDDLLLLBBBB\n";
+    serve_request_t request;
+
+    TEST_ASSERT_NULL(parse_serve_request(line, &request));
+    TEST_ASSERT_EQUAL_STRING("3x3", request.puzzle_type);
+    TEST_ASSERT_EQUAL_STRING("UUUURRRRFFFFDDDDLLLLBBBB", request.facelets);
+    TEST_ASSERT_NULL(request.scramble);
+    TEST_ASSERT_EQUAL_INT(get_config()->max_depth, request.max_depth);
+    TEST_ASSERT_EQUAL_INT(get_config()->n_solutions, request.n_solutions);
+
+    free_serve_request(&request);
+}
+
+void test_parse_scramble_with_options() {
+    char            line[] = "puzzle=2x2 max-depth=12 n-solutions=3 timeout=0.5 target-length=20 scramble=U R2 F'\n";
+    serve_request_t request;
+
+    TEST_ASSERT_NULL(parse_serve_request(line, &request));
+    TEST_ASSERT_EQUAL_STRING("2x2", request.puzzle_type);
+    TEST_ASSERT_NULL(request.facelets);
+    TEST_ASSERT_EQUAL_INT(12, request.max_depth);
+    TEST_ASSERT_EQUAL_INT(3, request.n_solutions);
+    TEST_ASSERT_EQUAL_FLOAT(0.5, request.timeout);
+    TEST_ASSERT_EQUAL_INT(20, request.target_length);
+
+    TEST_ASSERT_NOT_NULL(request.scramble);
+    TEST_ASSERT_EQUAL_INT(MOVE_U1, request.scramble[0]);
+    TEST_ASSERT_EQUAL_INT(MOVE_R2, request.scramble[1]);
+    TEST_ASSERT_EQUAL_INT(MOVE_F3, request.scramble[2]);
+    TEST_ASSERT_EQUAL_INT(MOVE_NULL, request.scramble[3]);
+
+    free_serve_request(&request);
+}
+
+void test_parse_rejects_bad_requests() {
+    const char *lines[] = {
+        "max-depth=abc UUUU", "max-depth=0 UUUU", "foo=1 UUUU",    "timeout=-1 UUUU",
+        "UUUU RRRR",          "UUUU scramble=U",  "scramble=U X", "",
+    };
+
+    for (size_t i = 0; i < sizeof(lines) / sizeof(lines[0]); i++) {
+        char            line[64];
+        serve_request_t request;
+
+        snprintf(line, sizeof(line), "%s", lines[i]);
+
+        TEST_ASSERT_NOT_NULL_MESSAGE(parse_serve_request(line, &request), lines[i]);
+        free_serve_request(&request);
+    }
+}
+
+void test_serve_answers_one_line_per_request() {
+    char input[] = "puzzle=2x2 UUUURRRRFFFFDDDDLLLLBBBB\n"
+                   "\n"
+                   "# comment\n"
+                   "puzzle=2x2 scramble=R U F\n"
+                   "puzzle=2x2 UUUURRRRFFFFDDDDLLLLBBBU\n"
+                   "puzzle=4x4 UUUU\n"
+                   // A flipped UF edge, then the UF and UB edges swapped
+                   "UUUUUUUFURRRRRRRRRFUFFFFFFFDDDDDDDDDLLLLLLLLLBBBBBBBBB\n"
+                   "UUUUUUUUURRRRRRRRRFBFFFFFFFDDDDDDDDDLLLLLLLLLBFBBBBBBB\n"
+                   "puzzle=2x2 UUUURRRRFFFFDDDDLLLLBBBB\n";
+    char output[1024] = {0};
+
+    FILE *in  = fmemopen(input, strlen(input), "r");
+    FILE *out = fmemopen(output, sizeof(output), "w");
+
+    run_serve(in, out);
+
+    fclose(in);
+    fclose(out);
+
+    char *lines[8];
+    int   n_lines = 0;
+
+    for (char *line = strtok(output, "\n"); line != NULL && n_lines < 8; line = strtok(NULL, "\n"))
+        lines[n_lines++] = line;
+
+    TEST_ASSERT_EQUAL_INT(7, n_lines);
+    TEST_ASSERT_EQUAL_STRING("ok 0", lines[0]);
+    TEST_ASSERT_EQUAL_INT(0, strncmp("ok ", lines[1], 3));
+    TEST_ASSERT_EQUAL_STRING("error invalid facelets", lines[2]);
+    TEST_ASSERT_EQUAL_STRING("error unknown puzzle", lines[3]);
+    TEST_ASSERT_EQUAL_STRING("error invalid facelets", lines[4]);
+    TEST_ASSERT_EQUAL_STRING("error invalid facelets", lines[5]);
+    TEST_ASSERT_EQUAL_STRING("ok 0", lines[6]);
+}
+
+void setUp() {
+    init_config();
+    get_config()->max_depth = 14;
+}
+
+void tearDown() {}
+
+int main() {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_parse_facelets_with_defaults);
+    RUN_TEST(test_parse_scramble_with_options);
+    RUN_TEST(test_parse_rejects_bad_requests);
+    RUN_TEST(test_serve_answers_one_line_per_request);
+
+    return UNITY_END();
+}
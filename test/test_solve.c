@@ -1,4 +1,5 @@
 #include <pcg_variants.h>
+#include <pthread.h>
 #include <string.h>
 #include <unity.h>
 
@@ -6,11 +7,12 @@
 #include <facelets.h>
 #include <move_tables.h>
 #include <pruning.h>
+#include <pruning_cache.h>
 #include <sample_facelets.h>
 #include <solve.h>
 #include <utils.h>
 
-static int solution_length(const move_t *solution) {
+static int solution_length(const uint8_t *solution) {
     int len = 0;
     while (solution[len] != MOVE_NULL)
         len++;
@@ -33,7 +35,7 @@ void test_random_phase1_solving() {
         TEST_ASSERT_TRUE(solutions != NULL);
         TEST_ASSERT_TRUE(solutions->solution != NULL);
 
-        move_t *solution = solutions->solution;
+        uint8_t *solution = solutions->solution;
 
         for (int j = 0; solution[j] != MOVE_NULL; j++) {
             coord_apply_move(cube, solution[j]);
@@ -115,7 +117,8 @@ void test_random_phase2_solving() {
         TEST_ASSERT_TRUE(solutions != NULL);
         TEST_ASSERT_TRUE(solutions->solution != NULL);
 
-        coord_apply_moves(cube, solutions->solution, 0); // Apply all moves
+        for (int j = 0; solutions->solution[j] != MOVE_NULL; j++)
+            coord_apply_move(cube, solutions->solution[j]);
 
         TEST_ASSERT_TRUE(is_phase1_solved(cube));
         TEST_ASSERT_TRUE(is_phase2_solved(cube));
@@ -147,7 +150,7 @@ void test_facelets_solve_with_max_length() {
 
         TEST_ASSERT_TRUE(length <= max_length);
 
-        free(solution);
+        destroy_solve_list(solution);
     }
 }
 
@@ -178,7 +181,7 @@ void test_random_full_solver_with_random_scrambles_single_solution() {
         TEST_ASSERT_TRUE(is_phase1_solved(cube));
         TEST_ASSERT_TRUE(is_phase2_solved(cube));
 
-        free(solution);
+        destroy_solve_list(solution);
     }
 
     free(cube);
@@ -213,7 +216,8 @@ void test_random_full_solver_with_random_scrambles_multiple_solution() {
 
         /*TEST_MESSAGE(buffer);*/
 
-        solve_list_t *solution = solve_single(cube);
+        solve_list_t *solutions = solve_single(cube);
+        solve_list_t *solution  = solutions;
 
         do {
             coord_cube_t *cube_copy = get_coord_cube();
@@ -231,7 +235,7 @@ void test_random_full_solver_with_random_scrambles_multiple_solution() {
             free(cube_copy);
         } while (solution != NULL && solution->solution != NULL);
 
-        free(solution);
+        destroy_solve_list(solutions);
     }
 
     free(cube);
@@ -261,7 +265,7 @@ void test_random_full_solver_with_sample_cubes_single_solution() {
         TEST_ASSERT_TRUE(is_phase1_solved(cube));
         TEST_ASSERT_TRUE(is_phase2_solved(cube));
 
-        free(solution);
+        destroy_solve_list(solution);
         free(cube);
     }
 }
@@ -317,7 +321,7 @@ void test_solve_with_move_blacklist() {
             TEST_ASSERT_TRUE(is_phase1_solved(cube));
             TEST_ASSERT_TRUE(is_phase2_solved(cube));
 
-            free(solution);
+            destroy_solve_list(solution);
             free(cube);
         }
     }
@@ -401,8 +405,8 @@ void test_phase2_solves_r2_l2_in_2_moves() {
     solve_context_t *ctx = make_solve_context(cube);
     copy_coord_cube(ctx->phase2_context->cube, cube);
 
-    solve_stats_t *stats = get_solve_stats();
-    move_t        *solution = solve_phase2(ctx->phase2_context, get_config(), 2, stats);
+    solve_stats_t *stats    = get_solve_stats();
+    const uint8_t *solution = solve_phase2(ctx->phase2_context, get_config(), 2, stats);
 
     TEST_ASSERT_NOT_NULL(solution);
 
@@ -413,7 +417,6 @@ void test_phase2_solves_r2_l2_in_2_moves() {
             coord_apply_move(verify, solution[i]);
         TEST_ASSERT_TRUE(is_phase2_solved(verify));
         free(verify);
-        free(solution);
     }
 
     free(stats);
@@ -421,6 +424,144 @@ void test_phase2_solves_r2_l2_in_2_moves() {
     free(cube);
 }
 
+void test_phase2_cache_remembers_results() {
+    coord_cube_t *cube = get_coord_cube();
+    reset_coord_cube(cube);
+    coord_apply_move(cube, MOVE_R2);
+    coord_apply_move(cube, MOVE_U1);
+    coord_apply_move(cube, MOVE_F2);
+    coord_apply_move(cube, MOVE_D2);
+
+    get_config()->phase2_cache = 1;
+    solve_context_t *ctx       = make_solve_context(cube);
+    copy_coord_cube(ctx->phase2_context->cube, cube);
+
+    solve_stats_t *stats = get_solve_stats();
+
+    // Too shallow, then resumed from the depth that was already searched
+    TEST_ASSERT_NULL(solve_phase2(ctx->phase2_context, get_config(), 2, stats));
+    TEST_ASSERT_NULL(solve_phase2(ctx->phase2_context, get_config(), 2, stats));
+    TEST_ASSERT_EQUAL_INT(1, stats->phase2_cache_hits);
+
+    // The results are only good until the next search, so the first one is kept aside
+    uint8_t        solution[SOLUTION_CAPACITY];
+    const uint8_t *searched = solve_phase2(ctx->phase2_context, get_config(), 10, stats);
+    TEST_ASSERT_NOT_NULL(searched);
+    TEST_ASSERT_EQUAL_INT(4, get_solution_length(searched));
+    memcpy(solution, searched, get_solution_length(searched) + 1);
+
+    const uint8_t *cached = solve_phase2(ctx->phase2_context, get_config(), 10, stats);
+    TEST_ASSERT_EQUAL_INT(2, stats->phase2_cache_hits);
+    TEST_ASSERT_TRUE(are_solutions_equal(solution, cached));
+
+    // A known solution that does not fit the depth is no solution
+    TEST_ASSERT_NULL(solve_phase2(ctx->phase2_context, get_config(), 3, stats));
+    TEST_ASSERT_EQUAL_INT(3, stats->phase2_cache_hits);
+
+    // A new solve starts with an empty cache
+    reset_solve_context(ctx, cube);
+    copy_coord_cube(ctx->phase2_context->cube, cube);
+    const uint8_t *fresh = solve_phase2(ctx->phase2_context, get_config(), 10, stats);
+    TEST_ASSERT_EQUAL_INT(3, stats->phase2_cache_hits);
+    TEST_ASSERT_TRUE(are_solutions_equal(solution, fresh));
+
+    free(stats);
+    destroy_solve_context(ctx);
+    free(cube);
+}
+
+void test_phase2_batch_solves_the_shortest_first() {
+    const move_t scrambles[][6] = {
+        {MOVE_R2, MOVE_U1, MOVE_F2, MOVE_D3, MOVE_L2, MOVE_NULL},
+        {MOVE_U2, MOVE_B2, MOVE_NULL},
+        {MOVE_D1, MOVE_R2, MOVE_U3, MOVE_NULL},
+    };
+    const int n_candidates = sizeof(scrambles) / sizeof(scrambles[0]);
+
+    solve_request_t request;
+    init_solve_request(&request, get_config());
+
+    coord_cube_t    *cube  = get_coord_cube();
+    solve_context_t *ctx   = make_solve_context(cube);
+    solve_stats_t   *stats = get_solve_stats();
+
+    ctx->phase2_context->request = &request;
+
+    phase2_candidate_t candidates[3];
+    for (int i = 0; i < n_candidates; i++) {
+        reset_coord_cube(&candidates[i].cube);
+        for (int j = 0; scrambles[i][j] != MOVE_NULL; j++)
+            coord_apply_move(&candidates[i].cube, scrambles[i][j]);
+
+        candidates[i].phase1_length = 0;
+        candidates[i].phase2_depth  = 10;
+    }
+
+    const uint8_t *solution = NULL;
+    int solved = solve_phase2_batch(ctx->phase2_context, get_config(), candidates, n_candidates, &solution, stats);
+
+    TEST_ASSERT_TRUE(solved >= 0);
+    TEST_ASSERT_EQUAL_INT(2, get_solution_length(solution));
+
+    copy_coord_cube(cube, &candidates[solved].cube);
+    for (int i = 0; solution[i] != MOVE_NULL; i++)
+        coord_apply_move(cube, solution[i]);
+    TEST_ASSERT_TRUE(is_coord_solved(cube));
+
+    // Out of its depth budget, the next shortest one is solved instead
+    candidates[solved].phase2_depth = 1;
+    solved = solve_phase2_batch(ctx->phase2_context, get_config(), candidates, n_candidates, &solution, stats);
+
+    TEST_ASSERT_TRUE(solved >= 0);
+    TEST_ASSERT_EQUAL_INT(3, get_solution_length(solution));
+
+    // Nothing fits in the request bound
+    request.max_depth = 1;
+    solved = solve_phase2_batch(ctx->phase2_context, get_config(), candidates, n_candidates, &solution, stats);
+    TEST_ASSERT_EQUAL_INT(-1, solved);
+    TEST_ASSERT_NULL(solution);
+
+    free(stats);
+    destroy_solve_context(ctx);
+    free(cube);
+}
+
+void test_solve_with_phase2_batches() {
+    config_t *config     = get_config();
+    config->n_solutions  = 5;
+    config->max_depth    = 20;
+    config->thread_count = 2;
+
+    const int batch_sizes[]    = {8, 256, 64};
+    const int phase2_threads[] = {0, 0, 1};
+
+    coord_cube_t *cube = get_coord_cube();
+    scramble_cube(cube, 30);
+
+    for (size_t t = 0; t < sizeof(batch_sizes) / sizeof(batch_sizes[0]); t++) {
+        config->phase2_batch_size = batch_sizes[t];
+        config->phase2_threads    = phase2_threads[t];
+
+        solve_list_t *solutions = solve(cube, config);
+
+        int count = 0;
+        for (solve_list_t *current = solutions; current != NULL && current->solution != NULL;
+             current = current->next) {
+            TEST_ASSERT_TRUE(is_move_sequence_a_solution_for_cube(cube, current->solution));
+            TEST_ASSERT_TRUE(get_solution_length(current->solution) <= config->max_depth);
+            TEST_ASSERT_FALSE(is_duplicate_solution(current->next, current->solution));
+            count++;
+        }
+
+        TEST_ASSERT_EQUAL_INT(config->n_solutions, count);
+
+        destroy_solve_list(solutions);
+    }
+
+    free(cube);
+    destroy_solve_pool();
+}
+
 void test_edge_case_solved_cube() {
     coord_cube_t *cube = get_coord_cube();
     reset_coord_cube(cube);
@@ -435,7 +576,8 @@ void test_edge_case_solved_cube() {
 
     coord_cube_t *test_cube = get_coord_cube();
     copy_coord_cube(test_cube, cube);
-    coord_apply_moves(test_cube, solutions->solution, 0);
+    for (int j = 0; solutions->solution[j] != MOVE_NULL; j++)
+        coord_apply_move(test_cube, solutions->solution[j]);
     TEST_ASSERT_TRUE(is_coord_solved(test_cube));
 
     free(test_cube);
@@ -567,14 +709,14 @@ void test_multiple_solutions() {
 }
 
 void test_are_solutions_equal() {
-    move_t a[] = {MOVE_U1, MOVE_R2, MOVE_NULL};
-    move_t b[] = {MOVE_U1, MOVE_R2, MOVE_NULL};
-    move_t c[] = {MOVE_U1, MOVE_R3, MOVE_NULL};
-    move_t d[] = {MOVE_U1, MOVE_NULL};
-    move_t e[] = {MOVE_NULL};
+    uint8_t a[] = {MOVE_U1, MOVE_R2, MOVE_NULL};
+    uint8_t b[] = {MOVE_U1, MOVE_R2, MOVE_NULL};
+    uint8_t c[] = {MOVE_U1, MOVE_R3, MOVE_NULL};
+    uint8_t d[] = {MOVE_U1, MOVE_NULL};
+    uint8_t e[] = {MOVE_NULL};
 
-    move_t f[] = {MOVE_U2, MOVE_R2, MOVE_NULL};
-    move_t g[] = {MOVE_R2, MOVE_NULL};
+    uint8_t f[] = {MOVE_U2, MOVE_R2, MOVE_NULL};
+    uint8_t g[] = {MOVE_R2, MOVE_NULL};
 
     TEST_ASSERT_TRUE(are_solutions_equal(a, b));
     TEST_ASSERT_TRUE(are_solutions_equal(e, e));
@@ -598,9 +740,9 @@ void test_multi_solution_no_duplicates() {
     solve_list_t *solutions = solve(cube, config);
     TEST_ASSERT_NOT_NULL(solutions);
 
-    const move_t *sols[32];
-    int           count   = 0;
-    solve_list_t *current = solutions;
+    const uint8_t *sols[32];
+    int            count   = 0;
+    solve_list_t  *current = solutions;
     while (current != NULL && current->solution != NULL && count < 32) {
         sols[count++] = current->solution;
         current       = current->next;
@@ -621,6 +763,297 @@ void test_multi_solution_no_duplicates() {
     config->max_depth   = orig_d;
 }
 
+void test_solve_with_any_thread_count() {
+    config_t *config    = get_config();
+    config->n_solutions = 3;
+    config->max_depth   = 20;
+
+    const int thread_counts[] = {1, 3, 32};
+
+    coord_cube_t *cube = get_coord_cube();
+    scramble_cube(cube, 30);
+
+    for (size_t t = 0; t < sizeof(thread_counts) / sizeof(thread_counts[0]); t++) {
+        config->thread_count = thread_counts[t];
+
+        solve_list_t *solutions = solve(cube, config);
+        TEST_ASSERT_NOT_NULL(solutions);
+
+        int           count   = 0;
+        solve_list_t *current = solutions;
+        while (current != NULL && current->solution != NULL) {
+            coord_cube_t *solved = get_coord_cube();
+            copy_coord_cube(solved, cube);
+
+            for (int i = 0; current->solution[i] != MOVE_NULL; i++)
+                coord_apply_move(solved, current->solution[i]);
+
+            TEST_ASSERT_TRUE(is_coord_solved(solved));
+            TEST_ASSERT_TRUE(solution_length(current->solution) <= config->max_depth);
+            TEST_ASSERT_FALSE(is_duplicate_solution(current->next, current->solution));
+
+            free(solved);
+            count++;
+            current = current->next;
+        }
+
+        TEST_ASSERT_EQUAL_INT(config->n_solutions, count);
+
+        destroy_solve_list(solutions);
+    }
+
+    free(cube);
+}
+
+void test_prefetch_does_not_change_solutions() {
+    config_t *config     = get_config();
+    config->n_solutions  = 3;
+    config->max_depth    = 20;
+    config->thread_count = 1;
+
+    coord_cube_t *cube = get_coord_cube();
+    scramble_cube(cube, 30);
+
+    config->prefetch            = 1;
+    solve_list_t *with_prefetch = solve(cube, config);
+
+    config->prefetch               = 0;
+    solve_list_t *without_prefetch = solve(cube, config);
+
+    solve_list_t *a = with_prefetch;
+    solve_list_t *b = without_prefetch;
+    while (a != NULL && a->solution != NULL) {
+        TEST_ASSERT_NOT_NULL(b);
+        TEST_ASSERT_TRUE(are_solutions_equal(a->solution, b->solution));
+        a = a->next;
+        b = b->next;
+    }
+    TEST_ASSERT_TRUE(b == NULL || b->solution == NULL);
+
+    destroy_solve_list(with_prefetch);
+    destroy_solve_list(without_prefetch);
+    free(cube);
+}
+
+void test_flipslice_twist_pruning_finds_solutions_of_the_same_length() {
+    config_t *config     = get_config();
+    config->n_solutions  = 1;
+    config->max_depth    = 20;
+    config->thread_count = 1;
+
+    coord_cube_t *cube = get_coord_cube();
+
+    for (int i = 0; i < 5; i++) {
+        reset_coord_cube(cube);
+        scramble_cube(cube, 30);
+
+        config->phase1_pruning    = PHASE1_PRUNING_PROJECTIONS;
+        solve_list_t *projections = solve(cube, config);
+
+        config->phase1_pruning        = PHASE1_PRUNING_FLIPSLICE_TWIST;
+        solve_list_t *flipslice_twist = solve(cube, config);
+
+        TEST_ASSERT_NOT_NULL(projections->solution);
+        TEST_ASSERT_NOT_NULL(flipslice_twist->solution);
+        TEST_ASSERT_EQUAL_INT(get_solution_length(projections->solution),
+                              get_solution_length(flipslice_twist->solution));
+
+        destroy_solve_list(projections);
+        destroy_solve_list(flipslice_twist);
+    }
+
+    config->phase1_pruning = PHASE1_PRUNING_PROJECTIONS;
+    free(cube);
+}
+
+void test_solve_with_phase2_threads() {
+    config_t *config     = get_config();
+    config->n_solutions  = 5;
+    config->max_depth    = 20;
+    config->thread_count = 4;
+
+    const int phase2_threads[] = {1, 3, 8};
+
+    coord_cube_t *cube = get_coord_cube();
+    scramble_cube(cube, 30);
+
+    for (size_t t = 0; t < sizeof(phase2_threads) / sizeof(phase2_threads[0]); t++) {
+        config->phase2_threads = phase2_threads[t];
+
+        solve_list_t *solutions = solve(cube, config);
+        TEST_ASSERT_NOT_NULL(solutions);
+
+        int           count   = 0;
+        int           last    = 0;
+        solve_list_t *current = solutions;
+        while (current != NULL && current->solution != NULL) {
+            TEST_ASSERT_TRUE(is_move_sequence_a_solution_for_cube(cube, current->solution));
+            TEST_ASSERT_TRUE(get_solution_length(current->solution) <= config->max_depth);
+            TEST_ASSERT_TRUE(get_solution_length(current->solution) >= last);
+            TEST_ASSERT_FALSE(is_duplicate_solution(current->next, current->solution));
+
+            last = get_solution_length(current->solution);
+            count++;
+            current = current->next;
+        }
+
+        TEST_ASSERT_EQUAL_INT(config->n_solutions, count);
+
+        destroy_solve_list(solutions);
+    }
+
+    free(cube);
+    destroy_solve_pool();
+}
+
+void test_cancelled_request_finds_nothing() {
+    coord_cube_t *cube = get_coord_cube();
+    scramble_cube(cube, 30);
+
+    solve_request_t request;
+    init_solve_request(&request, get_config());
+    cancel_solve_request(&request);
+
+    solve_list_t *solutions = solve_with_request(cube, get_config(), &request);
+    TEST_ASSERT_TRUE(solutions == NULL || solutions->solution == NULL);
+
+    destroy_solve_list(solutions);
+    free(cube);
+}
+
+#define N_CONCURRENT_SOLVES 4
+
+typedef struct {
+    coord_cube_t *cube;
+    solve_list_t *solutions;
+} concurrent_solve_t;
+
+static void *concurrent_solve(void *arg) {
+    concurrent_solve_t *job = (concurrent_solve_t *)arg;
+    job->solutions          = solve(job->cube, get_config());
+    return NULL;
+}
+
+void test_timeout_returns_shorter_solution_in_time() {
+    config_t *config     = get_config();
+    config->thread_count = 1;
+
+    coord_cube_t *cube = get_coord_cube();
+    scramble_cube(cube, 30);
+
+    solve_list_t *first = solve(cube, config);
+    TEST_ASSERT_NOT_NULL(first->solution);
+
+    config->timeout = 1;
+
+    uint64_t      start = get_microseconds();
+    solve_list_t *best  = solve(cube, config);
+    uint64_t      end   = get_microseconds();
+
+    TEST_ASSERT_NOT_NULL(best->solution);
+    TEST_ASSERT_NULL(best->next);
+    TEST_ASSERT_TRUE(solution_length(best->solution) <= solution_length(first->solution));
+    TEST_ASSERT_TRUE(end - start < 2500000);
+
+    coord_cube_t *solved = get_coord_cube();
+    copy_coord_cube(solved, cube);
+
+    for (int i = 0; best->solution[i] != MOVE_NULL; i++)
+        coord_apply_move(solved, best->solution[i]);
+
+    TEST_ASSERT_TRUE(is_coord_solved(solved));
+
+    free(solved);
+    destroy_solve_list(first);
+    destroy_solve_list(best);
+    free(cube);
+}
+
+void test_target_length_stops_once_reached() {
+    config_t *config     = get_config();
+    config->thread_count = 1;
+
+    coord_cube_t *cube = get_coord_cube();
+    scramble_cube(cube, 30);
+
+    solve_list_t *first = solve(cube, config);
+    TEST_ASSERT_NOT_NULL(first->solution);
+    int first_length = solution_length(first->solution);
+
+    // Already reached by the first solution, so it stops right there
+    config->target_length = first_length;
+    solve_list_t *same    = solve(cube, config);
+    TEST_ASSERT_NOT_NULL(same->solution);
+    TEST_ASSERT_TRUE(are_solutions_equal(first->solution, same->solution));
+
+    config->target_length = first_length - 1;
+    config->timeout       = 5;
+
+    uint64_t      start   = get_microseconds();
+    solve_list_t *shorter = solve(cube, config);
+    uint64_t      end     = get_microseconds();
+
+    TEST_ASSERT_NOT_NULL(shorter->solution);
+    TEST_ASSERT_TRUE(solution_length(shorter->solution) <= first_length - 1 || end - start >= 5000000);
+
+    destroy_solve_list(first);
+    destroy_solve_list(same);
+    destroy_solve_list(shorter);
+    free(cube);
+}
+
+void test_six_way_solutions_solve_the_original_cube() {
+    config_t *config    = get_config();
+    config->six_way     = 1;
+    config->n_solutions = 3;
+    config->max_depth   = 22;
+
+    for (int i = 0; i < 5; i++) {
+        coord_cube_t *cube = get_coord_cube();
+        scramble_cube(cube, 30);
+
+        solve_list_t *solutions = solve(cube, config);
+        TEST_ASSERT_NOT_NULL(solutions->solution);
+
+        for (solve_list_t *node = solutions; node != NULL && node->solution != NULL; node = node->next) {
+            TEST_ASSERT_TRUE(is_move_sequence_a_solution_for_cube(cube, node->solution));
+            TEST_ASSERT_TRUE(solution_length(node->solution) <= config->max_depth);
+            TEST_ASSERT_FALSE(is_duplicate_solution(node->next, node->solution));
+        }
+
+        destroy_solve_list(solutions);
+        free(cube);
+    }
+}
+
+void test_concurrent_solves_are_independent() {
+    concurrent_solve_t jobs[N_CONCURRENT_SOLVES];
+    pthread_t          threads[N_CONCURRENT_SOLVES];
+
+    get_config()->max_depth = 22;
+
+    for (int i = 0; i < N_CONCURRENT_SOLVES; i++) {
+        jobs[i].cube = get_coord_cube();
+        scramble_cube(jobs[i].cube, 30);
+        pthread_create(&threads[i], NULL, concurrent_solve, &jobs[i]);
+    }
+
+    for (int i = 0; i < N_CONCURRENT_SOLVES; i++) {
+        pthread_join(threads[i], NULL);
+
+        TEST_ASSERT_NOT_NULL(jobs[i].solutions);
+        TEST_ASSERT_NOT_NULL(jobs[i].solutions->solution);
+
+        for (int j = 0; jobs[i].solutions->solution[j] != MOVE_NULL; j++)
+            coord_apply_move(jobs[i].cube, jobs[i].solutions->solution[j]);
+
+        TEST_ASSERT_TRUE(is_coord_solved(jobs[i].cube));
+
+        destroy_solve_list(jobs[i].solutions);
+        free(jobs[i].cube);
+    }
+}
+
 void test_stats_per_thread_consistent() {
     config_t *config   = get_config();
     int       orig_n   = config->n_solutions;
@@ -686,15 +1119,15 @@ void test_aggregate_consistent() {
 }
 
 void test_is_duplicate_solution() {
-    solve_list_t *head = new_solve_list_node();
-    solve_list_t *empty = new_solve_list_node();
+    solve_list_t *head  = new_solve_list_node(make_solve_arena());
+    solve_list_t *empty = new_solve_list_node(make_solve_arena());
 
-    move_t sol1[] = {MOVE_U1, MOVE_R2, MOVE_NULL};
-    move_t sol2[] = {MOVE_U2, MOVE_R2, MOVE_NULL};
+    uint8_t sol1[] = {MOVE_U1, MOVE_R2, MOVE_NULL};
+    uint8_t sol2[] = {MOVE_U2, MOVE_R2, MOVE_NULL};
 
-    head->solution = sol1;
-    head->next = new_solve_list_node();
-    move_t sol3[] = {MOVE_D1, MOVE_NULL};
+    head->solution       = sol1;
+    head->next           = new_solve_list_node(head->arena);
+    uint8_t sol3[]       = {MOVE_D1, MOVE_NULL};
     head->next->solution = sol3;
 
     TEST_ASSERT_TRUE(is_duplicate_solution(head, sol1));
@@ -702,24 +1135,22 @@ void test_is_duplicate_solution() {
     TEST_ASSERT_FALSE(is_duplicate_solution(head, sol2));
     TEST_ASSERT_FALSE(is_duplicate_solution(empty, sol1));
 
-    head->solution = NULL;
-    head->next->solution = NULL;
     destroy_solve_list(head);
     destroy_solve_list(empty);
 }
 
 void test_truncate_solutions() {
-    solve_list_t *head = new_solve_list_node();
+    solve_list_t *head = new_solve_list_node(make_solve_arena());
     solve_list_t *cur  = head;
 
-    cur->solution = malloc(sizeof(move_t) * 2);
+    cur->solution    = new_solution(head->arena);
     cur->solution[0] = MOVE_U1;
     cur->solution[1] = MOVE_NULL;
 
     for (int i = 1; i < 5; i++) {
-        cur->next       = new_solve_list_node();
-        cur             = cur->next;
-        cur->solution   = malloc(sizeof(move_t) * 2);
+        cur->next        = new_solve_list_node(head->arena);
+        cur              = cur->next;
+        cur->solution    = new_solution(head->arena);
         cur->solution[0] = MOVE_U1 + i;
         cur->solution[1] = MOVE_NULL;
     }
@@ -740,6 +1171,78 @@ void test_truncate_solutions() {
     destroy_solve_list(head);
 }
 
+void test_sort_solutions_by_length() {
+    const int      lengths[] = {3, 1, 2, 1, 3};
+    solve_list_t  *head      = NULL;
+    solve_arena_t *arena     = make_solve_arena();
+
+    for (int i = 4; i >= 0; i--) {
+        solve_list_t *node = new_solve_list_node(arena);
+        node->solution     = new_solution(arena);
+
+        for (int j = 0; j < lengths[i]; j++)
+            node->solution[j] = MOVE_U1 + i;
+        node->solution[lengths[i]] = MOVE_NULL;
+
+        node->next = head;
+        head       = node;
+    }
+
+    head = sort_solutions_by_length(head);
+
+    // Same length solutions keep their order
+    const move_t expected_first_moves[] = {MOVE_U2, MOVE_R1, MOVE_U3, MOVE_U1, MOVE_R2};
+
+    int           count = 0;
+    solve_list_t *node  = head;
+    for (; node != NULL; node = node->next, count++)
+        TEST_ASSERT_EQUAL_INT(expected_first_moves[count], node->solution[0]);
+
+    TEST_ASSERT_EQUAL_INT(5, count);
+
+    destroy_solve_list(head);
+}
+
+void test_solutions_come_sorted_by_length() {
+    config_t *config    = get_config();
+    config->n_solutions = 5;
+    config->max_depth   = 22;
+
+    coord_cube_t *cube = get_coord_cube();
+    scramble_cube(cube, 30);
+
+    solve_list_t *solutions = solve(cube, config);
+    TEST_ASSERT_NOT_NULL(solutions->solution);
+
+    for (solve_list_t *node = solutions; node->next != NULL && node->next->solution != NULL; node = node->next)
+        TEST_ASSERT_TRUE(solution_length(node->solution) <= solution_length(node->next->solution));
+
+    destroy_solve_list(solutions);
+    free(cube);
+}
+
+void test_request_bound_keeps_the_shortest_solutions() {
+    config_t *config    = get_config();
+    config->n_solutions = 2;
+    config->max_depth   = 25;
+    config->timeout     = 10;
+
+    solve_request_t request;
+    init_solve_request(&request, config);
+
+    TEST_ASSERT_EQUAL_INT(25, get_solve_request_bound(&request));
+
+    TEST_ASSERT_TRUE(add_solve_request_solution(&request, 22));
+    TEST_ASSERT_EQUAL_INT(25, get_solve_request_bound(&request));
+
+    TEST_ASSERT_TRUE(add_solve_request_solution(&request, 21));
+    TEST_ASSERT_EQUAL_INT(21, get_solve_request_bound(&request));
+    TEST_ASSERT_FALSE(add_solve_request_solution(&request, 22));
+
+    TEST_ASSERT_TRUE(add_solve_request_solution(&request, 19));
+    TEST_ASSERT_EQUAL_INT(20, get_solve_request_bound(&request));
+}
+
 void test_phase1_only_solution() {
     config_t *config = get_config();
     config->n_solutions = 0;
@@ -775,12 +1278,47 @@ void test_phase1_only_solution() {
     config->max_depth   = 25;
 }
 
+void test_phase1_only_solution_at_max_depth() {
+    config_t *config    = get_config();
+    config->n_solutions = 0;
+    config->max_depth   = 15;
+
+    coord_cube_t *cube = get_coord_cube();
+    scramble_cube(cube, 50);
+    coord_cube_t *original = get_coord_cube();
+    copy_coord_cube(original, cube);
+
+    // Phase1 is searched depth by depth, so the first solution found is one of the shortest
+    solve_list_t *solutions = solve(cube, config);
+    TEST_ASSERT_NOT_NULL(solutions->solution);
+    int length = get_solution_length(solutions->solution);
+    destroy_solve_list(solutions);
+
+    // A phase1 solution doesn't need a phase2 move after it, so one exactly max_depth long is still found
+    config->max_depth = length;
+    copy_coord_cube(cube, original);
+    solutions = solve(cube, config);
+    TEST_ASSERT_NOT_NULL(solutions);
+    TEST_ASSERT_NOT_NULL(solutions->solution);
+    TEST_ASSERT_EQUAL_INT(length, get_solution_length(solutions->solution));
+
+    free(original);
+    free(cube);
+    destroy_solve_list(solutions);
+
+    config->n_solutions = 1;
+    config->max_depth   = 25;
+}
+
 void setUp() { init_config(); }
 void tearDown() {}
 
 int main() {
+    init_config();
     build_move_tables();
     build_pruning_tables();
+    build_phase1_flipslice_twist_table();
+    pruning_table_cache_flush();
 
     pcg32_srandom(43u, 55u);
 
@@ -792,14 +1330,30 @@ int main() {
     RUN_TEST(test_solution_correctness_comprehensive);
     RUN_TEST(test_solution_validity);
     RUN_TEST(test_phase2_solves_r2_l2_in_2_moves);
+    RUN_TEST(test_phase2_cache_remembers_results);
+    RUN_TEST(test_phase2_batch_solves_the_shortest_first);
     RUN_TEST(test_edge_case_solved_cube);
     RUN_TEST(test_solved_cube_returns_zero_length);
     RUN_TEST(test_multiple_solutions);
     RUN_TEST(test_are_solutions_equal);
     RUN_TEST(test_multi_solution_no_duplicates);
+    RUN_TEST(test_solve_with_any_thread_count);
+    RUN_TEST(test_prefetch_does_not_change_solutions);
+    RUN_TEST(test_flipslice_twist_pruning_finds_solutions_of_the_same_length);
+    RUN_TEST(test_solve_with_phase2_threads);
+    RUN_TEST(test_solve_with_phase2_batches);
+    RUN_TEST(test_cancelled_request_finds_nothing);
+    RUN_TEST(test_timeout_returns_shorter_solution_in_time);
+    RUN_TEST(test_target_length_stops_once_reached);
+    RUN_TEST(test_six_way_solutions_solve_the_original_cube);
+    RUN_TEST(test_concurrent_solves_are_independent);
     RUN_TEST(test_is_duplicate_solution);
     RUN_TEST(test_truncate_solutions);
+    RUN_TEST(test_sort_solutions_by_length);
+    RUN_TEST(test_solutions_come_sorted_by_length);
+    RUN_TEST(test_request_bound_keeps_the_shortest_solutions);
     RUN_TEST(test_phase1_only_solution);
+    RUN_TEST(test_phase1_only_solution_at_max_depth);
     RUN_TEST(test_stats_per_thread_consistent);
     RUN_TEST(test_aggregate_consistent);
     RUN_TEST(test_edge_case_single_move_scrambles);
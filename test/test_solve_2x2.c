@@ -9,14 +9,14 @@
 #include <solver.h>
 #include <solvers/solver_2x2_ida.h>
 
-static int solution_length(const move_t *solution) {
+static int solution_length(const uint8_t *solution) {
     int len = 0;
     while (solution[len] != MOVE_NULL)
         len++;
     return len;
 }
 
-static int verify_solution(const char *facelets, const move_t *solution) {
+static int verify_solution(const char *facelets, const uint8_t *solution) {
     cube_2x2_t cube;
     puzzle_2x2_ops.from_string(&cube, facelets);
 
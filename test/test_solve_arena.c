@@ -0,0 +1,140 @@
+#include <pthread.h>
+#include <stdalign.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <unity.h>
+
+#include <solve_arena.h>
+
+#define N_THREADS       4
+#define N_THREAD_ALLOCS 2000
+
+static int is_aligned(const void *pointer) { return (uintptr_t)pointer % alignof(max_align_t) == 0; }
+
+static int is_zeroed(const unsigned char *memory, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        if (memory[i] != 0)
+            return 0;
+    }
+    return 1;
+}
+
+void test_arena_returns_aligned_zeroed_memory() {
+    solve_arena_t *arena = make_solve_arena();
+
+    for (size_t size = 1; size < 200; size += 7) {
+        unsigned char *memory = solve_arena_alloc(arena, size);
+
+        TEST_ASSERT_TRUE(is_aligned(memory));
+        TEST_ASSERT_TRUE(is_zeroed(memory, size));
+
+        for (size_t i = 0; i < size; i++)
+            memory[i] = 0xAB;
+    }
+
+    destroy_solve_arena(arena);
+}
+
+void test_arena_allocations_do_not_overlap() {
+    solve_arena_t *arena = make_solve_arena();
+    unsigned char *memory[100];
+
+    // Enough to fill a few blocks
+    for (int i = 0; i < 100; i++) {
+        memory[i] = solve_arena_alloc(arena, 300);
+        for (int j = 0; j < 300; j++)
+            memory[i][j] = (unsigned char)i;
+    }
+
+    for (int i = 0; i < 100; i++) {
+        for (int j = 0; j < 300; j++)
+            TEST_ASSERT_EQUAL_INT(i, memory[i][j]);
+    }
+
+    destroy_solve_arena(arena);
+}
+
+void test_arena_allocates_more_than_a_block() {
+    solve_arena_t *arena = make_solve_arena();
+
+    unsigned char *small = solve_arena_alloc(arena, 16);
+    unsigned char *big   = solve_arena_alloc(arena, SOLVE_ARENA_BLOCK_SIZE * 3);
+    unsigned char *after = solve_arena_alloc(arena, 16);
+
+    TEST_ASSERT_TRUE(is_aligned(big));
+    TEST_ASSERT_TRUE(is_zeroed(big, SOLVE_ARENA_BLOCK_SIZE * 3));
+
+    // The big one has its own block, the small ones keep sharing theirs
+    size_t step = (16 + alignof(max_align_t) - 1) / alignof(max_align_t) * alignof(max_align_t);
+    TEST_ASSERT_TRUE(after == small + step);
+
+    destroy_solve_arena(arena);
+}
+
+typedef struct {
+    solve_arena_t *arena;
+    unsigned char  id;
+    unsigned char *memory[N_THREAD_ALLOCS];
+} fill_job_t;
+
+static void *fill_arena(void *arg) {
+    fill_job_t *job = (fill_job_t *)arg;
+
+    for (int i = 0; i < N_THREAD_ALLOCS; i++) {
+        job->memory[i] = solve_arena_alloc(job->arena, 24);
+        if (!is_zeroed(job->memory[i], 24))
+            return (void *)1;
+
+        for (int j = 0; j < 24; j++)
+            job->memory[i][j] = job->id;
+    }
+
+    return NULL;
+}
+
+void test_arena_is_shared_by_threads() {
+    static fill_job_t jobs[N_THREADS];
+
+    solve_arena_t *arena = make_solve_arena();
+    pthread_t      threads[N_THREADS];
+
+    for (int i = 0; i < N_THREADS; i++) {
+        jobs[i].arena = arena;
+        jobs[i].id    = (unsigned char)(i + 1);
+        pthread_create(&threads[i], NULL, fill_arena, &jobs[i]);
+    }
+
+    for (int i = 0; i < N_THREADS; i++) {
+        void *failed;
+        pthread_join(threads[i], &failed);
+        TEST_ASSERT_NULL(failed);
+    }
+
+    // No thread wrote over the memory of another one
+    for (int i = 0; i < N_THREADS; i++) {
+        for (int k = 0; k < N_THREAD_ALLOCS; k++) {
+            for (int j = 0; j < 24; j++)
+                TEST_ASSERT_EQUAL_INT(jobs[i].id, jobs[i].memory[k][j]);
+        }
+    }
+
+    destroy_solve_arena(arena);
+}
+
+void test_destroy_null_arena() { destroy_solve_arena(NULL); }
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+int main() {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_arena_returns_aligned_zeroed_memory);
+    RUN_TEST(test_arena_allocations_do_not_overlap);
+    RUN_TEST(test_arena_allocates_more_than_a_block);
+    RUN_TEST(test_arena_is_shared_by_threads);
+    RUN_TEST(test_destroy_null_arena);
+
+    return UNITY_END();
+}
@@ -0,0 +1,145 @@
+#include <stdlib.h>
+#include <unity.h>
+
+#include <cubie_cube.h>
+#include <cubie_move_table.h>
+#include <definitions.h>
+#include <symmetry.h>
+#include <utils.h>
+
+static void multiply(cube_cubie_t *cube1, cube_cubie_t *cube2) {
+    multiply_cube_cubie_edges(cube1, cube2);
+    multiply_cube_cubie_corners(cube1, cube2);
+}
+
+void test_symmetry_times_inverse_is_identity() {
+    cube_cubie_t *identity = init_cubie_cube();
+
+    for (int s = 0; s < N_SYMMETRIES; s++) {
+        cube_cubie_t cube, inverse;
+        get_symmetry_cube(&cube, s);
+        get_symmetry_cube(&inverse, get_inverse_symmetry(s));
+
+        multiply(&cube, &inverse);
+
+        TEST_ASSERT_TRUE(are_cubie_equal(&cube, identity));
+    }
+
+    free(identity);
+}
+
+void test_conjugate_moves_of_ud_symmetries_keep_ud_axis() {
+    for (int s = 0; s < N_SYMMETRIES_D4H; s++) {
+        for (int move = 0; move < N_MOVES; move++) {
+            move_t conjugate = get_conjugate_move(move, s);
+            int    is_ud     = (move >= MOVE_U1 && move <= MOVE_U3) || (move >= MOVE_D1 && move <= MOVE_D3);
+            int    is_ud_conjugate =
+                (conjugate >= MOVE_U1 && conjugate <= MOVE_U3) || (conjugate >= MOVE_D1 && conjugate <= MOVE_D3);
+
+            TEST_ASSERT_EQUAL_INT(is_ud, is_ud_conjugate);
+        }
+    }
+}
+
+void test_conjugate_move_of_identity_is_same_move() {
+    for (int move = 0; move < N_MOVES; move++)
+        TEST_ASSERT_EQUAL_INT(move, get_conjugate_move(move, 0));
+}
+
+void test_twist_conj_of_identity_is_same_twist() {
+    const uint16_t *twist_conj = get_twist_conj_table();
+
+    for (int twist = 0; twist < N_CORNER_ORIENTATIONS; twist++)
+        TEST_ASSERT_EQUAL_INT(twist, twist_conj[twist * N_SYMMETRIES_D4H]);
+}
+
+void test_flipslice_classes_cover_all_flipslices() {
+    const uint16_t *classidx = get_flipslice_classidx_table();
+    const uint8_t  *sym      = get_flipslice_sym_table();
+    const uint32_t *rep      = get_flipslice_rep_table();
+
+    for (int flipslice = 0; flipslice < N_FLIPSLICE; flipslice++) {
+        TEST_ASSERT_TRUE(classidx[flipslice] < N_FLIPSLICE_CLASSES);
+        TEST_ASSERT_TRUE(sym[flipslice] < N_SYMMETRIES_D4H);
+    }
+
+    for (int c = 0; c < N_FLIPSLICE_CLASSES; c++) {
+        TEST_ASSERT_EQUAL_INT(c, classidx[rep[c]]);
+        TEST_ASSERT_EQUAL_INT(0, sym[rep[c]]);
+    }
+}
+
+void test_flipslice_sym_maps_cube_to_representant() {
+    const uint16_t *classidx = get_flipslice_classidx_table();
+    const uint8_t  *sym      = get_flipslice_sym_table();
+    const uint32_t *rep      = get_flipslice_rep_table();
+
+    cube_cubie_t *cube = init_cubie_cube();
+
+    for (int flipslice = 0; flipslice < N_FLIPSLICE; flipslice += 97) {
+        set_E_slice(cube, flipslice / N_EDGE_ORIENTATIONS);
+        set_edge_orientations(cube, flipslice % N_EDGE_ORIENTATIONS);
+
+        // R = S * C * S^-1
+        cube_cubie_t representant, inverse;
+        get_symmetry_cube(&representant, sym[flipslice]);
+        get_symmetry_cube(&inverse, get_inverse_symmetry(sym[flipslice]));
+        multiply_cube_cubie_edges(&representant, cube);
+        multiply_cube_cubie_edges(&representant, &inverse);
+
+        int representant_flipslice =
+            get_E_slice(&representant) * N_EDGE_ORIENTATIONS + get_edge_orientations(&representant);
+
+        TEST_ASSERT_EQUAL_INT(rep[classidx[flipslice]], representant_flipslice);
+    }
+
+    free(cube);
+}
+
+void test_conjugate_cube_matches_conjugate_moves() {
+    for (int s = 0; s < N_SYMMETRIES_D4H * 3; s += N_SYMMETRIES_D4H) {
+        cube_cubie_t symmetry, inverse;
+        get_symmetry_cube(&symmetry, s);
+        get_symmetry_cube(&inverse, get_inverse_symmetry(s));
+
+        cube_cubie_t *cube      = init_cubie_cube();
+        cube_cubie_t *conjugate = init_cubie_cube();
+        move_t        moves[]   = {MOVE_R1, MOVE_U2, MOVE_F3, MOVE_B1, MOVE_L2, MOVE_D3};
+
+        for (size_t i = 0; i < sizeof(moves) / sizeof(moves[0]); i++) {
+            cubie_apply_move(cube, moves[i]);
+            cubie_apply_move(conjugate, get_conjugate_move(moves[i], s));
+        }
+
+        conjugate_cubie_cube(cube, &symmetry, &inverse);
+        TEST_ASSERT_TRUE(are_cubie_equal(cube, conjugate));
+
+        // Conjugating back by the inverse symmetry gives the original cube
+        conjugate_cubie_cube(cube, &inverse, &symmetry);
+        for (int i = (int)(sizeof(moves) / sizeof(moves[0])) - 1; i >= 0; i--)
+            cubie_apply_move(cube, get_reverse_move(moves[i]));
+
+        TEST_ASSERT_TRUE(is_cubie_solved(cube));
+
+        free(cube);
+        free(conjugate);
+    }
+}
+
+void setUp(void) { build_symmetry_tables(); }
+
+void tearDown(void) {}
+
+int main() {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_symmetry_times_inverse_is_identity);
+    RUN_TEST(test_conjugate_moves_of_ud_symmetries_keep_ud_axis);
+    RUN_TEST(test_conjugate_move_of_identity_is_same_move);
+    RUN_TEST(test_twist_conj_of_identity_is_same_twist);
+    RUN_TEST(test_flipslice_classes_cover_all_flipslices);
+    RUN_TEST(test_flipslice_sym_maps_cube_to_representant);
+    RUN_TEST(test_conjugate_cube_matches_conjugate_moves);
+
+    return UNITY_END();
+}
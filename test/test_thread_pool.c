@@ -0,0 +1,80 @@
+#include <stdatomic.h>
+#include <unity.h>
+
+#include <thread_pool.h>
+
+#define N_TASKS 32
+
+static atomic_int n_calls;
+
+static void increment_task(void *arg) {
+    int *value = (int *)arg;
+
+    (*value)++;
+    atomic_fetch_add(&n_calls, 1);
+}
+
+static void run_batch(thread_pool_t *pool, int *values, int n_tasks) {
+    void *args[N_TASKS];
+
+    for (int i = 0; i < n_tasks; i++)
+        args[i] = &values[i];
+
+    thread_pool_run(pool, increment_task, args, n_tasks);
+}
+
+void test_thread_pool_runs_every_task_once() {
+    thread_pool_t *pool            = thread_pool_create(4);
+    int            values[N_TASKS] = {0};
+
+    run_batch(pool, values, N_TASKS);
+
+    for (int i = 0; i < N_TASKS; i++)
+        TEST_ASSERT_EQUAL_INT(1, values[i]);
+
+    TEST_ASSERT_EQUAL_INT(N_TASKS, atomic_load(&n_calls));
+
+    thread_pool_destroy(pool);
+}
+
+void test_thread_pool_is_reused_across_batches() {
+    thread_pool_t *pool            = thread_pool_create(3);
+    int            values[N_TASKS] = {0};
+
+    for (int batch = 0; batch < 1000; batch++)
+        run_batch(pool, values, 1 + batch % N_TASKS);
+
+    int total = 0;
+    for (int i = 0; i < N_TASKS; i++)
+        total += values[i];
+
+    TEST_ASSERT_EQUAL_INT(atomic_load(&n_calls), total);
+    TEST_ASSERT_EQUAL_INT(1000, values[0]);
+    TEST_ASSERT_EQUAL_INT(3, thread_pool_size(pool));
+
+    thread_pool_destroy(pool);
+}
+
+void test_thread_pool_with_empty_batch() {
+    thread_pool_t *pool = thread_pool_create(2);
+
+    thread_pool_run(pool, increment_task, NULL, 0);
+
+    TEST_ASSERT_EQUAL_INT(0, atomic_load(&n_calls));
+
+    thread_pool_destroy(pool);
+}
+
+void setUp(void) { atomic_store(&n_calls, 0); }
+
+void tearDown(void) {}
+
+int main() {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_thread_pool_runs_every_task_once);
+    RUN_TEST(test_thread_pool_is_reused_across_batches);
+    RUN_TEST(test_thread_pool_with_empty_batch);
+
+    return UNITY_END();
+}